@@ -35,6 +35,9 @@ FtsDialog::FtsDialog(QWidget *parent)
     caseCheckBox = new QCheckBox{tr("&ignore case")};
     caseCheckBox->setChecked(true);
 
+    regexpCheckBox = new QCheckBox{tr("&regular expression")};
+    regexpCheckBox->setChecked(false);
+
     findButton = new QPushButton{tr("&Search")};
     findButton->setDefault(true);
     findButton->setEnabled(false);
@@ -51,6 +54,7 @@ FtsDialog::FtsDialog(QWidget *parent)
     mainLayout->addWidget(label);
     mainLayout->addWidget(lineEdit);
     mainLayout->addWidget(caseCheckBox);
+    mainLayout->addWidget(regexpCheckBox);
 
     QHBoxLayout *buttonLayout = new QHBoxLayout{};
     buttonLayout->addStretch(1);
@@ -86,6 +90,7 @@ FtsDialog::~FtsDialog()
     delete lineEdit;
     delete completer;
     delete caseCheckBox;
+    delete regexpCheckBox;
     delete findButton;
     delete closeButton;
 }
@@ -32,6 +32,7 @@ class FtsDialog : public QDialog
 private:
     QLineEdit* lineEdit;
     QCheckBox* caseCheckBox;
+    QCheckBox* regexpCheckBox;
     QPushButton* findButton;
     QPushButton* closeButton;
 
@@ -57,6 +58,7 @@ public:
 
     QString getSearchedString() const { return lineEdit->text(); }
     QCheckBox* getCaseCheckbox() const { return caseCheckBox; }
+    QCheckBox* getRegexpCheckbox() const { return regexpCheckBox; }
     QPushButton* getFindButton() const { return findButton; }
 
     void show() { lineEdit->selectAll(); lineEdit->setFocus(); QDialog::show(); }
@@ -76,11 +76,13 @@ void AsyncTaskNotificationsDistributor::run()
         //MF_DEBUG("AsyncDistributor: wake up...");
 
         /*
-         * AA FTS algorithm - SYNCHRONOUS
+         * AA FTS and MinHash algorithms - SYNCHRONOUS
          */
 
         // IMPROVE WFTS algorithm is performed SYNCHRONOUSLY - reliable ASYNC protocol was NOT designed yet
-        if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS) {
+        if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS
+             || Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::MIN_HASH)
+        {
             if(Configuration::getInstance().getMindState()==Configuration::MindState::THINKING) {
                 if(mwp->getOrloj()->isFacetActive(OrlojPresenterFacets::FACET_EDIT_NOTE)) {
                     // think as you WRITE: detect inactivity AND refresh leadearboard for active word
@@ -141,36 +143,20 @@ void AsyncTaskNotificationsDistributor::run()
             std::lock_guard<mutex> criticalSection{tasksMutex};
 
             MF_DEBUG("AsyncDistributor: AWAKE wip[" << tasks.size() << "]" << endl);
-            vector<Task*> zombies{};
-            for(Task* t:tasks) {
-                // FYI future<> had to be check for f.valid() as get() in other thread destroys it
-                if(t->isReady()) {
-                    MF_DEBUG("AsyncDistributor: future FINISHED w/ " << boolalpha << t->isSuccessful() << endl);
-                    if(t->isSuccessful()) {
-                        switch(t->getType()) {
-                        case TaskType::DREAM_TO_THINK:
-                            emit statusBarShowStatistics();
-                            break;
-                        case TaskType::NOTE_ASSOCIATIONS:
-                            emit leaderboardRefresh(t->getNote());
-                            break;
-                        }
-
-                        zombies.push_back(t);
-                        delete t;
-                        MF_DEBUG("AsyncDistributor: task DELETED" << endl);
+            // every ready task is deleted - cancelled tasks (user navigated away) are ready w/ false
+            deleteReadyTasks(tasks, [this](Task* t, bool successful) {
+                MF_DEBUG("AsyncDistributor: future FINISHED w/ " << boolalpha << successful << endl);
+                if(successful) {
+                    switch(t->getType()) {
+                    case TaskType::DREAM_TO_THINK:
+                        emit statusBarShowStatistics();
+                        break;
+                    case TaskType::NOTE_ASSOCIATIONS:
+                        emit leaderboardRefresh(t->getNote());
+                        break;
                     }
-                } else {
-                    MF_DEBUG("AsyncDistributor: future NOT FINISHED" << endl);
-                }
-            }
-
-            if(zombies.size()) {
-                for(Task* t:zombies) {
-                    MF_DEBUG("AsyncDistributor: erasing ZOMBIE task " << t << endl);
-                    tasks.erase(std::remove(tasks.begin(), tasks.end(), t), tasks.end());
                 }
-            }
+            });
         }
     }
 }
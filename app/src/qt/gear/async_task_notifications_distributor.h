@@ -23,6 +23,7 @@
 #include <future>
 
 #include "../../lib/src/debug.h"
+#include "../../lib/src/gear/task_executor.h"
 #include "../../lib/src/model/note.h"
 
 #include "../main_window_presenter.h"
@@ -22,9 +22,14 @@ using namespace std;
 
 namespace m8r {
 
+constexpr int MainWindowPresenter::REPOSITORY_CHANGE_RETRY_INTERVAL;
+
 MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     : view(view),
-      config(Configuration::getInstance())
+      config(Configuration::getInstance()),
+      repositoryNotifier(nullptr),
+      outlinesForgotten(false),
+      forgottenShownOutlineKey{}
 {
     mind = new Mind{config};
 
@@ -127,11 +132,14 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     QObject::connect(configDialog, SIGNAL(saveConfigSignal()), distributor, SLOT(slotConfigurationUpdated()));
 
     // let Mind to learn active repository & preserve desired state
+    mind->addListener(this);
     mind->learn();
+    watchRepository();
 }
 
 MainWindowPresenter::~MainWindowPresenter()
 {
+    unwatchRepository();
     if(mind) delete mind;
     if(mainMenu) delete mainMenu;
     if(statusBar) delete statusBar;
@@ -183,6 +191,7 @@ void MainWindowPresenter::showInitialView()
     } else {
         // NO Os > nothing to show
         // IMPROVE show homepage once it's implemented
+        unwatchRepository();
         mind->amnesia();
         orloj->showFacetOutlineList(mind->getOutlines());
     }
@@ -497,7 +506,9 @@ void MainWindowPresenter::doActionMindRelearn(QString path)
         // remember new repository
         mdConfigRepresentation->save(config);
         // learn and show
+        unwatchRepository();
         mind->learn();
+        watchRepository();
         showInitialView();
     } else {
         QMessageBox::critical(
@@ -507,6 +518,122 @@ void MainWindowPresenter::doActionMindRelearn(QString path)
     }
 }
 
+void MainWindowPresenter::watchRepository()
+{
+    unwatchRepository();
+    if(mind->watch()) {
+        repositoryNotifier = new QSocketNotifier{
+            mind->remind().getRepositoryIndexer().getWatchFd(),
+            QSocketNotifier::Read,
+            this};
+        QObject::connect(repositoryNotifier, SIGNAL(activated(int)), this, SLOT(handleRepositoryChange()));
+    }
+}
+
+void MainWindowPresenter::unwatchRepository()
+{
+    // notifier must be deleted before its descriptor is closed by (re)learn
+    if(repositoryNotifier) {
+        repositoryNotifier->setEnabled(false);
+        delete repositoryNotifier;
+        repositoryNotifier = nullptr;
+    }
+}
+
+void MainWindowPresenter::handleRepositoryChange()
+{
+    if(!repositoryNotifier) {
+        return;
+    }
+
+    // edited O/N must not be replaced under the editor, changes are learned once editor is closed
+    int learned = -1;
+    if(!orloj->isFacetActive(OrlojPresenterFacets::FACET_EDIT_NOTE)
+         && !orloj->isFacetActive(OrlojPresenterFacets::FACET_EDIT_OUTLINE_HEADER))
+    {
+        outlinesForgotten = false;
+        forgottenShownOutlineKey.clear();
+        learned = mind->learnRepositoryChanges();
+    }
+
+    if(learned < 0) {
+        // pending events keep descriptor readable - pause notifier to avoid busy loop
+        repositoryNotifier->setEnabled(false);
+        QTimer::singleShot(REPOSITORY_CHANGE_RETRY_INTERVAL, this, SLOT(handleRepositoryChangeRetry()));
+    } else if(learned > 0) {
+        refreshViewsOnRepositoryChange();
+        statusBar->showInfo(tr("Learned %1 external repository change(s)").arg(learned));
+    }
+}
+
+void MainWindowPresenter::handleRepositoryChangeRetry()
+{
+    if(repositoryNotifier) {
+        repositoryNotifier->setEnabled(true);
+    }
+}
+
+void MainWindowPresenter::forget(Outline* outline)
+{
+    // forgotten O is deleted once listeners are notified - remember only its key
+    outlinesForgotten = true;
+    if(orloj->getOutlineView()->getCurrentOutline() == outline) {
+        forgottenShownOutlineKey = outline->getKey();
+    }
+}
+
+void MainWindowPresenter::forget(Note* note)
+{
+    UNUSED_ARG(note);
+}
+
+void MainWindowPresenter::remember(Outline* outline)
+{
+    UNUSED_ARG(outline);
+}
+
+void MainWindowPresenter::refreshViewsOnRepositoryChange()
+{
+    if(orloj->isFacetActive(OrlojPresenterFacets::FACET_LIST_OUTLINES)) {
+        orloj->showFacetOutlineList(mind->getOutlines());
+        return;
+    }
+    if(!outlinesForgotten) {
+        // next page of ranked FTS would skip/duplicate results once learned Os shift their order
+        if(orloj->isFacetActive(OrlojPresenterFacets::FACET_FTS_RESULT)
+             || orloj->isFacetActive(OrlojPresenterFacets::FACET_FTS_VIEW_NOTE))
+        {
+            orloj->getNotesTable()->refreshFts(mind);
+        }
+        return;
+    }
+
+    // views of Os/Ns (incl. leaderboards) may reference Ns of forgotten Os
+    if(orloj->isFacetActive(OrlojPresenterFacets::FACET_VIEW_OUTLINE)
+         || orloj->isFacetActive(OrlojPresenterFacets::FACET_VIEW_OUTLINE_HEADER)
+         || orloj->isFacetActive(OrlojPresenterFacets::FACET_VIEW_NOTE))
+    {
+        Outline* outline = forgottenShownOutlineKey.size()
+            ? mind->remind().getOutline(forgottenShownOutlineKey)
+            : orloj->getOutlineView()->getCurrentOutline();
+        if(outline) {
+            orloj->showFacetOutline(outline);
+        } else {
+            doActionViewOutlines();
+        }
+    } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_ORGANIZER)) {
+        doActionViewOrganizer();
+    } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_TAG_CLOUD)) {
+        doActionViewTagCloud();
+    } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_RECENT_NOTES)) {
+        doActionViewRecentNotes();
+    } else {
+        // FTS results (incl. paged FTS cursor), navigator, ... may reference forgotten Os
+        orloj->getNotesTable()->clear();
+        doActionViewOutlines();
+    }
+}
+
 void MainWindowPresenter::doActionExit()
 {
     QApplication::quit();
@@ -528,32 +655,67 @@ void MainWindowPresenter::handleFts()
 {
     QString searchedString = ftsDialog->getSearchedString();
     ftsDialog->hide();
-    executeFts(
-        searchedString.toStdString(),
-        ftsDialog->getCaseCheckbox()->isChecked(),
-        ftsDialog->getScope());
+    if(ftsDialog->getRegexpCheckbox()->isChecked()) {
+        executeFtsRegexp(
+            searchedString.toStdString(),
+            ftsDialog->getCaseCheckbox()->isChecked(),
+            ftsDialog->getScope());
+    } else {
+        executeFts(
+            searchedString.toStdString(),
+            ftsDialog->getCaseCheckbox()->isChecked(),
+            ftsDialog->getScope());
+    }
 }
 
 void MainWindowPresenter::executeFts(const string& searchedString, const bool ignoreCase, Outline* scope) const
 {
-    vector<Note*>* result = mind->findNoteFts(searchedString, ignoreCase, scope);
+    // the first page of ranked results is shown immediately, next pages are loaded on scroll
+    orloj->showFacetFtsResult();
+    size_t found = orloj->getNotesTable()->refresh(mind, searchedString, ignoreCase, scope);
 
-    QString info = QString::number(result->size());
+    QString info = QString::number(found);
     info += QString::fromUtf8(" result(s) found for '");
     info += QString::fromStdString(searchedString);
     info += QString::fromUtf8("'");
     view.getStatusBar()->showInfo(info);
 
-    if(result && result->size()) {
+    if(found) {
         orloj->getNoteView()->setSearchExpression(searchedString);
         orloj->getNoteView()->setSearchIgnoreCase(ignoreCase);
-
-        orloj->showFacetFtsResult(result);
     } else {
         QMessageBox::information(&view, tr("Full-text Search Result"), tr("No matching Notebook or Note found."));
     }
 }
 
+void MainWindowPresenter::executeFtsRegexp(const string& regexp, const bool ignoreCase, Outline* scope) const
+{
+    Regexp r{regexp, ignoreCase};
+    if(!r.isValid()) {
+        QMessageBox::critical(
+            &view,
+            tr("Full-text Search"),
+            tr("Invalid regular expression: ") + QString::fromStdString(r.getError()));
+        return;
+    }
+
+    orloj->showFacetFtsResult();
+    int found = orloj->getNotesTable()->refreshRegexp(mind, regexp, ignoreCase, scope);
+
+    QString info = QString::number(found);
+    info += QString::fromUtf8(" result(s) found for regular expression '");
+    info += QString::fromStdString(regexp);
+    info += QString::fromUtf8("'");
+    view.getStatusBar()->showInfo(info);
+
+    // note view highlights literal search expression only
+    orloj->getNoteView()->setSearchExpression("");
+
+    if(!found) {
+        QMessageBox::information(&view, tr("Full-text Search Result"), tr("No matching Notebook or Note found."));
+    }
+}
+
 void MainWindowPresenter::doActionFindOutlineByName()
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
@@ -20,6 +20,7 @@
 #define M8RUI_MAIN_WINDOW_PRESENTER_H
 
 #include "../../lib/src/mind/mind.h"
+#include "../../lib/src/mind/mind_listener.h"
 #include "../../lib/src/representations/html/html_outline_representation.h"
 #include "../../lib/src/representations/markdown/markdown_configuration_representation.h"
 
@@ -74,11 +75,17 @@ class NerMainWindowWorkerThread;
  * Main window presenter:
  *   * Implements core UI application logic for other presenters and views.
  *   * Provides index of all UI presenters.
+ *   * Learns external changes of repository (git pull, sync tools, other editors)
+ *     and refreshes views which show changed Os.
  */
-class MainWindowPresenter : public QObject
+class MainWindowPresenter : public QObject, public MindListener
 {
     Q_OBJECT
 
+public:
+    // external changes are learned once O/N editor is closed or Mind is not busy
+    static constexpr int REPOSITORY_CHANGE_RETRY_INTERVAL = 1000;
+
 private:
     MainWindowView& view;
 
@@ -86,6 +93,12 @@ private:
     Mind* mind;
 
     AsyncTaskNotificationsDistributor* distributor;
+
+    // watch descriptor of the active repository becomes readable on its change
+    QSocketNotifier* repositoryNotifier;
+    // Os forgotten on repository change - any / the one shown by Orloj
+    bool outlinesForgotten;
+    std::string forgottenShownOutlineKey;
 #ifdef MF_NER
     NerMainWindowWorkerThread* nerWorker;
 #endif
@@ -150,6 +163,16 @@ public:
     // NER
     NerMainWindowWorkerThread* startNerWorkerThread(Mind* m, OrlojPresenter* o, int f, std::vector<NerNamedEntity>* r, QDialog* d);
 
+    // external repository changes
+    virtual void forget(Outline* outline);
+    virtual void forget(Note* note);
+    virtual void remember(Outline* outline);
+
+private:
+    void watchRepository();
+    void unwatchRepository();
+    void refreshViewsOnRepositoryChange();
+
 public slots:
     // mind
 #ifdef DO_MF_DEBUG
@@ -165,6 +188,8 @@ public slots:
     void doActionMindLearnRepository();
     void doActionMindLearnFile();
     void doActionMindRelearn(QString path);
+    void handleRepositoryChange();
+    void handleRepositoryChangeRetry();
     void doActionMindTimeTagScope();
     void handleMindScope();
     void doActionMindPreferences();
@@ -257,6 +282,7 @@ public slots:
     void doActionHelpAboutMindForger();
 
     void executeFts(const std::string& command, const bool ignoreCase=false, Outline* scope=nullptr) const;
+    void executeFtsRegexp(const std::string& regexp, const bool ignoreCase=false, Outline* scope=nullptr) const;
 };
 
 }
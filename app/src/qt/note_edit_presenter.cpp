@@ -104,7 +104,7 @@ void NoteEditPresenter::slotSaveNote()
         currentNote->makeModified();
 
         // remember
-        mwp->getMind()->remind().remember(currentNote->getOutlineKey());
+        mwp->getMind()->noteRemember(currentNote);
         mwp->getStatusBar()->showInfo(tr("Note saved!"));
         MF_DEBUG("Note '" << currentNote->getName() << "' saved!" << endl);
     } else {
@@ -78,12 +78,14 @@ void NoteViewPresenter::refresh(Note* note)
         qHtml += QString::fromStdString(html);
         qHtml += QString::fromStdString("</pre></body></html>");
 
-        // highlight matches
-        QString highlighted = QString::fromStdString("<span style='background-color: red; color: white;'>");
-        // IMPROVE instead of searched expression that MAY differ in CASE, here should be original string found in the haystack
-        highlighted += searchExpression;
-        highlighted += QString::fromStdString("</span>");
-        qHtml.replace(searchExpression, highlighted, searchIgnoreCase?Qt::CaseInsensitive:Qt::CaseSensitive);
+        // highlight matches (regular expression search doesn't set expression)
+        if(!searchExpression.isEmpty()) {
+            QString highlighted = QString::fromStdString("<span style='background-color: red; color: white;'>");
+            // IMPROVE instead of searched expression that MAY differ in CASE, here should be original string found in the haystack
+            highlighted += searchExpression;
+            highlighted += QString::fromStdString("</span>");
+            qHtml.replace(searchExpression, highlighted, searchIgnoreCase?Qt::CaseInsensitive:Qt::CaseSensitive);
+        }
     } else {
         // HTML
         htmlRepresentation->to(note, &html);
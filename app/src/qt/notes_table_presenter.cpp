@@ -27,10 +27,21 @@ NotesTablePresenter::NotesTablePresenter(NotesTableView* view)
     this->view = view;
     this->model = new NotesTableModel();
     this->view->setModel(this->model);
+    this->ftsShown = false;
+    this->ftsMind = nullptr;
+    this->ftsIgnoreCase = false;
+    this->ftsScope = nullptr;
+    this->ftsRemaining = 0;
+
+    QObject::connect(
+        view->verticalScrollBar(), SIGNAL(valueChanged(int)),
+        this, SLOT(slotScrolled(int)));
 }
 
 void NotesTablePresenter::refresh(vector<Note*>* result)
 {
+    ftsShown = false;
+    ftsMind = nullptr;
     model->removeAllRows();
     for(Note* note:*result) {
         model->addRow(note);
@@ -39,4 +50,81 @@ void NotesTablePresenter::refresh(vector<Note*>* result)
     delete result;
 }
 
+size_t NotesTablePresenter::refresh(Mind* mind, const string& s, bool ignoreCase, Outline* scope)
+{
+    clear();
+
+    ftsShown = true;
+    ftsMind = mind;
+    ftsString = s;
+    ftsIgnoreCase = ignoreCase;
+    ftsScope = scope;
+    ftsCursor.reset();
+    ftsRemaining = 0;
+
+    fetchFtsPage();
+    return ftsRemaining;
+}
+
+bool NotesTablePresenter::refreshFts(Mind* mind)
+{
+    if(!ftsShown) {
+        return false;
+    }
+
+    MF_DEBUG("FTS '" << ftsString << "' refreshed" << std::endl);
+    refresh(mind, ftsString, ftsIgnoreCase, ftsScope);
+    return true;
+}
+
+int NotesTablePresenter::refreshRegexp(Mind* mind, const string& regexp, bool ignoreCase, Outline* scope)
+{
+    clear();
+
+    int found = mind->findNoteRegexp(regexp, ignoreCase, scope, this);
+    showFound();
+    return found;
+}
+
+void NotesTablePresenter::fetchFtsPage()
+{
+    MF_DEBUG("FTS page from row " << model->rowCount() << std::endl);
+    ftsRemaining = ftsMind->findNoteFts(ftsString, ftsIgnoreCase, ftsScope, FTS_PAGE_SIZE, ftsCursor, this);
+    showFound();
+    if(ftsRemaining <= FTS_PAGE_SIZE) {
+        ftsMind = nullptr;
+    }
+}
+
+void NotesTablePresenter::slotScrolled(int value)
+{
+    // next page is loaded when the last row gets visible
+    if(ftsMind && value == view->verticalScrollBar()->maximum()) {
+        fetchFtsPage();
+    }
+}
+
+void NotesTablePresenter::clear()
+{
+    ftsShown = false;
+    ftsMind = nullptr;
+    model->removeAllRows();
+    foundNotes.clear();
+}
+
+void NotesTablePresenter::found(Note* note)
+{
+    // events must NOT be processed while Mind iterates memory - repository
+    // change handlers would learn (and delete) Os under the search
+    foundNotes.push_back(note);
+}
+
+void NotesTablePresenter::showFound()
+{
+    for(Note* note:foundNotes) {
+        model->addRow(note);
+    }
+    foundNotes.clear();
+}
+
 } // m8r namespace
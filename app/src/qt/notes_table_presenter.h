@@ -21,19 +21,38 @@
 
 #include <QtWidgets>
 
+#include "../../lib/src/mind/mind.h"
+#include "../../lib/src/mind/search_listener.h"
+
 #include "notes_table_view.h"
 #include "notes_table_model.h"
 
 namespace m8r {
 
-class NotesTablePresenter : public QObject
+class NotesTablePresenter : public QObject, public SearchListener
 {
     Q_OBJECT
 
+public:
+    static constexpr size_t FTS_PAGE_SIZE = 100;
+
 private:
     NotesTableView* view;
     NotesTableModel* model;
 
+    // search results are buffered and shown once Mind finishes the search
+    std::vector<Note*> foundNotes;
+
+    // shown rows are ranked FTS result (query below)
+    bool ftsShown;
+    // paged FTS - nullptr mind if shown rows are not FTS result or all pages are loaded
+    Mind* ftsMind;
+    std::string ftsString;
+    bool ftsIgnoreCase;
+    Outline* ftsScope;
+    FtsCursor ftsCursor;
+    size_t ftsRemaining;
+
 public:
     NotesTablePresenter(NotesTableView* view);
     NotesTablePresenter(const NotesTablePresenter&) = delete;
@@ -45,6 +64,35 @@ public:
     NotesTableView* getView() const { return view; }
 
     void refresh(std::vector<Note*>* notes);
+    /**
+     * @brief Show the first page of ranked FTS results - next pages are loaded on scroll.
+     * @return number of all results.
+     */
+    size_t refresh(Mind* mind, const std::string& s, bool ignoreCase, Outline* scope);
+    /**
+     * @brief Run shown ranked FTS again from the first page.
+     *
+     * Pages are ordered by Os order in memory i.e. cursor of the next page is
+     * not valid once Os are learned/forgotten.
+     *
+     * @return false if shown rows are not ranked FTS result.
+     */
+    bool refreshFts(Mind* mind);
+    /**
+     * @brief Show notes matching regular expression.
+     * @return number of found notes or -1 if regular expression is not valid.
+     */
+    int refreshRegexp(Mind* mind, const std::string& regexp, bool ignoreCase, Outline* scope);
+
+    void clear();
+    virtual void found(Note* note) override;
+
+private:
+    void fetchFtsPage();
+    void showFound();
+
+private slots:
+    void slotScrolled(int value);
 };
 
 }
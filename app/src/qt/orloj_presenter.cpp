@@ -179,6 +179,14 @@ void OrlojPresenter::showFacetFtsResult(vector<Note*>* result)
     view->showFacetFtsResult();
 }
 
+void OrlojPresenter::showFacetFtsResult()
+{
+    setFacet(OrlojPresenterFacets::FACET_FTS_RESULT);
+    notesTablePresenter->clear();
+    mainPresenter->getMainMenu()->showFacetOutlineList();
+    view->showFacetFtsResult();
+}
+
 void OrlojPresenter::showFacetOutline(Outline* outline)
 {
     if(activeFacet == OrlojPresenterFacets::FACET_NAVIGATOR) {
@@ -145,6 +145,10 @@ public:
     void showFacetRecentNotes(const std::vector<Note*>& notes);
     void showFacetKnowledgeGraphNavigator();
     void showFacetFtsResult(std::vector<Note*>* result);
+    /**
+     * @brief Show empty FTS result facet - results are streamed to notes table.
+     */
+    void showFacetFtsResult();
     void showFacetOutline(Outline* outline);
     void showFacetNoteView();
     void showFacetNoteView(Note* note);
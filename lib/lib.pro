@@ -50,6 +50,9 @@ SOURCES += \
     ./src/gear/datetime_utils.cpp \
     ./src/gear/file_utils.cpp \
     ./src/gear/string_utils.cpp \
+    ./src/gear/regexp.cpp \
+    ./src/gear/task_executor.cpp \
+    ./src/gear/perfect_hash.cpp \
     ./src/mind/ontology/ontology.cpp \
     ./src/model/note_type.cpp \
     ./src/model/note.cpp \
@@ -58,6 +61,7 @@ SOURCES += \
     ./src/model/stencil.cpp \
     ./src/model/tag.cpp \
     ./src/persistence/filesystem_persistence.cpp \
+    ./src/persistence/memory_snapshot.cpp \
     ./src/representations/html/html_outline_representation.cpp \
     ./src/representations/markdown/markdown_ast_node.cpp \
     ./src/representations/markdown/markdown_lexem.cpp \
@@ -71,6 +75,7 @@ SOURCES += \
     ./src/mind/galaxy.cpp \
     ./src/mind/memory_dwell.cpp \
     ./src/mind/memory.cpp \
+    ./src/mind/fts_index.cpp \
     ./src/mind/mind.cpp \
     ./src/mind/planner.cpp \
     ./src/mind/working_memory.cpp \
@@ -87,6 +92,7 @@ SOURCES += \
     src/representations/html/html_document.cpp \
     src/mind/ai/ai.cpp \
     src/mind/ai/nlp/markdown_tokenizer.cpp \
+    src/mind/ai/nlp/language_detector.cpp \
     src/mind/ai/nlp/bag_of_words.cpp \
     src/mind/ai/aa_model.cpp \
     src/mind/ai/nlp/lexicon.cpp \
@@ -97,7 +103,9 @@ SOURCES += \
     src/mind/ai/nlp/word_frequency_list.cpp \
     src/gear/trie.cpp \
     src/mind/ai/nlp/stemmer/stemmer.cpp \
+    src/mind/ai/nlp/stemmer/stem_cache.cpp \
     src/mind/ai/ai_aa_bow.cpp \
+    src/mind/ai/ai_aa_min_hash.cpp \
     src/mind/ai/ai_aa_weighted_fts.cpp \
     src/mind/ai/aa_notes_feature.cpp \
     src/mind/ai/nlp/common_words_blacklist.cpp \
@@ -125,8 +133,12 @@ HEADERS += \
     ./src/gear/datetime_utils.h \
     ./src/gear/file_utils.h \
     ./src/gear/hash_map.h \
+    ./src/gear/object_pool.h \
     ./src/gear/lang_utils.h \
     ./src/gear/string_utils.h \
+    ./src/gear/perfect_hash.h \
+    ./src/gear/regexp.h \
+    ./src/gear/task_executor.h \
     ./src/mind/ontology/ontology_vocabulary.h \
     ./src/mind/ontology/ontology.h \
     ./src/model/note_type.h \
@@ -137,8 +149,11 @@ HEADERS += \
     ./src/model/stencil.h \
     ./src/model/tag.h \
     ./src/persistence/filesystem_persistence.h \
+    ./src/persistence/memory_snapshot.h \
+    ./src/persistence/snapshot_io.h \
     ./src/persistence/persistence.h \
     ./src/representations/html/html_outline_representation.h \
+    ./src/representations/markdown/markdown_arena.h \
     ./src/representations/markdown/markdown_ast_node.h \
     ./src/representations/markdown/markdown_lexem.h \
     ./src/representations/markdown/markdown_lexer_sections.h \
@@ -152,10 +167,13 @@ HEADERS += \
     ./src/mind/galaxy.h \
     ./src/mind/memory_dwell.h \
     ./src/mind/memory.h \
+    ./src/mind/fts_index.h \
     ./src/mind/mind.h \
     ./src/mind/planner.h \
     ./src/mind/working_memory.h \
     ./src/mind/mind_listener.h \
+    ./src/mind/fts_cursor.h \
+    ./src/mind/search_listener.h \
     ./src/config/color.h \
     ./src/config/configuration.h \
     ./src/install/installer.h \
@@ -173,6 +191,7 @@ HEADERS += \
     src/version.h \
     src/mind/ai/ai.h \
     src/mind/ai/nlp/markdown_tokenizer.h \
+    src/mind/ai/nlp/language_detector.h \
     src/mind/ai/nlp/bag_of_words.h \
     src/mind/ai/nlp/lexicon.h \
     src/mind/ai/nlp/note_char_provider.h \
@@ -182,7 +201,9 @@ HEADERS += \
     src/mind/ai/nlp/word_frequency_list.h \
     src/gear/trie.h \
     src/mind/ai/nlp/char_provider.h \
+    src/mind/ai/nlp/chunk_provider.h \
     src/mind/ai/nlp/stemmer/stemmer.h \
+    src/mind/ai/nlp/stemmer/stem_cache.h \
     src/mind/ai/nlp/stemmer/stemming/danish_stem.h \
     src/mind/ai/nlp/stemmer/stemming/dutch_stem.h \
     src/mind/ai/nlp/stemmer/stemming/english_stem.h \
@@ -202,6 +223,7 @@ HEADERS += \
     src/mind/ai/nlp/stemmer/utilities/safe_math.h \
     src/mind/ai/nlp/stemmer/utilities/utilities.h \
     src/mind/ai/ai_aa_bow.h \
+    src/mind/ai/ai_aa_min_hash.h \
     src/mind/ai/ai_aa_weighted_fts.h \
     src/mind/ai/aa_model.h \
     src/mind/ai/aa_notes_feature.h \
@@ -19,6 +19,8 @@
 
 #include "configuration.h"
 
+#include "../persistence/snapshot_io.h"
+
 namespace m8r {
 
 using namespace std;
@@ -85,15 +87,7 @@ void Configuration::clear()
             //| Configuration::MdToHtmlOption::DiagramSupport; // diagram support via mermaid.js - disabled by default
             ;
 
-    aaAlgorithm = AssociationAssessmentAlgorithm::WEIGHTED_FTS;
-    switch(aaAlgorithm) {
-    case AssociationAssessmentAlgorithm::WEIGHTED_FTS:
-        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS;
-        break;
-    case AssociationAssessmentAlgorithm::BOW:
-        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_BOW;
-        break;
-    }
+    setAaAlgorithm(AssociationAssessmentAlgorithm::WEIGHTED_FTS);
 
     distributorSleepInterval = DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL;
 
@@ -141,6 +135,20 @@ Repository* Configuration::getActiveRepository() const
     }
 }
 
+string Configuration::getRepositoryCachePath(const char* extension) const
+{
+    string path{configFilePath};
+    if(activeRepository) {
+        const string& repositoryPath = activeRepository->getPath();
+        char key[17];
+        snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(snapshotHash(repositoryPath.data(), repositoryPath.size())));
+        path += '.';
+        path += key;
+    }
+    path += extension;
+    return path;
+}
+
 std::map<const std::string,Repository*>& Configuration::getRepositories()
 {
     return repositories;
@@ -173,6 +181,22 @@ void Configuration::setActiveRepository(Repository* repository)
     }
 }
 
+void Configuration::setAaAlgorithm(AssociationAssessmentAlgorithm aaa)
+{
+    aaAlgorithm = aaa;
+    switch(aaAlgorithm) {
+    case AssociationAssessmentAlgorithm::WEIGHTED_FTS:
+        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS;
+        break;
+    case AssociationAssessmentAlgorithm::BOW:
+        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_BOW;
+        break;
+    case AssociationAssessmentAlgorithm::MIN_HASH:
+        asyncMindThreshold = DEFAULT_ASYNC_MIND_THRESHOLD_MIN_HASH;
+        break;
+    }
+}
+
 bool Configuration::createEmptyMarkdownFile(const string& file)
 {
     if(file.size() && file.find(FILE_PATH_SEPARATOR)==string::npos && RepositoryIndexer::fileHasMarkdownExtension(file)) {
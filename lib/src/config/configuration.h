@@ -58,6 +58,8 @@ constexpr const auto FILE_EXTENSION_MD_MD = ".md";
 constexpr const auto FILE_EXTENSION_MD_MARKDOWN = ".markdown";
 constexpr const auto FILE_EXTENSION_MD_MDOWN = ".mdown";
 constexpr const auto FILE_EXTENSION_MD_MKDN = ".mkdn";
+constexpr const auto FILE_EXTENSION_SNAPSHOT = ".snapshot";
+constexpr const auto FILE_EXTENSION_AI_MODEL = ".ai";
 
 constexpr const auto UI_THEME_DARK = "dark";
 constexpr const auto UI_THEME_LIGHT = "light";
@@ -116,7 +118,8 @@ public:
 
     enum AssociationAssessmentAlgorithm {
         BOW,
-        WEIGHTED_FTS
+        WEIGHTED_FTS,
+        MIN_HASH
     };
 
     enum JavaScriptLibSupport {
@@ -157,6 +160,7 @@ public:
 
     static constexpr int DEFAULT_ASYNC_MIND_THRESHOLD_BOW = 200;
     static constexpr int DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS = 10000;
+    static constexpr int DEFAULT_ASYNC_MIND_THRESHOLD_MIN_HASH = 1000000;
     static constexpr int DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL = 3000;
 
     static const std::string DEFAULT_ACTIVE_REPOSITORY_PATH;
@@ -238,6 +242,15 @@ private:
 private:
     Installer* installer;
 
+    /**
+     * @brief Path of active repository cache (memory snapshot, AI model) w/ given extension.
+     *
+     * Caches are stored next to configuration file (repository may be read-only or
+     * a plain Markdown directory) and keyed by repository path so that repositories
+     * opened w/ the same configuration don't overwrite caches of each other.
+     */
+    std::string getRepositoryCachePath(const char* extension) const;
+
 public:
     Configuration(const Configuration&) = delete;
     Configuration(const Configuration&&) = delete;
@@ -258,6 +271,8 @@ public:
     void setConfigFilePath(const std::string customConfigFilePath) { configFilePath = customConfigFilePath; }
     const std::string& getMemoryPath() const { return memoryPath; }
     const std::string& getLimboPath() const { return limboPath; }
+    std::string getMemorySnapshotPath() const { return getRepositoryCachePath(FILE_EXTENSION_SNAPSHOT); }
+    std::string getAiModelPath() const { return getRepositoryCachePath(FILE_EXTENSION_AI_MODEL); }
     const char* getRepositoryPathFromEnv();
     /**
      * @brief Create empty Markdown file.
@@ -301,7 +316,10 @@ public:
     void setSaveReadsMetadata(bool saveReadsMetadata) { this->saveReadsMetadata=saveReadsMetadata; }
     unsigned int getMd2HtmlOptions() const { return md2HtmlOptions; }
     AssociationAssessmentAlgorithm getAaAlgorithm() const { return aaAlgorithm; }
-    void setAaAlgorithm(AssociationAssessmentAlgorithm aaa) { aaAlgorithm = aaa; }
+    /**
+     * @brief Set AA algorithm and the threshold of Ns it can think about.
+     */
+    void setAaAlgorithm(AssociationAssessmentAlgorithm aaa);
     int getDistributorSleepInterval() const { return distributorSleepInterval; }
     void setDistributorSleepInterval(int sleepInterval) { distributorSleepInterval = sleepInterval; }
     bool isMarkdownQuoteSections() const { return markdownQuoteSections; }
@@ -85,8 +85,16 @@ std::string datetimeToPrettyHtml(const time_t* ts)
     time_t now;
     time(&now);
 
-    tm tsS = *localtime(ts);
-    tm* nowS = localtime(&now);
+    // reentrant conversion - outlines are loaded by multiple threads
+    tm tsS, nowTm;
+#ifdef _WIN32
+    localtime_s(&tsS, ts);
+    localtime_s(&nowTm, &now);
+#else
+    localtime_r(ts, &tsS);
+    localtime_r(&now, &nowTm);
+#endif
+    tm* nowS = &nowTm;
 
     Pretty pretty = Pretty::LONG_TIME_AGO;
 
@@ -72,6 +72,52 @@ bool fileToLines(const string* filename, vector<string*>& lines, unsigned long i
     return fileSize>0;
 }
 
+MemoryMappedFile::MemoryMappedFile(const string* filename)
+    : data(nullptr), size(0)
+{
+#ifdef _WIN32
+    buffer = nullptr;
+    if(filename) {
+        buffer = fileToString(*filename);
+        if(buffer->size()) {
+            data = buffer->data();
+            size = buffer->size();
+        }
+    }
+#else
+    if(filename) {
+        int fd = open(filename->c_str(), O_RDONLY);
+        if(fd != -1) {
+            struct stat fileStat;
+            if(fstat(fd, &fileStat) != -1 && fileStat.st_size > 0) {
+                void* m = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(m != MAP_FAILED) {
+                    // lexers read the file front to back
+                    madvise(m, fileStat.st_size, MADV_SEQUENTIAL);
+                    data = static_cast<const char*>(m);
+                    size = fileStat.st_size;
+                }
+            }
+            // mapping stays valid after the descriptor is closed
+            close(fd);
+        }
+    }
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+#ifdef _WIN32
+    if(buffer) {
+        delete buffer;
+    }
+#else
+    if(data) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
 string* fileToString(const string& filename)
 {
     ifstream is(filename);
@@ -37,6 +37,11 @@
   #include <mach-o/dyld.h>
 #endif
 
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+#endif
+
 #include <ctime>
 #include <cstdio>
 #include <cstring>
@@ -85,6 +90,38 @@ struct File
     const std::string& getName() const noexcept { return name; }
 };
 
+/**
+ * @brief Read-only file content mapped to memory.
+ *
+ * File content is accessed in place w/o copying it to heap - mapping is
+ * released when the instance is destroyed. Platforms w/o mmap() get a heap
+ * copy of the file so that callers don't have to care.
+ */
+class MemoryMappedFile
+{
+private:
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    std::string* buffer;
+#endif
+
+public:
+    explicit MemoryMappedFile(const std::string* filename);
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(const MemoryMappedFile&&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&&) = delete;
+    ~MemoryMappedFile();
+
+    /**
+     * @brief Returns nullptr if file doesn't exist, cannot be read or is empty.
+     */
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+    bool isMapped() const { return data!=nullptr; }
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,102 @@
+/*
+ object_pool.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_OBJECT_POOL_H_
+#define M8R_OBJECT_POOL_H_
+
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Pool of objects allocated in chunks and released at once.
+ *
+ * Objects are constructed in place in chunks of growing size (small documents
+ * don't pay for big chunks), individual objects are never deleted - all of them
+ * are destroyed when the pool is cleared or destroyed.
+ */
+template<class T>
+class ObjectPool
+{
+private:
+    static constexpr size_t FIRST_CHUNK_SIZE = 64;
+    static constexpr size_t MAX_CHUNK_SIZE = 4096;
+
+    struct Chunk {
+        T* objects;
+        size_t capacity;
+    };
+
+    std::vector<Chunk> chunks;
+    /**
+     * @brief Number of objects constructed in the last chunk.
+     */
+    size_t used;
+    size_t count;
+
+public:
+    ObjectPool() : used(0), count(0) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool(const ObjectPool&&) = delete;
+    ObjectPool &operator=(const ObjectPool&) = delete;
+    ObjectPool &operator=(const ObjectPool&&) = delete;
+    ~ObjectPool() { clear(); }
+
+    template<class... Args>
+    T* make(Args&&... args) {
+        if(chunks.empty() || used==chunks.back().capacity) {
+            size_t capacity = FIRST_CHUNK_SIZE;
+            if(!chunks.empty()) {
+                capacity = chunks.back().capacity*2;
+                if(capacity > MAX_CHUNK_SIZE) {
+                    capacity = MAX_CHUNK_SIZE;
+                }
+            }
+            chunks.push_back(Chunk{static_cast<T*>(::operator new(capacity*sizeof(T))), capacity});
+            used = 0;
+        }
+        T* result = new(chunks.back().objects+used) T(std::forward<Args>(args)...);
+        used++;
+        count++;
+        return result;
+    }
+
+    void clear() {
+        for(size_t c=0; c<chunks.size(); c++) {
+            size_t constructed = c+1==chunks.size()?used:chunks[c].capacity;
+            for(size_t i=0; i<constructed; i++) {
+                chunks[c].objects[i].~T();
+            }
+            ::operator delete(chunks[c].objects);
+        }
+        chunks.clear();
+        used = count = 0;
+    }
+
+    size_t size() const { return count; }
+    /**
+     * @brief Number of heap allocations done by the pool since it was cleared.
+     */
+    size_t getChunkCount() const { return chunks.size(); }
+};
+
+} // m8r namespace
+
+#endif /* M8R_OBJECT_POOL_H_ */
@@ -0,0 +1,98 @@
+/*
+ perfect_hash.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "perfect_hash.h"
+
+#include <algorithm>
+
+namespace m8r {
+
+namespace perfecthash {
+
+using namespace std;
+
+bool build(const vector<string>& words, vector<uint32_t>& seeds, vector<string>& slots)
+{
+    const size_t size = words.size();
+    seeds.assign(size, 0);
+    slots.assign(size, string{});
+    if(!size) {
+        return false;
+    }
+
+    vector<uint64_t> hashes{};
+    vector<vector<size_t>> buckets(size);
+    for(size_t i=0; i<size; i++) {
+        if(words[i].size() > UINT8_MAX) {
+            return false;
+        }
+        hashes.push_back(hashRuntime(words[i].data(), words[i].size()));
+        buckets[bucketOf(hashes[i], size)].push_back(i);
+    }
+    // the biggest buckets first, buckets w/ the same size by index
+    vector<size_t> order{};
+    for(size_t b=0; b<size; b++) {
+        order.push_back(b);
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t b1, size_t b2) {
+        return buckets[b1].size() > buckets[b2].size();
+    });
+
+    vector<bool> occupied(size, false);
+    vector<uint32_t> bucketSlots{};
+    for(size_t b:order) {
+        if(buckets[b].empty()) {
+            break;
+        }
+        if(buckets[b].size() == 1) {
+            const uint32_t slot = std::find(occupied.begin(), occupied.end(), false) - occupied.begin();
+            seeds[b] = SINGLETON|slot;
+            occupied[slot] = true;
+            slots[slot] = words[buckets[b][0]];
+            continue;
+        }
+
+        uint32_t seed;
+        for(seed=1; seed<MAX_SEED; seed++) {
+            bucketSlots.clear();
+            for(size_t i:buckets[b]) {
+                const uint32_t slot = slotOf(hashes[i], seed, size);
+                if(occupied[slot] || std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end()) {
+                    break;
+                }
+                bucketSlots.push_back(slot);
+            }
+            if(bucketSlots.size() == buckets[b].size()) {
+                break;
+            }
+        }
+        if(seed == MAX_SEED) {
+            return false;
+        }
+        seeds[b] = seed;
+        for(size_t j=0; j<bucketSlots.size(); j++) {
+            occupied[bucketSlots[j]] = true;
+            slots[bucketSlots[j]] = words[buckets[b][j]];
+        }
+    }
+    return true;
+}
+
+} // perfecthash namespace
+
+} // m8r namespace
@@ -0,0 +1,173 @@
+/*
+ perfect_hash.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_PERFECT_HASH_H_
+#define M8R_PERFECT_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace m8r {
+
+/*
+ * Minimal perfect hash of a fixed set of words.
+ *
+ * Construction is hash and displace: words are distributed to buckets by
+ * the upper half of 64b FNV-1a hash and buckets are placed to the table
+ * (w/ size of the set) from the biggest one. For bucket w/ more words
+ * the first seed which places all its words to free slots is searched,
+ * bucket w/ single word gets the first free slot directly. Lookup hashes
+ * word once, gets bucket's seed and slot, and compares length and chars
+ * of the only candidate word.
+ *
+ * Seed search is too expensive for compile time - table of a fixed set
+ * is generated by perfecthash::build() and checked in as constexpr arrays
+ * of seeds, words and word lengths in slot order. Compiler only verifies
+ * the checked-in table by perfecthash::isValid() in a static_assert.
+ */
+
+namespace perfecthash {
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+// seed of bucket w/ single word is the slot of the word
+constexpr uint32_t SINGLETON = 0x80000000u;
+constexpr uint32_t MAX_SEED = 1u<<16;
+
+constexpr size_t length(const char* s, size_t i=0) {
+    return s[i] ? length(s, i+1) : i;
+}
+
+constexpr uint64_t hash(const char* s, size_t size, size_t i=0, uint64_t h=FNV_OFFSET) {
+    return i==size ? h : hash(s, size, i+1, (h^static_cast<unsigned char>(s[i]))*FNV_PRIME);
+}
+
+/**
+ * @brief Runtime variant of hash() - the same value w/o recursion.
+ */
+inline uint64_t hashRuntime(const char* s, size_t size) {
+    uint64_t h = FNV_OFFSET;
+    for(size_t i=0; i<size; i++) {
+        h = (h^static_cast<unsigned char>(s[i]))*FNV_PRIME;
+    }
+    return h;
+}
+
+// murmur3 finalizer
+constexpr uint32_t shiftXor(uint32_t x, unsigned shift) { return x^(x>>shift); }
+constexpr uint32_t mix(uint32_t x) {
+    return shiftXor(shiftXor(shiftXor(x, 16)*0x85ebca6bu, 13)*0xc2b2ae35u, 16);
+}
+
+constexpr uint32_t bucketOf(uint64_t h, size_t buckets) {
+    return static_cast<uint32_t>((h>>32) % buckets);
+}
+
+constexpr uint32_t slotOf(uint64_t h, uint32_t seed, size_t size) {
+    return seed&SINGLETON ? seed&~SINGLETON : mix(static_cast<uint32_t>(h)^(seed*0x9e3779b9u)) % size;
+}
+
+/*
+ * Verification of checked-in table - word is hashed once, recursions split
+ * slots in halves so that constexpr evaluation depth stays logarithmic.
+ */
+
+constexpr bool isInSlot(uint64_t h, size_t slot, const uint32_t* seeds, size_t size) {
+    return slotOf(h, seeds[bucketOf(h, size)], size)==slot;
+}
+constexpr bool isInSlot(const char* const* words, const uint8_t* lengths, const uint32_t* seeds, size_t size, size_t slot) {
+    return length(words[slot])==lengths[slot] && isInSlot(hash(words[slot], lengths[slot]), slot, seeds, size);
+}
+constexpr bool isValid(const char* const* words, const uint8_t* lengths, const uint32_t* seeds, size_t size, size_t lo, size_t hi) {
+    return hi-lo==1
+        ? isInSlot(words, lengths, seeds, size, lo)
+        : isValid(words, lengths, seeds, size, lo, (lo+hi)/2) && isValid(words, lengths, seeds, size, (lo+hi)/2, hi);
+}
+
+/**
+ * @brief Is every word of table in its slot w/ the right length?
+ */
+constexpr bool isValid(const char* const* words, const uint8_t* lengths, const uint32_t* seeds, size_t size) {
+    return size>0 && isValid(words, lengths, seeds, size, 0, size);
+}
+
+constexpr uint8_t greaterOf(uint8_t a, uint8_t b) {
+    return a>b ? a : b;
+}
+constexpr uint8_t maxLength(const uint8_t* lengths, size_t lo, size_t hi) {
+    return hi-lo==1 ? lengths[lo] : greaterOf(maxLength(lengths, lo, (lo+hi)/2), maxLength(lengths, (lo+hi)/2, hi));
+}
+
+/**
+ * @brief Build table of unique words (up to 255 chars) - seeds of buckets and words in slot order.
+ *
+ * Table is the same for any order of words.
+ *
+ * @return false if seed of a bucket was not found (or words are not unique).
+ */
+bool build(const std::vector<std::string>& words, std::vector<uint32_t>& seeds, std::vector<std::string>& slots);
+
+} // perfecthash namespace
+
+/**
+ * @brief Set of words w/ minimal perfect hash.
+ *
+ * Set doesn't own the table i.e. words and their lengths in slot order
+ * and seeds of buckets (see perfecthash::build()). Lookup doesn't allocate
+ * and it does a single length and chars comparison.
+ */
+class PerfectHashSet
+{
+private:
+    const char* const* words;
+    const uint8_t* lengths;
+    const uint32_t* seeds;
+    size_t size;
+    // longer words are rejected w/o hashing
+    size_t maxLength;
+
+public:
+    constexpr PerfectHashSet(const char* const* words, const uint8_t* lengths, const uint32_t* seeds, size_t size)
+        : words(words),
+          lengths(lengths),
+          seeds(seeds),
+          size(size),
+          maxLength(size?perfecthash::maxLength(lengths, 0, size):0)
+    {}
+
+    constexpr size_t getSize() const { return size; }
+
+    bool contains(const char* s, size_t length) const {
+        if(length>maxLength) {
+            return false;
+        }
+        const uint64_t h = perfecthash::hashRuntime(s, length);
+        const uint32_t slot = perfecthash::slotOf(h, seeds[perfecthash::bucketOf(h, size)], size);
+        return lengths[slot]==length && !memcmp(words[slot], s, length);
+    }
+    bool contains(const std::string& s) const {
+        return contains(s.data(), s.size());
+    }
+};
+
+} // m8r namespace
+
+#endif /* M8R_PERFECT_HASH_H_ */
@@ -0,0 +1,783 @@
+/*
+ regexp.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "regexp.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace m8r {
+
+using namespace std;
+
+constexpr size_t Regexp::MAX_PROGRAM_SIZE;
+constexpr size_t Regexp::MAX_REPEAT;
+constexpr size_t Regexp::MAX_DEPTH;
+constexpr size_t Regexp::MAX_DFA_STATES;
+
+namespace {
+
+const size_t UNBOUNDED = numeric_limits<size_t>::max();
+
+void addRange(bitset<256>& chars, unsigned char from, unsigned char to)
+{
+    for(unsigned c=from; c<=to; c++) {
+        chars.set(c);
+    }
+}
+
+void addWordChars(bitset<256>& chars)
+{
+    addRange(chars, 'a', 'z');
+    addRange(chars, 'A', 'Z');
+    addRange(chars, '0', '9');
+    chars.set('_');
+}
+
+void addSpaceChars(bitset<256>& chars)
+{
+    for(char c:{' ', '\t', '\n', '\r', '\f', '\v'}) {
+        chars.set(static_cast<unsigned char>(c));
+    }
+}
+
+// make charset case insensitive (ASCII only like stringToLower())
+void foldCase(bitset<256>& chars)
+{
+    for(unsigned c='a'; c<='z'; c++) {
+        if(chars[c] || chars[c-'a'+'A']) {
+            chars.set(c);
+            chars.set(c-'a'+'A');
+        }
+    }
+}
+
+} // anonymous namespace
+
+Regexp::Regexp(const string& pattern, bool ignoreCase)
+    : pattern(pattern),
+      ignoreCase(ignoreCase),
+      offset(0),
+      depth(0),
+      byteClassesCount(0),
+      beginState(-1),
+      visitedMark(0),
+      flushes(0)
+{
+    int root = parseAlternation();
+    if(isValid() && offset < pattern.size()) {
+        fail("unmatched )");
+    }
+    if(!isValid()) {
+        return;
+    }
+
+    compile(root);
+    emit(Opcode::MATCH);
+    if(!isValid()) {
+        program.clear();
+        return;
+    }
+    computeByteClasses();
+
+    Literals literals = analyze(root);
+    if(literals.exact) {
+        literals.required.clear();
+        literals.required.push_back(literals.string);
+    }
+    for(string& literal:literals.required) {
+        if(literal.size()
+             && std::find(requiredLiterals.begin(), requiredLiterals.end(), literal)==requiredLiterals.end())
+        {
+            requiredLiterals.push_back(literal);
+        }
+    }
+    // AST is not needed anymore
+    nodes.clear();
+
+    visited.resize(program.size(), 0);
+    visitedMark++;
+    closure(beginThreads, 0, true, false);
+    visitedMark++;
+    closure(restartThreads, 0, false, false);
+    sort(restartThreads.begin(), restartThreads.end());
+    flush();
+}
+
+Regexp::~Regexp()
+{
+}
+
+string Regexp::getLongestRequiredLiteral() const
+{
+    string longest{};
+    for(const string& literal:requiredLiterals) {
+        if(literal.size() > longest.size()) {
+            longest = literal;
+        }
+    }
+    return longest;
+}
+
+/*
+ * Parser
+ */
+
+void Regexp::fail(const char* message)
+{
+    if(error.empty()) {
+        error = message;
+        error += " at offset ";
+        error += std::to_string(offset);
+    }
+}
+
+int Regexp::node(NodeType type)
+{
+    Node n{};
+    n.type = type;
+    n.min = n.max = 1;
+    nodes.push_back(n);
+    return static_cast<int>(nodes.size()-1);
+}
+
+int Regexp::parseAlternation()
+{
+    int first = parseConcatenation();
+    if(offset>=pattern.size() || pattern[offset]!='|') {
+        return first;
+    }
+
+    vector<int> children{first};
+    while(isValid() && offset<pattern.size() && pattern[offset]=='|') {
+        offset++;
+        children.push_back(parseConcatenation());
+    }
+    int n = node(NodeType::ALTERNATION);
+    nodes[n].children = children;
+    return n;
+}
+
+int Regexp::parseConcatenation()
+{
+    vector<int> children{};
+    while(isValid() && offset<pattern.size() && pattern[offset]!='|' && pattern[offset]!=')') {
+        children.push_back(parseRepeat());
+    }
+    if(children.size() == 1) {
+        return children[0];
+    }
+    int n = node(children.empty()?NodeType::EMPTY:NodeType::CONCAT);
+    nodes[n].children = children;
+    return n;
+}
+
+bool Regexp::parseNumber(size_t& number)
+{
+    size_t begin = offset;
+    number = 0;
+    while(offset<pattern.size() && pattern[offset]>='0' && pattern[offset]<='9') {
+        number = number*10 + (pattern[offset++]-'0');
+        if(number > MAX_REPEAT) {
+            fail("repeat count too big");
+            return false;
+        }
+    }
+    return offset > begin;
+}
+
+int Regexp::parseRepeat()
+{
+    int atom = parseAtom();
+    while(isValid() && offset<pattern.size()) {
+        size_t min, max;
+        char c = pattern[offset];
+        if(c=='*') {
+            min = 0; max = UNBOUNDED;
+            offset++;
+        } else if(c=='+') {
+            min = 1; max = UNBOUNDED;
+            offset++;
+        } else if(c=='?') {
+            min = 0; max = 1;
+            offset++;
+        } else if(c=='{' && offset+1<pattern.size() && pattern[offset+1]>='0' && pattern[offset+1]<='9') {
+            offset++;
+            parseNumber(min);
+            max = min;
+            if(offset<pattern.size() && pattern[offset]==',') {
+                offset++;
+                if(!parseNumber(max)) {
+                    max = UNBOUNDED;
+                }
+            }
+            if(!isValid()) {
+                break;
+            }
+            if(offset>=pattern.size() || pattern[offset]!='}') {
+                fail("missing }");
+                break;
+            }
+            offset++;
+            if(max < min) {
+                fail("invalid repeat range");
+                break;
+            }
+        } else {
+            break;
+        }
+        // lazy/possessive modifiers don't change whether text matches
+        if(offset<pattern.size() && (pattern[offset]=='?' || pattern[offset]=='+')) {
+            offset++;
+        }
+
+        int n = node(NodeType::REPEAT);
+        nodes[n].children.push_back(atom);
+        nodes[n].min = min;
+        nodes[n].max = max;
+        atom = n;
+    }
+    return atom;
+}
+
+int Regexp::parseAtom()
+{
+    int n;
+    char c = pattern[offset];
+    switch(c) {
+    case '(':
+        if(++depth > MAX_DEPTH) {
+            fail("too deeply nested");
+            return node(NodeType::EMPTY);
+        }
+        offset++;
+        if(offset+1<pattern.size() && pattern[offset]=='?') {
+            if(pattern[offset+1]!=':') {
+                fail("unsupported group type");
+                return node(NodeType::EMPTY);
+            }
+            offset+=2;
+        }
+        n = parseAlternation();
+        if(isValid() && (offset>=pattern.size() || pattern[offset]!=')')) {
+            fail("missing )");
+        }
+        offset++;
+        depth--;
+        return n;
+    case '*':
+    case '+':
+    case '?':
+        fail("nothing to repeat");
+        return node(NodeType::EMPTY);
+    case '^':
+        offset++;
+        return node(NodeType::BEGIN);
+    case '$':
+        offset++;
+        return node(NodeType::END);
+    default:
+        break;
+    }
+
+    n = node(NodeType::CHARS);
+    bitset<256> chars{};
+    if(c=='.') {
+        chars.set();
+        chars.reset('\n');
+        offset++;
+    } else if(c=='[') {
+        offset++;
+        parseClass(chars);
+    } else if(c=='\\') {
+        parseEscape(chars, false);
+    } else {
+        chars.set(static_cast<unsigned char>(c));
+        offset++;
+    }
+    if(ignoreCase) {
+        foldCase(chars);
+    }
+    nodes[n].chars = chars;
+    return n;
+}
+
+bool Regexp::parseEscape(bitset<256>& chars, bool inClass)
+{
+    offset++;
+    if(offset >= pattern.size()) {
+        fail("trailing \\");
+        return false;
+    }
+
+    char c = pattern[offset++];
+    bitset<256> s{};
+    switch(c) {
+    case 'd':
+    case 'D':
+        addRange(s, '0', '9');
+        break;
+    case 'w':
+    case 'W':
+        addWordChars(s);
+        break;
+    case 's':
+    case 'S':
+        addSpaceChars(s);
+        break;
+    case 't':
+        chars.set('\t');
+        return true;
+    case 'n':
+        chars.set('\n');
+        return true;
+    case 'r':
+        chars.set('\r');
+        return true;
+    case 'f':
+        chars.set('\f');
+        return true;
+    case 'v':
+        chars.set('\v');
+        return true;
+    default:
+        if((c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9')) {
+            // word boundaries, back references, ... are not supported
+            offset--;
+            fail(inClass?"unsupported escape in class":"unsupported escape");
+            return false;
+        }
+        chars.set(static_cast<unsigned char>(c));
+        return true;
+    }
+
+    if(c>='A' && c<='Z') {
+        s.flip();
+    }
+    chars |= s;
+    return true;
+}
+
+bool Regexp::parseClass(bitset<256>& chars)
+{
+    bool negate = false;
+    if(offset<pattern.size() && pattern[offset]=='^') {
+        negate = true;
+        offset++;
+    }
+
+    bool first = true;
+    while(offset<pattern.size() && (first || pattern[offset]!=']')) {
+        first = false;
+        if(pattern[offset]=='\\') {
+            if(!parseEscape(chars, true)) {
+                return false;
+            }
+            continue;
+        }
+
+        unsigned char from = pattern[offset++];
+        if(offset+1<pattern.size() && pattern[offset]=='-' && pattern[offset+1]!=']') {
+            unsigned char to = pattern[offset+1];
+            if(to=='\\') {
+                fail("unsupported escape in range");
+                return false;
+            }
+            if(to < from) {
+                fail("invalid class range");
+                return false;
+            }
+            addRange(chars, from, to);
+            offset+=2;
+        } else {
+            chars.set(from);
+        }
+    }
+    if(offset >= pattern.size()) {
+        fail("missing ]");
+        return false;
+    }
+    offset++;
+
+    if(ignoreCase) {
+        foldCase(chars);
+    }
+    if(negate) {
+        chars.flip();
+    }
+    return true;
+}
+
+/*
+ * Compiler
+ */
+
+void Regexp::emit(Opcode opcode, int x, int y)
+{
+    if(program.size() >= MAX_PROGRAM_SIZE) {
+        fail("expression too big");
+        return;
+    }
+    program.push_back(Instruction{opcode, x, y});
+}
+
+void Regexp::compile(int n)
+{
+    if(!isValid()) {
+        return;
+    }
+
+    const Node& nd = nodes[n];
+    switch(nd.type) {
+    case NodeType::EMPTY:
+        break;
+    case NodeType::CHARS:
+        charsets.push_back(nd.chars);
+        emit(Opcode::CHARS, static_cast<int>(charsets.size()-1));
+        break;
+    case NodeType::BEGIN:
+        emit(Opcode::BEGIN);
+        break;
+    case NodeType::END:
+        emit(Opcode::END);
+        break;
+    case NodeType::CONCAT:
+        for(int c:nd.children) {
+            compile(c);
+        }
+        break;
+    case NodeType::ALTERNATION: {
+        vector<int> jumps{};
+        for(size_t i=0; i<nd.children.size() && isValid(); i++) {
+            if(i+1 < nd.children.size()) {
+                int split = static_cast<int>(program.size());
+                emit(Opcode::SPLIT, split+1);
+                compile(nd.children[i]);
+                jumps.push_back(static_cast<int>(program.size()));
+                emit(Opcode::JUMP);
+                if(isValid()) {
+                    program[split].y = static_cast<int>(program.size());
+                }
+            } else {
+                compile(nd.children[i]);
+            }
+        }
+        if(isValid()) {
+            for(int jump:jumps) {
+                program[jump].x = static_cast<int>(program.size());
+            }
+        }
+        break;
+    }
+    case NodeType::REPEAT: {
+        int child = nd.children[0];
+        size_t min = nd.min, max = nd.max;
+        for(size_t i=0; i<min && isValid(); i++) {
+            compile(child);
+        }
+        if(max == UNBOUNDED) {
+            int split = static_cast<int>(program.size());
+            emit(Opcode::SPLIT, split+1);
+            compile(child);
+            emit(Opcode::JUMP, split);
+            if(isValid()) {
+                program[split].y = static_cast<int>(program.size());
+            }
+        } else {
+            vector<int> splits{};
+            for(size_t i=min; i<max && isValid(); i++) {
+                splits.push_back(static_cast<int>(program.size()));
+                emit(Opcode::SPLIT, static_cast<int>(program.size()+1));
+                compile(child);
+            }
+            if(isValid()) {
+                for(int split:splits) {
+                    program[split].y = static_cast<int>(program.size());
+                }
+            }
+        }
+        break;
+    }
+    }
+}
+
+void Regexp::computeByteClasses()
+{
+    // bytes which are not distinguished by any charset share the same DFA transition
+    fill(byteClasses, byteClasses+256, 0);
+    byteClassesCount = 1;
+    for(const bitset<256>& chars:charsets) {
+        vector<int> split(byteClassesCount*2, -1);
+        int count = 0;
+        for(int b=0; b<256; b++) {
+            int& c = split[byteClasses[b]*2+(chars[b]?1:0)];
+            if(c < 0) {
+                c = count++;
+            }
+            byteClasses[b] = static_cast<uint8_t>(c);
+        }
+        byteClassesCount = count;
+    }
+}
+
+Regexp::Literals Regexp::analyze(int n) const
+{
+    const Node& nd = nodes[n];
+    Literals result{};
+    result.exact = false;
+    switch(nd.type) {
+    case NodeType::EMPTY:
+    case NodeType::BEGIN:
+    case NodeType::END:
+        result.exact = true;
+        break;
+    case NodeType::CHARS:
+        if(nd.chars.count()==1) {
+            result.exact = true;
+            for(int b=0; b<256; b++) {
+                if(nd.chars[b]) {
+                    result.string += static_cast<char>(b);
+                }
+            }
+        } else if(ignoreCase && nd.chars.count()==2) {
+            for(int b='a'; b<='z'; b++) {
+                if(nd.chars[b] && nd.chars[b-'a'+'A']) {
+                    result.exact = true;
+                    result.string += static_cast<char>(b);
+                }
+            }
+        }
+        break;
+    case NodeType::CONCAT: {
+        result.exact = true;
+        string run{};
+        for(int c:nd.children) {
+            Literals l = analyze(c);
+            if(l.exact) {
+                run += l.string;
+            } else {
+                result.exact = false;
+                result.required.push_back(run);
+                run.clear();
+                result.required.insert(result.required.end(), l.required.begin(), l.required.end());
+            }
+        }
+        if(result.exact) {
+            result.string = run;
+        } else {
+            result.required.push_back(run);
+        }
+        break;
+    }
+    case NodeType::ALTERNATION: {
+        Literals first = analyze(nd.children[0]);
+        result.exact = first.exact;
+        result.string = first.string;
+        for(size_t i=1; i<nd.children.size() && result.exact; i++) {
+            Literals l = analyze(nd.children[i]);
+            result.exact = l.exact && l.string==first.string;
+        }
+        if(!result.exact) {
+            result.string.clear();
+        }
+        break;
+    }
+    case NodeType::REPEAT: {
+        if(nd.max == 0) {
+            result.exact = true;
+        } else if(nd.min > 0) {
+            Literals l = analyze(nd.children[0]);
+            if(l.exact && nd.min==nd.max && l.string.size()*nd.min<=256) {
+                result.exact = true;
+                for(size_t i=0; i<nd.min; i++) {
+                    result.string += l.string;
+                }
+            } else {
+                result.required = l.required;
+                if(l.exact) {
+                    result.required.push_back(l.string);
+                }
+            }
+        }
+        break;
+    }
+    }
+    return result;
+}
+
+/*
+ * Lazy DFA
+ */
+
+void Regexp::closure(vector<int>& threads, int pc, bool atBegin, bool atEnd)
+{
+    // threads which consume byte, match or wait for the end of text are kept
+    vector<int> stack{pc};
+    while(!stack.empty()) {
+        pc = stack.back();
+        stack.pop_back();
+        if(visited[pc] == visitedMark) {
+            continue;
+        }
+        visited[pc] = visitedMark;
+
+        const Instruction& i = program[pc];
+        switch(i.opcode) {
+        case Opcode::CHARS:
+        case Opcode::MATCH:
+            threads.push_back(pc);
+            break;
+        case Opcode::JUMP:
+            stack.push_back(i.x);
+            break;
+        case Opcode::SPLIT:
+            stack.push_back(i.y);
+            stack.push_back(i.x);
+            break;
+        case Opcode::BEGIN:
+            if(atBegin) {
+                stack.push_back(pc+1);
+            }
+            break;
+        case Opcode::END:
+            if(atEnd) {
+                stack.push_back(pc+1);
+            } else {
+                threads.push_back(pc);
+            }
+            break;
+        }
+    }
+}
+
+int Regexp::addState(const vector<int>& threads)
+{
+    DfaState s{};
+    s.threads = threads;
+    s.match = false;
+    for(int pc:threads) {
+        if(program[pc].opcode == Opcode::MATCH) {
+            s.match = true;
+        }
+    }
+    s.next.resize(byteClassesCount, -1);
+    states.push_back(s);
+    int id = static_cast<int>(states.size()-1);
+    stateIds[threads] = id;
+    return id;
+}
+
+void Regexp::flush()
+{
+    states.clear();
+    stateIds.clear();
+    flushes++;
+    vector<int> threads{beginThreads};
+    sort(threads.begin(), threads.end());
+    beginState = addState(threads);
+}
+
+int Regexp::state(vector<int>& threads)
+{
+    sort(threads.begin(), threads.end());
+    auto i = stateIds.find(threads);
+    if(i != stateIds.end()) {
+        return i->second;
+    }
+    if(states.size() >= MAX_DFA_STATES) {
+        flush();
+        i = stateIds.find(threads);
+        if(i != stateIds.end()) {
+            return i->second;
+        }
+    }
+    return addState(threads);
+}
+
+int Regexp::next(int s, uint8_t byte)
+{
+    int cached = states[s].next[byteClasses[byte]];
+    if(cached >= 0) {
+        return cached;
+    }
+
+    vector<int> threads{};
+    visitedMark++;
+    for(int pc:states[s].threads) {
+        const Instruction& i = program[pc];
+        if(i.opcode==Opcode::CHARS && charsets[i.x][byte]) {
+            closure(threads, pc+1, false, false);
+        }
+    }
+    // unanchored search - match may start at any position
+    for(int pc:restartThreads) {
+        if(visited[pc] != visitedMark) {
+            visited[pc] = visitedMark;
+            threads.push_back(pc);
+        }
+    }
+
+    size_t before = flushes;
+    int n = state(threads);
+    if(before == flushes) {
+        states[s].next[byteClasses[byte]] = n;
+    }
+    return n;
+}
+
+bool Regexp::matchAtEnd(int s, bool atBegin)
+{
+    vector<int> threads{};
+    visitedMark++;
+    for(int pc:states[s].threads) {
+        if(program[pc].opcode == Opcode::END) {
+            closure(threads, pc+1, atBegin, true);
+        }
+    }
+    for(int pc:threads) {
+        if(program[pc].opcode == Opcode::MATCH) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Regexp::search(const char* text, size_t size)
+{
+    if(!isValid()) {
+        return false;
+    }
+
+    int s = beginState;
+    if(states[s].match) {
+        return true;
+    }
+    for(size_t i=0; i<size; i++) {
+        s = next(s, static_cast<uint8_t>(text[i]));
+        if(states[s].match) {
+            return true;
+        }
+        if(states[s].threads.empty()) {
+            // anchored expression which cannot match anymore
+            return false;
+        }
+    }
+    return matchAtEnd(s, size==0);
+}
+
+} // m8r namespace
@@ -0,0 +1,194 @@
+/*
+ regexp.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_REGEXP_H_
+#define M8R_REGEXP_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <bitset>
+#include <cstdint>
+
+namespace m8r {
+
+/**
+ * @brief Regular expression search w/o backtracking.
+ *
+ * Expression is compiled to NFA which is lazily converted to DFA while
+ * searching i.e. search time is linear in the length of the text regardless
+ * of the expression (there are no backtracking blow-ups). DFA states are
+ * cached across searches - cache is flushed if it grows over the limit.
+ *
+ * Supported syntax (byte oriented):
+ *
+ *   .  [abc]  [^a-z]  \d \D \w \W \s \S  \t \n \r  \x  (escaped x)
+ *   (...)  (?:...)  a|b  ^  $
+ *   *  +  ?  {m}  {m,}  {m,n}  (lazy variants are accepted)
+ *
+ * Searching answers whether the text contains a match - match boundaries
+ * are not reported. Search mutates DFA cache i.e. an instance must
+ * not be shared by threads.
+ */
+class Regexp
+{
+public:
+    static constexpr size_t MAX_PROGRAM_SIZE = 50000;
+    static constexpr size_t MAX_REPEAT = 1000;
+    static constexpr size_t MAX_DEPTH = 500;
+    static constexpr size_t MAX_DFA_STATES = 2000;
+
+private:
+    enum class NodeType {
+        EMPTY,
+        CHARS,
+        BEGIN,
+        END,
+        CONCAT,
+        ALTERNATION,
+        REPEAT
+    };
+
+    // AST node - children are indices to nodes vector
+    struct Node {
+        NodeType type;
+        std::bitset<256> chars;
+        std::vector<int> children;
+        size_t min;
+        size_t max;
+    };
+
+    enum class Opcode {
+        CHARS,
+        SPLIT,
+        JUMP,
+        BEGIN,
+        END,
+        MATCH
+    };
+
+    struct Instruction {
+        Opcode opcode;
+        // jump targets or charset index
+        int x;
+        int y;
+    };
+
+    struct DfaState {
+        std::vector<int> threads;
+        bool match;
+        // transitions by byte class (-1 if not computed yet)
+        std::vector<int> next;
+    };
+
+    // literals analysis of an AST node
+    struct Literals {
+        // node always matches exactly the string
+        bool exact;
+        std::string string;
+        // strings which are contained in every match of the node
+        std::vector<std::string> required;
+    };
+
+    std::string pattern;
+    bool ignoreCase;
+    std::string error;
+
+    // parser
+    size_t offset;
+    size_t depth;
+    std::vector<Node> nodes;
+
+    // NFA
+    std::vector<Instruction> program;
+    std::vector<std::bitset<256>> charsets;
+    uint8_t byteClasses[256];
+    int byteClassesCount;
+
+    std::vector<std::string> requiredLiterals;
+
+    // lazy DFA
+    std::vector<DfaState> states;
+    std::map<std::vector<int>,int> stateIds;
+    int beginState;
+    // threads at the beginning of text and threads (re)started at every other position
+    std::vector<int> beginThreads;
+    std::vector<int> restartThreads;
+    std::vector<int> visited;
+    int visitedMark;
+    size_t flushes;
+
+public:
+    explicit Regexp(const std::string& pattern, bool ignoreCase=false);
+    Regexp(const Regexp&) = delete;
+    Regexp(const Regexp&&) = delete;
+    Regexp &operator=(const Regexp&) = delete;
+    Regexp &operator=(const Regexp&&) = delete;
+    ~Regexp();
+
+    bool isValid() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+    const std::string& getPattern() const { return pattern; }
+    bool isIgnoreCase() const { return ignoreCase; }
+
+    /**
+     * @brief Get literals which must be contained in every matching text.
+     *
+     * Literals are lower case if case is ignored.
+     */
+    const std::vector<std::string>& getRequiredLiterals() const { return requiredLiterals; }
+    /**
+     * @brief Get the longest required literal (or empty string).
+     */
+    std::string getLongestRequiredLiteral() const;
+
+    /**
+     * @brief Check whether text contains a match of the expression.
+     */
+    bool search(const char* text, size_t size);
+    bool search(const std::string& text) { return search(text.data(), text.size()); }
+
+    size_t getDfaStatesCount() const { return states.size(); }
+
+private:
+    int node(NodeType type);
+    int parseAlternation();
+    int parseConcatenation();
+    int parseRepeat();
+    int parseAtom();
+    bool parseClass(std::bitset<256>& chars);
+    bool parseEscape(std::bitset<256>& chars, bool inClass);
+    bool parseNumber(size_t& number);
+    void fail(const char* message);
+
+    void compile(int n);
+    void emit(Opcode opcode, int x=0, int y=0);
+    void computeByteClasses();
+    Literals analyze(int n) const;
+
+    void closure(std::vector<int>& threads, int pc, bool atBegin, bool atEnd);
+    int state(std::vector<int>& threads);
+    int addState(const std::vector<int>& threads);
+    int next(int s, uint8_t byte);
+    bool matchAtEnd(int s, bool atBegin);
+    void flush();
+};
+
+} // m8r namespace
+
+#endif /* M8R_REGEXP_H_ */
@@ -20,6 +20,11 @@
 
 #include <cassert>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+  #define M8R_SIMD_X86
+  #include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace m8r {
@@ -149,4 +154,326 @@ string normalizeToNcName(string name, char quoteChar) {
     return result;
 }
 
+void utf8Append(string& s, uint32_t codePoint)
+{
+    if(codePoint < 0x80) {
+        s += static_cast<char>(codePoint);
+    } else if(codePoint < 0x800) {
+        s += static_cast<char>(0xC0|(codePoint>>6));
+        s += static_cast<char>(0x80|(codePoint&0x3F));
+    } else if(codePoint < 0x10000) {
+        s += static_cast<char>(0xE0|(codePoint>>12));
+        s += static_cast<char>(0x80|((codePoint>>6)&0x3F));
+        s += static_cast<char>(0x80|(codePoint&0x3F));
+    } else {
+        s += static_cast<char>(0xF0|(codePoint>>18));
+        s += static_cast<char>(0x80|((codePoint>>12)&0x3F));
+        s += static_cast<char>(0x80|((codePoint>>6)&0x3F));
+        s += static_cast<char>(0x80|(codePoint&0x3F));
+    }
+}
+
+size_t utf8Length(const string& s)
+{
+    size_t length = 0;
+    for(char c:s) {
+        // count all bytes except continuation bytes
+        if((static_cast<unsigned char>(c)&0xC0) != 0x80) {
+            length++;
+        }
+    }
+    return length;
+}
+
+bool unicodeIsLetter(uint32_t c)
+{
+    if(c < 0xC0) {
+        // ASCII, C1 controls, Latin-1 punctuation and symbols except ordinal indicators and micro sign
+        return c==0xAA || c==0xB5 || c==0xBA;
+    }
+    if(c < 0x2000) {
+        // Latin-1 letters, Latin extended, IPA, combining marks, Greek, Cyrillic, ... except multiplication/division signs
+        return c!=0xD7 && c!=0xF7 && c!=0x37E && c!=0x387 && c!=0x589 && c!=0x5BE && c!=0x5C0 && c!=0x5C3
+            && c!=0x60C && c!=0x61B && c!=0x61F && c!=0x6D4 && c!=0x964 && c!=0x965;
+    }
+    if(c < 0x2C00) {
+        // general punctuation, super/subscripts, currency, letterlike symbols, arrows, math, box drawing, dingbats, ...
+        return false;
+    }
+    if(c>=0x3000 && c<=0x303F) {
+        // CJK symbols and punctuation
+        return false;
+    }
+    if(c>=0xE000 && c<=0xF8FF) {
+        // private use area
+        return false;
+    }
+    if((c>=0xFE10 && c<=0xFE6F) || (c>=0xFF00 && c<=0xFF0F) || (c>=0xFF1A && c<=0xFF20)
+       || (c>=0xFF3B && c<=0xFF40) || (c>=0xFF5B && c<=0xFF65) || (c>=0xFFF0 && c<=0xFFFF))
+    {
+        // vertical/small/fullwidth punctuation and specials
+        return false;
+    }
+    // emoji and pictographs
+    return c<0x1F000 || c>0x1FAFF;
+}
+
+uint32_t unicodeFoldCase(uint32_t c)
+{
+    if(c < 0x80) {
+        return (c>='A' && c<='Z')?c+('a'-'A'):c;
+    }
+    if(c < 0x100) {
+        // Latin-1
+        return (c>=0xC0 && c<=0xDE && c!=0xD7)?c+0x20:c;
+    }
+    if(c < 0x180) {
+        // Latin extended-A: pairs of upper and lower case letters
+        if(c==0x130) return 'i';
+        if(c==0x178) return 0xFF;
+        if(c==0x17F) return 's';
+        if((c>=0x139 && c<=0x148) || (c>=0x179 && c<=0x17E)) {
+            return (c&1)?c+1:c;
+        }
+        if(c==0x131 || c==0x138 || c==0x149) {
+            return c;
+        }
+        return (c&1)?c:c+1;
+    }
+    if(c>=0x370 && c<0x400) {
+        // Greek
+        if(c>=0x391 && c<=0x3AB && c!=0x3A2) return c+0x20;
+        if(c==0x386) return 0x3AC;
+        if(c>=0x388 && c<=0x38A) return c+0x25;
+        if(c==0x38C) return 0x3CC;
+        if(c==0x38E || c==0x38F) return c+0x3F;
+        if(c==0x3C2) return 0x3C3;
+        return c;
+    }
+    if(c>=0x400 && c<0x530) {
+        // Cyrillic
+        if(c < 0x410) return c+0x50;
+        if(c < 0x430) return c+0x20;
+        if(c < 0x460) return c;
+        if(c==0x4C0) return 0x4CF;
+        if(c>=0x4C1 && c<=0x4CE) return (c&1)?c+1:c;
+        if((c>=0x460 && c<=0x481) || (c>=0x48A && c<=0x4BF) || (c>=0x4D0 && c<=0x52F)) {
+            return (c&1)?c:c+1;
+        }
+        return c;
+    }
+    if(c>=0x1E00 && c<0x1F00) {
+        // Latin extended additional
+        if(c==0x1E9E) return 0xDF;
+        if(c<=0x1E95 || c>=0x1EA0) return (c&1)?c:c+1;
+        return c;
+    }
+    return c;
+}
+
+/*
+ * Case insensitive search kernels.
+ *
+ * SIMD kernels compare the first and the last character of the needle
+ * with 16/32 haystack positions at once and verify the rest of the needle
+ * only for positions where both of them match.
+ */
+
+namespace {
+
+inline char asciiToLower(char c)
+{
+    return (c>='A' && c<='Z')?c+('a'-'A'):c;
+}
+
+inline __attribute__((always_inline)) bool equalsIgnoreCase(const char* s, const char* lowerNeedle, size_t size)
+{
+    for(size_t i=0; i<size; i++) {
+        if(asciiToLower(s[i]) != lowerNeedle[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t findIgnoreCaseScalar(const char* haystack, size_t haystackSize, const char* lowerNeedle, size_t needleSize)
+{
+    for(size_t i=0; i+needleSize<=haystackSize; i++) {
+        if(asciiToLower(haystack[i])==lowerNeedle[0]
+             && equalsIgnoreCase(haystack+i+1, lowerNeedle+1, needleSize-1))
+        {
+            return i;
+        }
+    }
+    return string::npos;
+}
+
+#ifdef M8R_SIMD_X86
+
+inline __attribute__((always_inline)) __m128i asciiToLowerSse2(__m128i c)
+{
+    // 'A'..'Z' shifted to the lowest signed values allows single signed comparison
+    const __m128i shifted = _mm_add_epi8(c, _mm_set1_epi8(static_cast<char>(0x80-'A')));
+    const __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80+26)));
+    return _mm_or_si128(c, _mm_and_si128(upper, _mm_set1_epi8('a'-'A')));
+}
+
+// always inlined so that kernels w/ wider vectors use it (VEX encoded) w/o SSE/AVX transition penalty
+inline __attribute__((always_inline)) size_t findIgnoreCaseSse2Blocks(
+        const char* haystack,
+        size_t haystackSize,
+        const char* lowerNeedle,
+        size_t needleSize)
+{
+    const size_t middleSize = needleSize<2?0:needleSize-2;
+    const __m128i first = _mm_set1_epi8(lowerNeedle[0]);
+    const __m128i last = _mm_set1_epi8(lowerNeedle[needleSize-1]);
+
+    size_t i = 0;
+    for(; i+needleSize-1+16<=haystackSize; i+=16) {
+        const __m128i f = asciiToLowerSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack+i)));
+        const __m128i l = asciiToLowerSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack+i+needleSize-1)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(f, first), _mm_cmpeq_epi8(l, last))));
+        while(mask) {
+            const unsigned bit = __builtin_ctz(mask);
+            if(equalsIgnoreCase(haystack+i+bit+1, lowerNeedle+1, middleSize)) {
+                return i+bit;
+            }
+            mask &= mask-1;
+        }
+    }
+
+    const size_t m = findIgnoreCaseScalar(haystack+i, haystackSize-i, lowerNeedle, needleSize);
+    return m==string::npos?m:i+m;
+}
+
+size_t findIgnoreCaseSse2(const char* haystack, size_t haystackSize, const char* lowerNeedle, size_t needleSize)
+{
+    return findIgnoreCaseSse2Blocks(haystack, haystackSize, lowerNeedle, needleSize);
+}
+
+__attribute__((target("avx2")))
+inline __m256i asciiToLowerAvx2(__m256i c)
+{
+    const __m256i shifted = _mm256_add_epi8(c, _mm256_set1_epi8(static_cast<char>(0x80-'A')));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80+26)), shifted);
+    return _mm256_or_si256(c, _mm256_and_si256(upper, _mm256_set1_epi8('a'-'A')));
+}
+
+__attribute__((target("avx2")))
+size_t findIgnoreCaseAvx2(const char* haystack, size_t haystackSize, const char* lowerNeedle, size_t needleSize)
+{
+    const size_t middleSize = needleSize<2?0:needleSize-2;
+    const __m256i first = _mm256_set1_epi8(lowerNeedle[0]);
+    const __m256i last = _mm256_set1_epi8(lowerNeedle[needleSize-1]);
+
+    size_t i = 0;
+    for(; i+needleSize-1+32<=haystackSize; i+=32) {
+        const __m256i f = asciiToLowerAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack+i)));
+        const __m256i l = asciiToLowerAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack+i+needleSize-1)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(f, first), _mm256_cmpeq_epi8(l, last))));
+        while(mask) {
+            const unsigned bit = __builtin_ctz(mask);
+            if(equalsIgnoreCase(haystack+i+bit+1, lowerNeedle+1, middleSize)) {
+                return i+bit;
+            }
+            mask &= mask-1;
+        }
+    }
+
+    const size_t m = findIgnoreCaseSse2Blocks(haystack+i, haystackSize-i, lowerNeedle, needleSize);
+    return m==string::npos?m:i+m;
+}
+
+#endif
+
+StringSearchKernel detectStringSearchKernel()
+{
+#ifdef M8R_SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return StringSearchKernel::AVX2;
+    }
+    return StringSearchKernel::SSE2;
+#else
+    return StringSearchKernel::SCALAR;
+#endif
+}
+
+} // anonymous namespace
+
+StringSearchKernel stringSearchKernel()
+{
+    static const StringSearchKernel kernel = detectStringSearchKernel();
+    return kernel;
+}
+
+size_t stringFindIgnoreCase(
+        const char* haystack,
+        size_t haystackSize,
+        const char* lowerNeedle,
+        size_t needleSize,
+        StringSearchKernel kernel)
+{
+    if(!needleSize) {
+        return 0;
+    }
+    if(needleSize > haystackSize) {
+        return string::npos;
+    }
+
+    if(kernel > stringSearchKernel()) {
+        kernel = stringSearchKernel();
+    }
+    switch(kernel) {
+#ifdef M8R_SIMD_X86
+    case StringSearchKernel::AVX2:
+        return findIgnoreCaseAvx2(haystack, haystackSize, lowerNeedle, needleSize);
+    case StringSearchKernel::SSE2:
+        return findIgnoreCaseSse2(haystack, haystackSize, lowerNeedle, needleSize);
+#endif
+    default:
+        return findIgnoreCaseScalar(haystack, haystackSize, lowerNeedle, needleSize);
+    }
+}
+
+size_t stringFindIgnoreCase(const string& haystack, const string& lowerNeedle, size_t from)
+{
+    if(from > haystack.size()) {
+        return string::npos;
+    }
+    const size_t m = stringFindIgnoreCase(
+        haystack.data()+from,
+        haystack.size()-from,
+        lowerNeedle.data(),
+        lowerNeedle.size(),
+        stringSearchKernel());
+    return m==string::npos?m:from+m;
+}
+
+size_t stringCountIgnoreCase(const string& haystack, const string& lowerNeedle, StringSearchKernel kernel)
+{
+    size_t count = 0;
+    // semantics of std::string::find() loop i.e. overlapping matches are counted
+    for(size_t from=0; from<=haystack.size(); from++) {
+        const size_t m = stringFindIgnoreCase(
+            haystack.data()+from,
+            haystack.size()-from,
+            lowerNeedle.data(),
+            lowerNeedle.size(),
+            kernel);
+        if(m == string::npos) {
+            break;
+        }
+        count++;
+        from += m;
+    }
+    return count;
+}
+
+size_t stringCountIgnoreCase(const string& haystack, const string& lowerNeedle)
+{
+    return stringCountIgnoreCase(haystack, lowerNeedle, stringSearchKernel());
+}
+
 } /* namespace */
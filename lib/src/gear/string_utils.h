@@ -21,7 +21,9 @@
 
 #include <cstring>
 #include <cctype>
+#include <cstdint>
 
+#include <string>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -36,6 +38,84 @@ namespace m8r {
  *  Helper functions for handling C character strings and std::strings.
  */
 
+/**
+ * @brief Non-owning view of characters (std::string_view is not available in C++11).
+ */
+struct StringView {
+    const char* data;
+    size_t size;
+
+    std::string str() const { return std::string(data, size); }
+};
+
+/**
+ * @brief Decode UTF-8 sequence at p (p < end) and move p behind it.
+ *
+ * Invalid, overlong or truncated sequence is decoded as U+FFFD replacement
+ * character and p is moved by one byte.
+ */
+static inline uint32_t utf8Decode(const char*& p, const char* end)
+{
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if(c < 0x80) {
+        ++p;
+        return c;
+    }
+    size_t length;
+    uint32_t codePoint, min;
+    if((c&0xE0) == 0xC0) {
+        length = 2; codePoint = c&0x1F; min = 0x80;
+    } else if((c&0xF0) == 0xE0) {
+        length = 3; codePoint = c&0x0F; min = 0x800;
+    } else if((c&0xF8) == 0xF0) {
+        length = 4; codePoint = c&0x07; min = 0x10000;
+    } else {
+        ++p;
+        return 0xFFFD;
+    }
+    if(static_cast<size_t>(end-p) < length) {
+        ++p;
+        return 0xFFFD;
+    }
+    for(size_t i=1; i<length; i++) {
+        const unsigned char n = static_cast<unsigned char>(p[i]);
+        if((n&0xC0) != 0x80) {
+            ++p;
+            return 0xFFFD;
+        }
+        codePoint = (codePoint<<6) | (n&0x3F);
+    }
+    if(codePoint < min || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        ++p;
+        return 0xFFFD;
+    }
+    p += length;
+    return codePoint;
+}
+
+/**
+ * @brief Append code point to string as UTF-8.
+ */
+void utf8Append(std::string& s, uint32_t codePoint);
+
+/**
+ * @brief Get number of code points of UTF-8 string.
+ */
+size_t utf8Length(const std::string& s);
+
+/**
+ * @brief Is non-ASCII code point a part of word (letter, mark, ideograph)?
+ *
+ * Cheap classification w/o Unicode database: code point is a letter
+ * unless it belongs to punctuation, space or symbol blocks.
+ */
+bool unicodeIsLetter(uint32_t codePoint);
+
+/**
+ * @brief Simple (1:1) Unicode case folding of Latin, Greek and Cyrillic letters.
+ */
+uint32_t unicodeFoldCase(uint32_t codePoint);
+
 bool stringStartsWith(const char* s, const char* prefix);
 bool stringStartsWith(const std::string& s, const char* prefix);
 bool stringStartsWith(const std::string& s, const std::string& prefix);
@@ -79,6 +159,48 @@ static inline void stringToLower(const std::string& s, std::string& lowerS)
     }
 }
 
+/**
+ * @brief Implementation of case insensitive search kernels.
+ *
+ * Kernels are ordered from the slowest one - the best kernel supported
+ * by CPU is chosen at runtime.
+ */
+enum class StringSearchKernel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Get the best search kernel supported by CPU.
+ */
+StringSearchKernel stringSearchKernel();
+
+/**
+ * @brief Find lower case needle in haystack while ignoring ASCII case of haystack.
+ *
+ * Haystack is not copied nor converted to lower case i.e. search doesn't
+ * allocate. Case folding is consistent with stringToLower() in the default
+ * (classic) locale - only ASCII letters are folded. Needle must be lower case.
+ *
+ * @param kernel    kernel to be used - kernel which is not supported by CPU
+ *                  is replaced with the best supported one.
+ * @return position of the first match or std::string::npos.
+ */
+size_t stringFindIgnoreCase(
+        const char* haystack,
+        size_t haystackSize,
+        const char* lowerNeedle,
+        size_t needleSize,
+        StringSearchKernel kernel);
+size_t stringFindIgnoreCase(const std::string& haystack, const std::string& lowerNeedle, size_t from=0);
+
+/**
+ * @brief Count (possibly overlapping) occurrences of lower case needle in haystack while ignoring ASCII case.
+ */
+size_t stringCountIgnoreCase(const std::string& haystack, const std::string& lowerNeedle);
+size_t stringCountIgnoreCase(const std::string& haystack, const std::string& lowerNeedle, StringSearchKernel kernel);
+
 /**
  * @brief Trim leading and trailing whitespaces.
  *
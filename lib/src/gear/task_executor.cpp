@@ -0,0 +1,171 @@
+/*
+ task_executor.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "task_executor.h"
+
+#include <algorithm>
+
+namespace m8r {
+
+using namespace std;
+
+TaskExecutor::TaskExecutor(unsigned threads)
+    : maxThreads(threads?threads:std::max(1u, thread::hardware_concurrency())),
+      busyThreads{0},
+      shutdown{false},
+      executedCount{0},
+      cancelledCount{0}
+{
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    {
+        unique_lock<mutex> criticalSection{queueMutex};
+        shutdown = true;
+        for(Task& task:queue) {
+            task.promise.set_value(false);
+            cancelledCount++;
+        }
+        queue.clear();
+    }
+    taskQueued.notify_all();
+
+    for(thread& t:threads) {
+        t.join();
+    }
+}
+
+shared_future<bool> TaskExecutor::submit(TaskKey key, function<bool()> task)
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+
+    if(key) {
+        auto r = running.find(key);
+        if(r != running.end()) {
+            return r->second;
+        }
+        for(Task& t:queue) {
+            if(t.key == key) {
+                return t.future;
+            }
+        }
+    }
+
+    queue.push_back(Task{key, std::move(task), promise<bool>{}, shared_future<bool>{}});
+    Task& queued = queue.back();
+    queued.future = queued.promise.get_future().share();
+    shared_future<bool> result = queued.future;
+
+    // new thread only if all threads are busy
+    if(threads.size() < maxThreads && busyThreads+queue.size() > threads.size()) {
+        threads.push_back(thread{&TaskExecutor::work, this});
+    }
+    criticalSection.unlock();
+
+    taskQueued.notify_one();
+    return result;
+}
+
+size_t TaskExecutor::cancel(TaskKey except)
+{
+    size_t cancelled = 0;
+    {
+        lock_guard<mutex> criticalSection{queueMutex};
+        for(auto t=queue.begin(); t!=queue.end(); ) {
+            if(t->key && t->key != except) {
+                t->promise.set_value(false);
+                t = queue.erase(t);
+                cancelled++;
+            } else {
+                ++t;
+            }
+        }
+        cancelledCount += cancelled;
+    }
+    if(cancelled) {
+        taskFinished.notify_all();
+    }
+    return cancelled;
+}
+
+void TaskExecutor::wait()
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+    taskFinished.wait(criticalSection, [this]{ return queue.empty() && !busyThreads; });
+}
+
+void TaskExecutor::work()
+{
+    unique_lock<mutex> criticalSection{queueMutex};
+    while(true) {
+        taskQueued.wait(criticalSection, [this]{ return shutdown || !queue.empty(); });
+        if(queue.empty()) {
+            // shutdown
+            return;
+        }
+
+        Task task = std::move(queue.front());
+        queue.pop_front();
+        busyThreads++;
+        if(task.key) {
+            running[task.key] = task.future;
+        }
+        criticalSection.unlock();
+
+        try {
+            task.promise.set_value(task.function());
+        } catch(...) {
+            task.promise.set_exception(current_exception());
+        }
+
+        criticalSection.lock();
+        if(task.key) {
+            running.erase(task.key);
+        }
+        busyThreads--;
+        executedCount++;
+        taskFinished.notify_all();
+    }
+}
+
+size_t TaskExecutor::getThreadsCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return threads.size();
+}
+
+size_t TaskExecutor::getQueueSize()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return queue.size();
+}
+
+size_t TaskExecutor::getExecutedCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return executedCount;
+}
+
+size_t TaskExecutor::getCancelledCount()
+{
+    lock_guard<mutex> criticalSection{queueMutex};
+    return cancelledCount;
+}
+
+} // m8r namespace
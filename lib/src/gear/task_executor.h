@@ -0,0 +1,153 @@
+/*
+ task_executor.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_TASK_EXECUTOR_H_
+#define M8R_TASK_EXECUTOR_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Bounded pool of worker threads w/ FIFO queue of tasks.
+ *
+ * Threads are started on demand up to the limit and they are joined when
+ * executor is destroyed i.e. threads never outlive executor.
+ *
+ * Task may have a key (e.g. N whose leaderboard is calculated):
+ *  - task w/ the same key as a queued or running task is not queued again,
+ *    future of the queued/running task is returned instead (coalescing),
+ *  - queued tasks w/ key can be cancelled - future of cancelled task is
+ *    set to false. Running tasks are never interrupted.
+ * Tasks w/o key (nullptr) are neither coalesced nor cancelled.
+ */
+class TaskExecutor
+{
+public:
+    typedef const void* TaskKey;
+
+private:
+    struct Task {
+        TaskKey key;
+        std::function<bool()> function;
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+    };
+
+    const unsigned maxThreads;
+
+    std::mutex queueMutex;
+    // workers wait for tasks
+    std::condition_variable taskQueued;
+    // callers of wait() wait for idle executor
+    std::condition_variable taskFinished;
+    std::deque<Task> queue;
+    // futures of running tasks w/ key
+    std::map<TaskKey,std::shared_future<bool>> running;
+    std::vector<std::thread> threads;
+    unsigned busyThreads;
+    bool shutdown;
+
+    size_t executedCount;
+    size_t cancelledCount;
+
+public:
+    /**
+     * @param threads   maximum number of worker threads, 0 to use all CPUs.
+     */
+    explicit TaskExecutor(unsigned threads=0);
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor(const TaskExecutor&&) = delete;
+    TaskExecutor &operator=(const TaskExecutor&) = delete;
+    TaskExecutor &operator=(const TaskExecutor&&) = delete;
+    /**
+     * @brief Cancel queued tasks (w/ and w/o key) and join threads once running tasks finish.
+     */
+    ~TaskExecutor();
+
+    /**
+     * @brief Queue task (or join queued/running task w/ the same key).
+     *
+     * Exception thrown by task is propagated through the future.
+     */
+    std::shared_future<bool> submit(TaskKey key, std::function<bool()> task);
+
+    /**
+     * @brief Cancel queued tasks w/ key other than given key (nullptr ~ all tasks w/ key).
+     * @return number of cancelled tasks.
+     */
+    size_t cancel(TaskKey except=nullptr);
+
+    /**
+     * @brief Block until there are no queued nor running tasks.
+     */
+    void wait();
+
+    unsigned getMaxThreads() const { return maxThreads; }
+    size_t getThreadsCount();
+    size_t getQueueSize();
+    size_t getExecutedCount();
+    size_t getCancelledCount();
+
+private:
+    void work();
+};
+
+/**
+ * @brief Delete tasks w/ ready future and call f(task, result) before each delete.
+ *
+ * TASK is pointer to object w/ isReady() and isSuccessful() (future's value).
+ * Tasks cancelled by executor are ready and not successful i.e. they are deleted
+ * as well, task which failed w/ exception is not successful.
+ *
+ * @return number of deleted tasks.
+ */
+template<class TASK, class F>
+size_t deleteReadyTasks(std::vector<TASK*>& tasks, F f)
+{
+    size_t deleted = 0;
+    auto i = tasks.begin();
+    while(i != tasks.end()) {
+        if((*i)->isReady()) {
+            bool successful;
+            try {
+                successful = (*i)->isSuccessful();
+            } catch(...) {
+                successful = false;
+            }
+            f(*i, successful);
+            delete *i;
+            i = tasks.erase(i);
+            deleted++;
+        } else {
+            ++i;
+        }
+    }
+    return deleted;
+}
+
+} // m8r namespace
+
+#endif /* M8R_TASK_EXECUTOR_H_ */
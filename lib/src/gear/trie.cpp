@@ -18,79 +18,332 @@
 */
 #include "trie.h"
 
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
 namespace m8r {
 
 using namespace std;
 
+constexpr uint16_t Trie::Node::WORD;
+constexpr uint32_t Trie::SERIALIZATION_MAGIC;
+constexpr uint32_t Trie::SERIALIZATION_VERSION;
+constexpr size_t Trie::MAX_LABEL_SIZE;
+
 Trie::Trie()
+    : nodeStorage{},
+      firstStorage{},
+      labelStorage{},
+      nodes{nullptr},
+      nodesCount{0},
+      firsts{nullptr},
+      labels{nullptr},
+      labelsSize{0}
 {
-    root = new Node();
 }
 
 Trie::~Trie()
 {
-    // delete nodes using backtracking
-    destroy(root);
 }
 
-void Trie::destroy(Node* n)
-{    
-    for(Node* c:n->mChildren) {
-        destroy(c);
-    }
-    delete n;
+void Trie::clear()
+{
+    nodeStorage.clear();
+    firstStorage.clear();
+    labelStorage.clear();
+    nodes = nullptr;
+    nodesCount = 0;
+    firsts = nullptr;
+    labels = nullptr;
+    labelsSize = 0;
 }
 
-void Trie::addWord(string s)
+void Trie::build(const vector<string>& sortedWords, const vector<uint32_t>* weights)
 {
-    Node* current = root;
-
-    if(!s.size()) {
-        current->setWordMarker(); // an empty word
+    clear();
+    if(sortedWords.empty()) {
         return;
     }
 
-    for(size_t i=0; i<s.size(); i++) {
-        Node* child = current->findChild(s[i]);
+    // nodes are created breadth first so that children of a node are contiguous
+    struct Range {
+        size_t lo, hi;
+        // chars of words consumed by ancestors
+        size_t depth;
+    };
+    vector<Range> ranges{};
+    nodeStorage.push_back(Node{});
+    ranges.push_back(Range{0, sortedWords.size(), 0});
+    for(size_t n=0; n<nodeStorage.size(); n++) {
+        const Range r = ranges[n];
+        const string& first = sortedWords[r.lo];
+        const string& last = sortedWords[r.hi-1];
 
-        if(child != nullptr) {
-            current = child;
-        } else {
-            Node* n= new Node();
-            n->setContent(s[i]);
-            current->appendChild(n);
-            current = n;
+        // label is the common prefix of (sorted) words in range
+        size_t end = r.depth;
+        const size_t maxEnd = r.depth + std::min(std::min(first.size(), last.size())-r.depth, MAX_LABEL_SIZE);
+        while(end<maxEnd && first[end]==last[end]) {
+            end++;
         }
+        nodeStorage[n].label = labelStorage.size();
+        nodeStorage[n].labelSize = end-r.depth;
+        firstStorage.push_back(end>r.depth?first[r.depth]:0);
+        labelStorage.append(first, r.depth, end-r.depth);
 
-        if(i == s.size()-1) {
-            current->setWordMarker();
+        size_t lo = r.lo;
+        if(first.size()==end) {
+            nodeStorage[n].children = Node::WORD;
+            nodeStorage[n].weight = weights?(*weights)[r.lo]:0;
+            lo++;
+        }
+        nodeStorage[n].firstChild = nodeStorage.size();
+        while(lo<r.hi) {
+            // child per the first char of words after label
+            size_t hi = lo+1;
+            while(hi<r.hi && sortedWords[hi][end]==sortedWords[lo][end]) {
+                hi++;
+            }
+            nodeStorage[n].children++;
+            nodeStorage.push_back(Node{});
+            ranges.push_back(Range{lo, hi, end});
+            lo = hi;
         }
     }
+
+    // children follow their parent i.e. subtree maximums are calculated backwards
+    for(size_t n=nodeStorage.size(); n-->0;) {
+        Node& node = nodeStorage[n];
+        node.maxWeight = node.isWord()?node.weight:0;
+        for(size_t c=node.firstChild; c<node.firstChild+node.childCount(); c++) {
+            node.maxWeight = std::max(node.maxWeight, nodeStorage[c].maxWeight);
+        }
+    }
+
+    nodeStorage.shrink_to_fit();
+    firstStorage.shrink_to_fit();
+    labelStorage.shrink_to_fit();
+    nodes = nodeStorage.data();
+    nodesCount = nodeStorage.size();
+    firsts = firstStorage.data();
+    labels = labelStorage.data();
+    labelsSize = labelStorage.size();
 }
 
-bool Trie::findWord(string& s) const
+void Trie::addWord(const string& s, uint32_t weight)
 {
-    if(root->children().empty()) {
-        return false;
+    vector<string> words{};
+    vector<uint32_t> weights{};
+    getWords(words, &weights);
+
+    auto i = lower_bound(words.begin(), words.end(), s);
+    if(i!=words.end() && *i==s) {
+        weights[i-words.begin()] = weight;
     } else {
-        Node* current = root;
-        while(current != nullptr) {
-            for(size_t i=0; i<s.size(); i++) {
-                Node* n= current->findChild(s[i]);
-                if(n == nullptr) {
-                    return false;
-                }
-                current = n;
+        weights.insert(weights.begin()+(i-words.begin()), weight);
+        words.insert(i, s);
+    }
+    build(words, &weights);
+}
+
+void Trie::deleteWord(const string& s)
+{
+    if(findWord(s)) {
+        vector<string> words{};
+        vector<uint32_t> weights{};
+        getWords(words, &weights);
+
+        auto i = lower_bound(words.begin(), words.end(), s);
+        weights.erase(weights.begin()+(i-words.begin()));
+        words.erase(i);
+        build(words, &weights);
+    }
+}
+
+const Trie::Node* Trie::findChild(const Node& node, uint8_t c) const
+{
+    size_t lo = node.firstChild;
+    size_t hi = lo+node.childCount();
+    // most of nodes have few children
+    while(hi-lo>8) {
+        size_t mid = lo+(hi-lo)/2;
+        if(firsts[mid]<c) {
+            lo = mid+1;
+        } else if(firsts[mid]>c) {
+            hi = mid;
+        } else {
+            return nodes+mid;
+        }
+    }
+    for(; lo<hi; lo++) {
+        if(firsts[lo]==c) {
+            return nodes+lo;
+        }
+    }
+    return nullptr;
+}
+
+const Trie::Node* Trie::findNode(const string& s, bool prefix, size_t& labelMatched) const
+{
+    if(!nodesCount) {
+        return nullptr;
+    }
+
+    const char* p = s.data();
+    const char* end = p+s.size();
+    const Node* node = nodes;
+    // the first char of child's label is matched by findChild()
+    size_t matched = 0;
+    while(true) {
+        const char* label = labels+node->label;
+        size_t size = node->labelSize;
+        if(static_cast<size_t>(end-p) < size) {
+            // word ends inside label
+            size = end-p;
+            if(!prefix) {
+                return nullptr;
             }
+        }
+        for(; matched<size; matched++) {
+            if(p[matched]!=label[matched]) {
+                return nullptr;
+            }
+        }
+        p += size;
+        if(p==end) {
+            labelMatched = size;
+            return node;
+        }
+        node = findChild(*node, *p);
+        if(!node) {
+            return nullptr;
+        }
+        matched = 1;
+    }
+}
+
+bool Trie::findWord(const string& s) const
+{
+    size_t labelMatched;
+    const Node* node = findNode(s, false, labelMatched);
+    return node && node->isWord();
+}
+
+void Trie::collectWords(const Node& node, string& word, vector<string>& words, vector<uint32_t>* weights) const
+{
+    size_t size = word.size();
+    word.append(labels+node.label, node.labelSize);
+    if(node.isWord()) {
+        words.push_back(word);
+        if(weights) weights->push_back(node.weight);
+    }
+    for(size_t c=node.firstChild; c<node.firstChild+node.childCount(); c++) {
+        collectWords(nodes[c], word, words, weights);
+    }
+    word.resize(size);
+}
+
+void Trie::getWords(vector<string>& words, vector<uint32_t>* weights) const
+{
+    if(nodesCount) {
+        string word{};
+        collectWords(nodes[0], word, words, weights);
+    }
+}
+
+void Trie::findPrefix(const string& prefix, size_t k, vector<pair<string,uint32_t>>& result) const
+{
+    size_t labelMatched;
+    const Node* start = findNode(prefix, true, labelMatched);
+    if(!start || !k) {
+        return;
+    }
+
+    // best first search: subtree is expanded when its maximum weight is the highest one
+    struct Candidate {
+        uint32_t weight;
+        const Node* node;
+        // word (node's subtree is already expanded) or node path (incl. its label)
+        bool word;
+        string path;
 
-            if(current->wordMarker()) {
-                return true;
-            } else {
-                return false;
+        bool operator<(const Candidate& c) const {
+            // priority queue gives the greatest - the highest weight, the lowest path, word before subtree
+            if(weight!=c.weight) return weight<c.weight;
+            int cmp = path.compare(c.path);
+            if(cmp) return cmp>0;
+            return !word && c.word;
+        }
+    };
+    priority_queue<Candidate> candidates{};
+    string path{prefix};
+    path.append(labels+start->label+labelMatched, start->labelSize-labelMatched);
+    candidates.push(Candidate{start->maxWeight, start, false, path});
+    while(!candidates.empty() && result.size()<k) {
+        Candidate c = candidates.top();
+        candidates.pop();
+        if(c.word) {
+            result.push_back(make_pair(c.path, c.weight));
+        } else {
+            if(c.node->isWord()) {
+                candidates.push(Candidate{c.node->weight, c.node, true, c.path});
+            }
+            for(size_t i=c.node->firstChild; i<c.node->firstChild+c.node->childCount(); i++) {
+                const Node& child = nodes[i];
+                candidates.push(Candidate{child.maxWeight, &child, false, c.path+string(labels+child.label, child.labelSize)});
             }
         }
+    }
+}
+
+void Trie::serialize(string& buffer) const
+{
+    uint32_t header[4] = {SERIALIZATION_MAGIC, SERIALIZATION_VERSION, static_cast<uint32_t>(nodesCount), static_cast<uint32_t>(labelsSize)};
+    buffer.append(reinterpret_cast<const char*>(header), sizeof(header));
+    if(nodesCount) {
+        buffer.append(reinterpret_cast<const char*>(nodes), nodesCount*sizeof(Node));
+        buffer.append(reinterpret_cast<const char*>(firsts), nodesCount);
+        buffer.append(labels, labelsSize);
+    }
+}
+
+bool Trie::load(const char* buffer, size_t size)
+{
+    clear();
+
+    uint32_t header[4];
+    if(size<sizeof(header) || reinterpret_cast<uintptr_t>(buffer)%alignof(Node)) {
+        return false;
+    }
+    memcpy(header, buffer, sizeof(header));
+    if(header[0]!=SERIALIZATION_MAGIC
+         || header[1]!=SERIALIZATION_VERSION
+         || (size-sizeof(header))/(sizeof(Node)+1) < header[2]
+         || size-sizeof(header)-header[2]*(sizeof(Node)+1) != header[3])
+    {
         return false;
     }
+
+    const Node* n = reinterpret_cast<const Node*>(buffer+sizeof(header));
+    const uint8_t* f = reinterpret_cast<const uint8_t*>(buffer+sizeof(header)+header[2]*sizeof(Node));
+    const char* l = reinterpret_cast<const char*>(f+header[2]);
+    // corrupted buffer must not make lookups read out of it
+    for(size_t i=0; i<header[2]; i++) {
+        if(static_cast<size_t>(n[i].label)+n[i].labelSize > header[3]
+             || static_cast<size_t>(n[i].firstChild)+n[i].childCount() > header[2]
+             || (n[i].childCount() && n[i].firstChild<=i)
+             || (i && (!n[i].labelSize || f[i]!=static_cast<uint8_t>(l[n[i].label]))))
+        {
+            return false;
+        }
+    }
+
+    nodes = n;
+    nodesCount = header[2];
+    firsts = f;
+    labels = l;
+    labelsSize = header[3];
+    return true;
 }
 
 } // m8r namespace
@@ -19,52 +19,74 @@
 #ifndef M8R_TRIE_H
 #define M8R_TRIE_H
 
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace m8r {
 
 /**
- * @brief Trie.
+ * @brief Compressed radix trie w/ weighted words.
+ *
+ * Trie is stored flat: nodes are in an array (children of node are contiguous
+ * and sorted by the first byte of their edge label which is kept in a byte
+ * array i.e. child is found w/o reading other nodes) and edge labels are in
+ * a single char buffer. There is no
+ * per node allocation, a lookup touches one node per edge instead of one node
+ * per char and the trie can be serialized to a buffer which is used in place
+ * (e.g. mmap-ed file) w/o deserialization.
  *
- * This implementation has been inspired by an http://www.sourcetricks.com example.
+ * Every word has a weight and every node knows the maximum weight of words
+ * in its subtree - the best words w/ given prefix are found w/o visiting
+ * the whole subtree.
+ *
+ * Trie is built in bulk from sorted words, addWord() and deleteWord() rebuild
+ * the trie i.e. use build() to add more than a few words.
  */
 class Trie
 {
-private:
-    class Node {
-        friend class Trie;
-
-    private:
-        char mContent;
-        bool mMarker;
-        std::vector<Node*> mChildren;
-
-    public:
-        explicit Node() {
-            mContent = ' ';
-            mMarker = false;
-        }
-        ~Node() {}
-        char content() const { return mContent; }
-        void setContent(char c) { mContent = c; }
-        bool wordMarker() const { return mMarker; }
-        void setWordMarker() { mMarker = true; }
-        void appendChild(Node* child) { mChildren.push_back(child); }
-        std::vector<Node*> children() const { return mChildren; }
-
-        // IMPROVE sort children once trie filled AND use binary search here O(n) -> O(log(n))
-        Node* findChild(char c) {
-            for(Node* n:mChildren) {
-                if(n->content()==c) {
-                    return n;
-                }
-            }
-            return nullptr;
-        }
+public:
+    /**
+     * @brief Node - 20B w/ label and children stored as offsets.
+     */
+    struct Node {
+        // offset of edge label in labels
+        uint32_t label;
+        // index of the first child
+        uint32_t firstChild;
+        // weight of word ending in this node
+        uint32_t weight;
+        // maximum weight of words in subtree
+        uint32_t maxWeight;
+        uint16_t labelSize;
+        // number of children and word marker in the highest bit
+        uint16_t children;
+
+        static constexpr uint16_t WORD = 0x8000;
+
+        uint16_t childCount() const { return children&~WORD; }
+        bool isWord() const { return children&WORD; }
     };
 
-    Node* root;
+    // "MFTR" in little endian
+    static constexpr uint32_t SERIALIZATION_MAGIC = 0x5254464D;
+    static constexpr uint32_t SERIALIZATION_VERSION = 1;
+    // longer edges are split
+    static constexpr size_t MAX_LABEL_SIZE = UINT16_MAX;
+
+private:
+    // owned trie (built) or buffer (loaded)
+    std::vector<Node> nodeStorage;
+    std::vector<uint8_t> firstStorage;
+    std::string labelStorage;
+
+    const Node* nodes;
+    size_t nodesCount;
+    // the first char of node's label - children are searched w/o reading nodes and labels
+    const uint8_t* firsts;
+    const char* labels;
+    size_t labelsSize;
 
 public:
     explicit Trie();
@@ -74,14 +96,47 @@ public:
     Trie &operator=(const Trie&&) = delete;
     ~Trie();
 
-    bool empty() const { return root->children().empty(); }
-
-    void addWord(std::string s);
-    bool findWord(std::string& s) const;
-    void deleteWord(std::string s);
+    bool empty() const { return nodesCount==0; }
+    size_t getNodesCount() const { return nodesCount; }
+    size_t getMemorySize() const { return nodesCount*(sizeof(Node)+1) + labelsSize; }
+    void clear();
+
+    /**
+     * @brief Build trie from sorted unique words w/ optional weights (0 by default).
+     */
+    void build(const std::vector<std::string>& sortedWords, const std::vector<uint32_t>* weights=nullptr);
+
+    void addWord(const std::string& s, uint32_t weight=0);
+    bool findWord(const std::string& s) const;
+    void deleteWord(const std::string& s);
+
+    /**
+     * @brief Get all words in lexicographic order.
+     */
+    void getWords(std::vector<std::string>& words, std::vector<uint32_t>* weights=nullptr) const;
+
+    /**
+     * @brief Find at most k words w/ given prefix which have the highest weight.
+     *
+     * Words are ordered by weight (descending) and lexicographically.
+     */
+    void findPrefix(const std::string& prefix, size_t k, std::vector<std::pair<std::string,uint32_t>>& result) const;
+
+    /**
+     * @brief Append trie to buffer - values are stored in native byte order.
+     */
+    void serialize(std::string& buffer) const;
+    /**
+     * @brief Use serialized trie w/o copying it - buffer must be 4B aligned and it must outlive trie (or its rebuild).
+     *
+     * @return false if buffer doesn't contain valid trie (trie is empty then).
+     */
+    bool load(const char* buffer, size_t size);
 
 private:
-    void destroy(Node* n);
+    const Node* findChild(const Node& node, uint8_t c) const;
+    const Node* findNode(const std::string& s, bool prefix, size_t& labelMatched) const;
+    void collectWords(const Node& node, std::string& word, std::vector<std::string>& words, std::vector<uint32_t>* weights) const;
 };
 
 }
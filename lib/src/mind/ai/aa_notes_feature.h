@@ -128,14 +128,34 @@ public:
 //                "by-descs  : " << features[IDX_SIMILARITY_BY_DESCRIPTIONS] << std::endl
 //                ;
 #endif
+        return areNotesAssociatedMetric(
+            features[IDX_TYPE_MATCHES],
+            features[IDX_SAME_OUTLINE],
+            features[IDX_SIMILARITY_BY_TAGS],
+            features[IDX_SIMILARITY_BY_TITLES],
+            features[IDX_SIMILARITY_BY_DESCRIPTIONS],
+            features[IDX_SIMILARITY_BY_SAME_TARGETS_RELS]);
+    }
+
+    /**
+     * @brief Metric of features calculated by caller w/o feature vector (hot loops of AA).
+     */
+    static float areNotesAssociatedMetric(
+            float typeMatches,
+            float sameOutline,
+            float similarityByTags,
+            float similarityByTitles,
+            float similarityByDescriptions,
+            float similarityBySameTargetRels)
+    {
         return
             // features[IDX_HAVE_MUTUAL_REL] * 0.25 + ... temporarily added to TEXT
-            features[IDX_TYPE_MATCHES] * 0.1 +
-            features[IDX_SAME_OUTLINE] * 0.05 +
-            features[IDX_SIMILARITY_BY_TAGS] * 0.2 +
-            features[IDX_SIMILARITY_BY_TITLES] * 0.2 +
-            features[IDX_SIMILARITY_BY_DESCRIPTIONS] * (0.2+0.25) +
-            features[IDX_SIMILARITY_BY_SAME_TARGETS_RELS] * 0.1
+            typeMatches * 0.1 +
+            sameOutline * 0.05 +
+            similarityByTags * 0.2 +
+            similarityByTitles * 0.2 +
+            similarityByDescriptions * (0.2+0.25) +
+            similarityBySameTargetRels * 0.1
             ;
     }
 };
@@ -34,6 +34,9 @@ Ai::Ai(Memory& memory, Mind& mind)
     case Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS:
         aa = new AiAaWeightedFts{memory,mind};
         break;
+    case Configuration::AssociationAssessmentAlgorithm::MIN_HASH:
+        aa = new AiAaMinHash{memory,mind};
+        break;
     default:
         aa = nullptr;
     }
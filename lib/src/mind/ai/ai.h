@@ -29,6 +29,7 @@
 #include "./aa_model.h"
 #include "./ai_aa_weighted_fts.h"
 #include "./ai_aa_bow.h"
+#include "./ai_aa_min_hash.h"
 #ifdef MF_NER
     #include "./nlp/named_entity_recognition.h"
 #endif
@@ -73,7 +74,7 @@ private:
      * Associations
      */
 
-    // Associations assessment implemenations: AA @ weighted FTS, AA @ BoW
+    // Associations assessment implemenations: AA @ weighted FTS, AA @ BoW, AA @ MinHash
     AiAssociationsAssessment* aa;
 
 #ifdef MF_NER
@@ -143,6 +144,29 @@ public:
      *
      * Synchronized by caller ~ Mind.
      */
+    void forget(const Outline* outline) {
+        aa->forget(outline);
+    }
+
+    void forget(const Note* note) {
+        aa->forget(note);
+    }
+
+    /**
+     * @brief Learn created/modified N (or Ns of learned O) incrementally.
+     *
+     * Synchronized by caller ~ Mind.
+     */
+    void remember(Note* note) {
+        aa->remember(note);
+    }
+
+    void remember(Outline* outline) {
+        for(Note* note:outline->getNotes()) {
+            aa->remember(note);
+        }
+    }
+
     bool sleep() {
         return aa->sleep();
     }
@@ -73,6 +73,28 @@ public:
      */
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self) = 0;
 
+    /**
+     * @brief Outline was forgotten or replaced - drop what was calculated for its Ns.
+     *
+     * It's presumed that caller ensures there are no active Mind processes.
+     */
+    virtual void forget(const Outline* outline) { (void)outline; }
+
+    /**
+     * @brief N was created or modified (renamed, edited, retagged) - learn it incrementally.
+     *
+     * Synchronized by caller ~ Mind, implementation must finish its own running calculations first.
+     */
+    virtual void remember(Note* note) { (void)note; }
+
+    /**
+     * @brief N is going to be deleted - drop it and what was calculated for it.
+     *
+     * N must not be accessed once method returns i.e. implementation must finish its
+     * own running calculations first.
+     */
+    virtual void forget(const Note* note) { (void)note; }
+
     /**
      * @brief Clear.
      */
@@ -18,43 +18,154 @@
 */
 #include "ai_aa_bow.h"
 
+#include <cstring>
+
+#include "../../gear/file_utils.h"
+#include "../../persistence/snapshot_io.h"
+
 namespace m8r {
 
 using namespace std;
 
+namespace {
+
+/*
+ * AI model file layout (native byte order - model is a local cache):
+ *
+ *   MAGIC (8B) VERSION (u32) N IDS COUNT (u32)
+ *   LEXICON SIZE (u32) word*: word (string) frequency (i32)
+ *   ENTRIES COUNT (u32)
+ *   entry*:
+ *     O key (string) N offset in O (u32) modified (i64) revision (u32) content hash (u64)
+ *     N ID (u32)
+ *     title words count (u32) (word ID (u32) frequency (i32))*
+ *     description words count (u32) (word ID (u32) frequency (i32))*
+ *     relevant words count (u32) (word ID (u32) frequency (i32) weight (f32))*
+ *     calculated (u8) neighbors count (u32) (N ID (u32) ranking (f32))*
+ *   HASH of all above (u64)
+ */
+
+constexpr const char* AA_MODEL_MAGIC = "M8RAIAA";
+constexpr size_t AA_MODEL_MAGIC_SIZE = 8;
+// version 2: UTF-8 tokenization and stemming by language of N
+constexpr uint32_t AA_MODEL_VERSION = 3;
+
+/**
+ * @brief N stamp - N content which affects AA is hashed as modification time and revision are not updated by every change.
+ */
+struct NoteStamp {
+    int64_t modified;
+    uint32_t revision;
+    uint64_t hash;
+
+    explicit NoteStamp() : modified(0), revision(0), hash(0) {}
+    explicit NoteStamp(const Note* n)
+        : modified(n->getModified()),
+          revision(n->getRevision())
+    {
+        string content{n->getType()->getName()};
+        content += '\n';
+        content += n->getName();
+        for(const string* line:n->getDescription()) {
+            content += '\n';
+            content += *line;
+        }
+        for(const Tag* t:*n->getTags()) {
+            content += '\t';
+            content += t->getName();
+        }
+        hash = snapshotHash(content.data(), content.size());
+    }
+
+    bool operator==(const NoteStamp& s) const {
+        return modified==s.modified && revision==s.revision && hash==s.hash;
+    }
+};
+
+void putWords(string& buffer, const WordFrequencyList* words)
+{
+    snapshotPut<uint32_t>(buffer, words->size());
+    for(auto& w:words->iterable()) {
+        snapshotPut<uint32_t>(buffer, w.first);
+        snapshotPut<int32_t>(buffer, w.second);
+    }
+}
+
+/**
+ * @brief Read word vector to given list or, if there is no list, remove its words from lexicon.
+ */
+void getWords(SnapshotReader& r, Lexicon& lexicon, WordFrequencyList* words)
+{
+    for(uint32_t i=r.getCount(2*sizeof(uint32_t)); i>0; i--) {
+        Lexicon::WordId w = r.get<uint32_t>();
+        int frequency = r.get<int32_t>();
+        if(w >= lexicon.size()) {
+            r.invalidate();
+            return;
+        }
+        if(words) {
+            words->set(w, frequency);
+        } else {
+            lexicon.remove(w, frequency);
+        }
+    }
+}
+
+// insert ID to ordered posting - false if it's already there
+bool insertId(vector<size_t>& posting, size_t id)
+{
+    if(posting.empty() || posting.back()<id) {
+        posting.push_back(id);
+        return true;
+    }
+    auto i = std::lower_bound(posting.begin(), posting.end(), id);
+    if(*i == id) {
+        return false;
+    }
+    posting.insert(i, id);
+    return true;
+}
+
+void eraseId(vector<size_t>& posting, size_t id)
+{
+    auto i = std::lower_bound(posting.begin(), posting.end(), id);
+    if(i!=posting.end() && *i==id) {
+        posting.erase(i);
+    }
+}
+
+template<typename K> void eraseId(map<K,vector<size_t>>& postings, const K& key, size_t id)
+{
+    auto p = postings.find(key);
+    if(p != postings.end()) {
+        eraseId(p->second, id);
+        if(p->second.empty()) {
+            postings.erase(p);
+        }
+    }
+}
+
+} // anonymous namespace
+
 AiAaBoW::AiAaBoW(Memory& memory, Mind& mind)
     : mind(mind),
       memory(memory),
       lexicon{},
       wordBlacklist{},
-      tokenizer{lexicon,wordBlacklist}
+      tokenizer{lexicon,wordBlacklist},
+      aaDuplicateTags{false},
+      exhaustiveAa{false},
+      modelDirty{false}
 {
 }
 
 AiAaBoW::~AiAaBoW()
 {
-    // delete dead threads
-    auto zombieIterator
-        = std::remove_if(runningWorkers.begin(),
-                         runningWorkers.end(),
-                         [](const thread* t) { if(!t->joinable()) { delete t; return true; } else return false; });
-    runningWorkers.erase(zombieIterator, runningWorkers.end());
-}
-
-void AiAaBoW::addWorkerAndCleanZombies(thread* t)
-{
-    lock_guard<mutex> criticalSection{runningWorkersMutex};
-    MF_DEBUG("AA.BoW: workers+zombies " << runningWorkers.size() << endl);
-
-    // IMPROVE: if zombies is erased > future/promise is deleted as well > frontend that has future calls a method on it > crash
-    //   - temporal SOLUTION: threads are deleted on MF exit (i.e. finished threads are kept in memory for whole MF run)
-    //     (see destructor for dead threads code to move in here)
-    //   - IDEA: frontend could use a thread hook to indicate that it got future and t can be freed
+    // workers access data which are deleted below
+    waitForWorkers();
+    saveModel();
 
-    // add new one
-    runningWorkers.push_back(t);
-
-    MF_DEBUG("AA.BoW: workers " << runningWorkers.size() << endl);
+    clearTitles();
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
@@ -63,17 +174,13 @@ shared_future<bool> AiAaBoW::dream() {
         MF_DEBUG("AA.BoW: ASYNC dream..." << endl);
         mind.incActiveProcesses();
 
-        // packaged task is parametrized by function/method signature (not return type)
-        std::packaged_task<bool (AiAaBoW*,thread*)> learnMemoryTask([](AiAaBoW* a,thread* t) { return a->learnMemorySync(t); });
-        future<bool> result = learnMemoryTask.get_future(); // move
-        thread* t = new thread{};
-        *t = thread(std::move(learnMemoryTask), this, t);
-        addWorkerAndCleanZombies(t);
-
-        return shared_future<bool>(std::move(result));
+        // learning is not keyed i.e. it's never cancelled
+        return workers.submit(nullptr, [this]() { return learnMemorySync(); });
     } else {
         MF_DEBUG("AA.BoW: SYNC dream..." << endl);
         promise<bool> p{};
+        // learning decrements active processes regardless whether it's sync or async
+        mind.incActiveProcesses();
         bool status = learnMemorySync();
         p.set_value(status);
 
@@ -83,10 +190,19 @@ shared_future<bool> AiAaBoW::dream() {
     }
 }
 
-bool AiAaBoW::learnMemorySync(thread* t)
+bool AiAaBoW::learnMemorySync()
 {
+    if(memory.isSnapshot() && restoreModelSync()) {
+        mind.persistMindState(Configuration::MindState::THINKING);
+        mind.decActiveProcesses();
+
+        MF_DEBUG("AA.BoW: memory RESTORED from AI model!" << endl);
+        return true;
+    }
+
     MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
     notes.clear();
+    freeIds.clear();
     memory.getAllNotes(notes);
     // let N know it's indexed in AI
     for(size_t i=0; i<notes.size(); i++) notes[i]->setAiAaMatrixIndex(i);
@@ -94,39 +210,45 @@ bool AiAaBoW::learnMemorySync(thread* t)
     // build lexicon and BoW
     lexicon.clear();
     bow.clear();
-    for(Note* n:notes) {
-        NoteCharProvider chars{n};
-        WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
-        tokenizer.tokenize(chars, *wfl);
-        bow.add(n, wfl);
+    clearTitles();
+    descriptions.clear();
+    relevantWeights.clear();
+    titles.resize(notes.size());
+    descriptions.resize(notes.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        tokenizeNote(i);
     }
     // prepare DATA to quickly create association assessment features
     lexicon.recalculateWeights();
+    relevantWeights = lexicon.getWeights();
     bow.reorderDocVectorsByWeight();
+    // sparse vectors of relevant words w/ the highest weight are built once (not for every AA ranking)
+    for(WordFrequencyList* d:descriptions) {
+        d->buildRelevantWords(AA_WORD_RELEVANCY_THRESHOLD);
+    }
+    buildAaPostings();
 
 #ifdef DO_MF_DEBUG
     lexicon.print();
     bow.print();
+    MF_DEBUG("AA.BoW: stem cache " << tokenizer.getStemCache().size() << " words, hit rate "
+             << tokenizer.getStemCache().getHitRate()*100. << "% of " << tokenizer.getStemCache().getLookups()
+             << " lookups, " << tokenizer.getStemCache().getEvictions() << " evictions" << endl);
 #endif
 
     // AA to be built incrementally - just initialize it
-    if(notes.size() != aaMatrix.size()) {
-        aaMatrix.clear();
-        aaMatrix.resize(notes.size());
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            aaMatrix[i].resize(aaMatrix.size(),(float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    } else {
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            std::fill(aaMatrix[i].begin(), aaMatrix[i].end(), (float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    }
+    aaNeighbors.clear();
+    aaNeighbors.resize(notes.size());
+    aaCalculated.assign(notes.size(), false);
+
+    // model w/o AA neighbors saves tokenization on the next start
+    modelDirty = true;
+    saveModel();
 
     // NN to be trained on demand - just initialize it
 
     mind.persistMindState(Configuration::MindState::THINKING);
     mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
 
     MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
     return true;
@@ -134,184 +256,738 @@ bool AiAaBoW::learnMemorySync(thread* t)
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations) {
-    auto cachedLeaderboard = leaderboardCache.find(note);
-    if(cachedLeaderboard != leaderboardCache.end()) {
-        MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
-        // copy leaderboard to ENSURE it's validity even if Mind/AI will be cleared/asleep/...
-        for(auto p:cachedLeaderboard->second) {
-            associations.push_back(p);
-        }
-        // indicate that it's immediately available
-        promise<bool> p{};
-        p.set_value(true);
-        return shared_future<bool>(p.get_future());
-    } else {        
-        MF_DEBUG("AA.BoW: ASYNC leaderboard calculation for '" << note->getName() << "'" << endl);
-        if(leaderboardWip.find(note) != leaderboardWip.end()) {
-            // calculation WIP & future OWNER will update what needs to be updated -> intentionally NOT sharing futures
+    {
+        lock_guard<mutex> criticalSection{leaderboardMutex};
+        auto cachedLeaderboard = leaderboardCache.find(note);
+        if(cachedLeaderboard != leaderboardCache.end()) {
+            MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
+            // copy leaderboard to ENSURE it's validity even if Mind/AI will be cleared/asleep/...
+            for(auto p:cachedLeaderboard->second) {
+                associations.push_back(p);
+            }
+            // indicate that it's immediately available
             promise<bool> p{};
-            p.set_value(false);
-            MF_DEBUG("AA.BoW: leaderboard WIP for '" << note->getName() << "'" << endl);
-            return p.get_future(); // move
+            p.set_value(true);
+            return shared_future<bool>(p.get_future());
+        }
+    }
+
+    MF_DEBUG("AA.BoW: ASYNC leaderboard calculation for '" << note->getName() << "'" << endl);
+    modelDirty = true;
+    // user navigated away from Ns whose leaderboards are not being calculated yet
+    workers.cancel(note);
+    // request for N which is queued or calculated shares its future
+    return workers.submit(note, [this,note]() {
+        mind.incActiveProcesses();
+        return calculateLeaderboardSync(note);
+    });
+}
+
+void AiAaBoW::forget(const Outline* outline)
+{
+    for(const Note* n:outline->getNotes()) {
+        forget(n);
+    }
+}
+
+void AiAaBoW::forget(const Note* note)
+{
+    waitForWorkers();
+
+    const int i = note->getAiAaMatrixIndex();
+    if(i == AA_NOT_SET || static_cast<size_t>(i) >= notes.size() || notes[i] != note) {
+        return;
+    }
+
+    size_t y = i;
+    invalidateAa(y, false);
+    unlearnNote(y);
+    notes[y] = nullptr;
+    freeIds.push_back(y);
+    modelDirty = true;
+}
+
+void AiAaBoW::remember(Note* note)
+{
+    waitForWorkers();
+    rememberSync(note);
+}
+
+void AiAaBoW::rememberSync(Note* note)
+{
+    size_t y;
+    const int i = note->getAiAaMatrixIndex();
+    if(i != AA_NOT_SET && static_cast<size_t>(i) < notes.size() && notes[i] == note) {
+        // modified N
+        y = i;
+        unlearnNote(y);
+    } else if(freeIds.size()) {
+        y = freeIds.back();
+        freeIds.pop_back();
+        notes[y] = note;
+    } else {
+        y = notes.size();
+        notes.push_back(note);
+        titles.push_back(nullptr);
+        descriptions.push_back(nullptr);
+        aaFeatures.emplace_back();
+        aaNeighbors.emplace_back();
+        aaCalculated.push_back(false);
+    }
+    note->setAiAaMatrixIndex(y);
+
+    tokenizeNote(y);
+    descriptions[y]->sort();
+    descriptions[y]->buildRelevantWords(AA_WORD_RELEVANCY_THRESHOLD);
+    descriptions[y]->freezeWeights(relevantWeights);
+    buildAaFeatures(y);
+    addAaPostings(y);
+    invalidateAa(y, true);
+    modelDirty = true;
+}
+
+bool AiAaBoW::restoreModelSync()
+{
+    const string modelPath{Configuration::getInstance().getAiModelPath()};
+    MemoryMappedFile file{&modelPath};
+    if(!file.isMapped() || file.getSize() < AA_MODEL_MAGIC_SIZE+sizeof(uint64_t)) {
+        return false;
+    }
+    const size_t size = file.getSize()-sizeof(uint64_t);
+    uint64_t hash;
+    memcpy(&hash, file.getData()+size, sizeof(hash));
+    if(hash != snapshotHash(file.getData(), size)) {
+        MF_DEBUG("AA.BoW: AI model " << modelPath << " is corrupted > IGNORING it" << endl);
+        return false;
+    }
+
+    SnapshotReader r{file.getData(), size};
+    const char* magic = r.skip(AA_MODEL_MAGIC_SIZE);
+    if(!magic || memcmp(magic, AA_MODEL_MAGIC, AA_MODEL_MAGIC_SIZE) || r.get<uint32_t>()!=AA_MODEL_VERSION) {
+        return false;
+    }
+    const size_t ids = r.get<uint32_t>();
+
+    lexicon.clear();
+    bow.clear();
+    clearTitles();
+    descriptions.clear();
+    relevantWeights.clear();
+    freeIds.clear();
+    notes.assign(ids, nullptr);
+    titles.assign(ids, nullptr);
+    descriptions.assign(ids, nullptr);
+    aaNeighbors.assign(ids, vector<pair<size_t,float>>{});
+    aaCalculated.assign(ids, false);
+    {
+        lock_guard<mutex> criticalSection{leaderboardMutex};
+        leaderboardCache.clear();
+    }
+
+    string s{};
+    for(uint32_t i=r.getCount(2*sizeof(uint32_t)); i>0; i--) {
+        r.getString(s);
+        int frequency = r.get<int32_t>();
+        if(lexicon.add(s, frequency) != lexicon.size()-1) {
+            // duplicate word
+            return false;
+        }
+    }
+
+    // N is restored if it's at the same position in the same O and its stamp matches,
+    // words of other (stale) Ns are removed from lexicon
+    vector<char> used(ids, false);
+    size_t stale = 0;
+    vector<WordFrequencyList::RelevantWord> relevantWords{};
+    for(uint32_t e=r.getCount(sizeof(uint32_t)); e>0 && r.isValid(); e--) {
+        r.getString(s);
+        const uint32_t offset = r.get<uint32_t>();
+        NoteStamp stamp{};
+        stamp.modified = r.get<int64_t>();
+        stamp.revision = r.get<uint32_t>();
+        stamp.hash = r.get<uint64_t>();
+        const size_t y = r.get<uint32_t>();
+        if(!r.isValid() || y >= ids || used[y]) {
+            return false;
+        }
+        used[y] = true;
+
+        Outline* o = memory.getOutline(s);
+        Note* n = o && offset < o->getNotes().size() ? o->getNotes()[offset] : nullptr;
+        if(n && !(NoteStamp{n} == stamp)) {
+            n = nullptr;
+        }
+
+        WordFrequencyList* title = n?new WordFrequencyList{&lexicon}:nullptr;
+        getWords(r, lexicon, title);
+        WordFrequencyList* description = n?new WordFrequencyList{&lexicon}:nullptr;
+        getWords(r, lexicon, description);
+        relevantWords.clear();
+        for(uint32_t i=r.getCount(3*sizeof(uint32_t)); i>0; i--) {
+            WordFrequencyList::RelevantWord w{};
+            w.word = r.get<uint32_t>();
+            w.frequency = r.get<int32_t>();
+            w.weight = r.get<float>();
+            if(w.word >= lexicon.size()) {
+                r.invalidate();
+            }
+            relevantWords.push_back(w);
+        }
+        const bool calculated = r.get<uint8_t>();
+        vector<pair<size_t,float>> neighbors{};
+        for(uint32_t i=r.getCount(2*sizeof(uint32_t)); i>0; i--) {
+            const size_t x = r.get<uint32_t>();
+            const float aa = r.get<float>();
+            if(x >= ids) {
+                r.invalidate();
+            }
+            neighbors.push_back(std::make_pair(x, aa));
+        }
+
+        if(n) {
+            // description is owned by BoW
+            notes[y] = n;
+            n->setAiAaMatrixIndex(y);
+            titles[y] = title;
+            description->setRelevantWords(relevantWords);
+            description->freezeWeights(relevantWeights);
+            descriptions[y] = description;
+            bow.add(n, description);
+            aaNeighbors[y].swap(neighbors);
+            aaCalculated[y] = calculated;
         } else {
-            mind.incActiveProcesses();
-            MF_DEBUG("AA.BoW: starting THREAD for '" << note->getName() << "'" << endl);
+            stale++;
+        }
+    }
+    if(!r.isValid() || !r.isEnd()) {
+        return false;
+    }
 
-            // packaged task is parametrized by function/method signature (not return type)
-            packaged_task<bool (AiAaBoW*,const Note*,thread*)> calculateLeaderboardTask([](AiAaBoW* a, const Note* n, thread* t) { return a->calculateLeaderboardSync(n,t); });
-            future<bool> result = calculateLeaderboardTask.get_future(); // move
-            thread* t = new thread{};
-            *t = thread(std::move(calculateLeaderboardTask), this, note, t); // run task w/ handle to self thread
-            addWorkerAndCleanZombies(t);
+    vector<Note*> allNotes{};
+    memory.getAllNotes(allNotes);
+    const size_t restored = ids-std::count(notes.begin(), notes.end(), nullptr);
+    MF_DEBUG("AA.BoW: " << restored << " Ns restored from AI model, " << stale << " stale, " << allNotes.size() << " in memory" << endl);
+    if(!restored || restored < AA_MODEL_RESTORE_THRESHOLD*allNotes.size()) {
+        return false;
+    }
+    buildAaPostings();
+    // IDs of stale Ns are reused by new Ns - the lowest IDs first
+    for(size_t y=ids; y>0; y--) {
+        if(!notes[y-1]) {
+            freeIds.push_back(y-1);
+        }
+    }
+    // rows w/ stale Ns must be calculated again
+    for(size_t x=0; x<ids; x++) {
+        bool valid = notes[x] != nullptr;
+        for(auto& neighbor:aaNeighbors[x]) {
+            valid = valid && notes[neighbor.first];
+        }
+        if(!valid) {
+            aaNeighbors[x].clear();
+            aaCalculated[x] = false;
+        }
+    }
 
-            return shared_future<bool>(std::move(result));
+    // created and modified Ns are learned as if they were remembered
+    modelDirty = stale > 0;
+    for(Note* n:allNotes) {
+        const int i = n->getAiAaMatrixIndex();
+        if(i == AA_NOT_SET || static_cast<size_t>(i) >= notes.size() || notes[i] != n) {
+            rememberSync(n);
         }
     }
+
+    return true;
 }
 
-// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
-// to fill the beginning of the line.
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
+bool AiAaBoW::saveModel()
+{
+    if(!modelDirty || !memory.isSnapshot() || notes.empty()) {
+        return false;
+    }
+
+    string buffer{};
+    buffer.append(AA_MODEL_MAGIC, AA_MODEL_MAGIC_SIZE);
+    snapshotPut<uint32_t>(buffer, AA_MODEL_VERSION);
+    snapshotPut<uint32_t>(buffer, notes.size());
+    snapshotPut<uint32_t>(buffer, lexicon.size());
+    for(Lexicon::WordId w=0; w<lexicon.size(); w++) {
+        snapshotPutString(buffer, lexicon.getWord(w));
+        snapshotPut<int32_t>(buffer, lexicon.getFrequency(w));
+    }
+
+    // Ns are keyed by O and position in O as they have no persistent identity
+    size_t countOffset = buffer.size();
+    snapshotPut<uint32_t>(buffer, 0);
+    uint32_t count = 0;
+    for(const Outline* o:memory.getOutlines()) {
+        const vector<Note*>& outlineNotes = o->getNotes();
+        for(size_t offset=0; offset<outlineNotes.size(); offset++) {
+            const Note* n = outlineNotes[offset];
+            const int i = n->getAiAaMatrixIndex();
+            if(i == AA_NOT_SET || static_cast<size_t>(i) >= notes.size() || notes[i] != n) {
+                continue;
+            }
+            const size_t y = i;
+
+            snapshotPutString(buffer, o->getKey());
+            snapshotPut<uint32_t>(buffer, offset);
+            NoteStamp stamp{n};
+            snapshotPut<int64_t>(buffer, stamp.modified);
+            snapshotPut<uint32_t>(buffer, stamp.revision);
+            snapshotPut<uint64_t>(buffer, stamp.hash);
+            snapshotPut<uint32_t>(buffer, y);
+            putWords(buffer, titles[y]);
+            putWords(buffer, descriptions[y]);
+            snapshotPut<uint32_t>(buffer, descriptions[y]->getRelevantWords().size());
+            for(auto& w:descriptions[y]->getRelevantWords()) {
+                snapshotPut<uint32_t>(buffer, w.word);
+                snapshotPut<int32_t>(buffer, w.frequency);
+                snapshotPut<float>(buffer, w.weight);
+            }
+            snapshotPut<uint8_t>(buffer, aaCalculated[y]?1:0);
+            snapshotPut<uint32_t>(buffer, aaNeighbors[y].size());
+            for(auto& neighbor:aaNeighbors[y]) {
+                snapshotPut<uint32_t>(buffer, neighbor.first);
+                snapshotPut<float>(buffer, neighbor.second);
+            }
+            count++;
+        }
+    }
+    memcpy(&buffer[countOffset], &count, sizeof(count));
+    snapshotPut<uint64_t>(buffer, snapshotHash(buffer.data(), buffer.size()));
+
+    const string modelPath{Configuration::getInstance().getAiModelPath()};
+    if(snapshotWrite(modelPath, buffer)) {
+        MF_DEBUG("AA.BoW: AI model w/ " << count << " Ns saved to " << modelPath << endl);
+        modelDirty = false;
+        return true;
+    } else {
+        MF_DEBUG("AA.BoW: unable to save AI model " << modelPath << endl);
+        return false;
+    }
+}
+
+void AiAaBoW::tokenizeNote(size_t y)
+{
+    Note* n = notes[y];
+    NoteChunkProvider chars{n};
+    WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+    // N is stemmed by stemmer of its language so that mixed language repositories get compact lexicon
+    tokenizer.tokenizeChunks(chars, *wfl, true, true, true, tokenizer.detectLanguage(chars));
+    bow.add(n, wfl);
+    descriptions[y] = wfl;
+
+    // title is tokenized once (not for every AA ranking) so that lexicon is not modified by AA calculation
+    StringChunkProvider titleChars{n->getName()};
+    WordFrequencyList* title = new WordFrequencyList{&lexicon};
+    tokenizer.tokenizeChunks(titleChars, *title, false, true, false);
+    titles[y] = title;
+}
+
+void AiAaBoW::unlearnNote(size_t y)
+{
+    removeAaPostings(y);
+
+    for(auto& w:descriptions[y]->iterable()) {
+        lexicon.remove(w.first, w.second);
+    }
+    for(auto& w:titles[y]->iterable()) {
+        lexicon.remove(w.first, w.second);
+    }
+    // description is owned by BoW
+    bow.remove(notes[y]);
+    descriptions[y] = nullptr;
+    delete titles[y];
+    titles[y] = nullptr;
+}
+
+void AiAaBoW::invalidateAa(size_t y, bool reassess)
+{
+    auto hasNeighbor = [y](const vector<pair<size_t,float>>& neighbors) {
+        return std::find_if(
+            neighbors.begin(),
+            neighbors.end(),
+            [y](const pair<size_t,float>& n) { return n.first == y; }) != neighbors.end();
+    };
+
+    for(size_t x=0; x<notes.size(); x++) {
+        if(x==y || !notes[x] || !aaCalculated[x]) {
+            continue;
+        }
+        if(hasNeighbor(aaNeighbors[x])) {
+            // N's ranking is changed (or N is gone) and N cannot be replaced w/o calculation of the whole row
+            aaNeighbors[x].clear();
+            aaCalculated[x] = false;
+            leaderboardCache.erase(notes[x]);
+        } else if(reassess) {
+            offerAaNeighbor(aaNeighbors[x], y, calculateAa(x, y));
+            if(hasNeighbor(aaNeighbors[x])) {
+                leaderboardCache.erase(notes[x]);
+            }
+        }
+    }
+
+    aaNeighbors[y].clear();
+    aaCalculated[y] = false;
+    leaderboardCache.erase(notes[y]);
+}
+
+void AiAaBoW::waitForWorkers()
+{
+    // running leaderboard calculations are short - they are finished rather than interrupted
+    workers.cancel();
+    workers.wait();
+}
+
+void AiAaBoW::offerAaNeighbor(vector<pair<size_t,float>>& neighbors, size_t id, float aa)
+{
+    // neighbors are totally ordered (ranking, then lower ID) so that result doesn't depend on offers order
+    if(neighbors.size() == static_cast<size_t>(AA_LEADERBOARD_SIZE)
+         && (aa < neighbors.back().second || (aa == neighbors.back().second && id > neighbors.back().first)))
+    {
+        return;
+    }
+
+    auto target = std::find_if(
+        neighbors.begin(),
+        neighbors.end(),
+        [id,aa](const pair<size_t,float>& n) { return aa > n.second || (aa == n.second && id < n.first); });
+    neighbors.insert(target, std::make_pair(id,aa));
+    if(neighbors.size() > static_cast<size_t>(AA_LEADERBOARD_SIZE)) {
+        neighbors.pop_back();
+    }
+}
+
+void AiAaBoW::buildAaPostings()
+{
+    clearAaPostings();
+    aaFeatures.resize(notes.size());
+    // Ns are visited in ID order i.e. IDs are appended to postings
+    for(size_t i=0; i<notes.size(); i++) {
+        if(notes[i]) {
+            buildAaFeatures(i);
+            addAaPostings(i);
+        }
+    }
+}
+
+void AiAaBoW::buildAaFeatures(size_t y)
+{
+    AaFeatures& f = aaFeatures[y];
+    f.type = notes[y]->getType();
+    f.outline = notes[y]->getOutline();
+
+    f.titleWords.clear();
+    for(auto& w:titles[y]->iterable()) {
+        f.titleWords.push_back(w.first);
+    }
+
+    f.tags.clear();
+    f.tagIds.clear();
+    f.tagsMask = 0;
+    for(const Tag* t:*notes[y]->getTags()) {
+        auto id = tagIds.insert(std::make_pair(t, static_cast<uint32_t>(tagIds.size()))).first->second;
+        if(std::find(f.tagIds.begin(), f.tagIds.end(), id) == f.tagIds.end()) {
+            f.tags.push_back(t);
+        }
+        f.tagIds.push_back(id);
+        f.tagsMask |= 1ull << (id%64);
+    }
+    std::sort(f.tagIds.begin(), f.tagIds.end());
+
+    f.descriptionWords = &descriptions[y]->getRelevantWords();
+}
+
+void AiAaBoW::addAaPostings(size_t y)
+{
+    if(descriptionPostings.size() < lexicon.size()) {
+        descriptionPostings.resize(lexicon.size());
+        titlePostings.resize(lexicon.size());
+    }
+
+    for(auto& w:descriptions[y]->getRelevantWords()) {
+        insertId(descriptionPostings[w.word], y);
+    }
+    for(auto& w:titles[y]->iterable()) {
+        insertId(titlePostings[w.first], y);
+    }
+    const AaFeatures& f = aaFeatures[y];
+    for(const Tag* t:f.tags) {
+        insertId(tagPostings[t], y);
+    }
+    if(f.tags.size() < f.tagIds.size()) {
+        aaDuplicateTags = true;
+    }
+    insertId(outlinePostings[f.outline], y);
+    insertId(aaGroups[std::make_pair(f.type, f.tagIds.empty())], y);
+}
+
+void AiAaBoW::removeAaPostings(size_t y)
+{
+    for(auto& w:descriptions[y]->getRelevantWords()) {
+        eraseId(descriptionPostings[w.word], y);
+    }
+    for(auto& w:titles[y]->iterable()) {
+        eraseId(titlePostings[w.first], y);
+    }
+    const AaFeatures& f = aaFeatures[y];
+    for(const Tag* t:f.tags) {
+        eraseId(tagPostings, t, y);
+    }
+    eraseId(outlinePostings, f.outline, y);
+    eraseId(aaGroups, std::make_pair(f.type, f.tagIds.empty()), y);
+}
+
+void AiAaBoW::clearAaPostings()
+{
+    descriptionPostings.clear();
+    titlePostings.clear();
+    tagPostings.clear();
+    outlinePostings.clear();
+    aaGroups.clear();
+    aaFeatures.clear();
+    tagIds.clear();
+    aaDuplicateTags = false;
+}
+
+void AiAaBoW::collectAaPostings(size_t y, vector<AaPosting>& postings) const
+{
+    // the maximum similarity of a shared feature is relative to N's features as union of features contains them all
+    const vector<WordFrequencyList::RelevantWord>& words = descriptions[y]->getRelevantWords();
+    float wordsWeight = 0;
+    for(auto& w:words) {
+        wordsWeight += w.weight;
+    }
+    for(auto& w:words) {
+        postings.push_back(AaPosting{&descriptionPostings[w.word], w.weight/wordsWeight, 0, 0, false});
+    }
+    for(auto& w:titles[y]->iterable()) {
+        postings.push_back(AaPosting{&titlePostings[w.first], 0, 1.f/titles[y]->size(), 0, false});
+    }
+    const vector<const Tag*>& tags = aaFeatures[y].tags;
+    for(const Tag* t:tags) {
+        auto p = tagPostings.find(t);
+        if(p != tagPostings.end()) {
+            postings.push_back(AaPosting{&p->second, 0, 0, aaDuplicateTags?1.f:1.f/tags.size(), false});
+        }
+    }
+    auto p = outlinePostings.find(aaFeatures[y].outline);
+    if(p != outlinePostings.end()) {
+        postings.push_back(AaPosting{&p->second, 0, 0, 0, true});
+    }
+
+    // the most selective postings first
+    std::sort(
+        postings.begin(),
+        postings.end(),
+        [](const AaPosting& a, const AaPosting& b) { return a.notes->size() < b.notes->size(); });
+}
+
+float AiAaBoW::calculateAaBound(size_t y, vector<AaPosting>::const_iterator begin, vector<AaPosting>::const_iterator end) const
+{
+    float descriptionsBound=0, titlesBound=0, tagsBound=0;
+    bool outlineBound = false;
+    for(auto p=begin; p!=end; ++p) {
+        descriptionsBound += p->descriptions;
+        titlesBound += p->titles;
+        tagsBound += p->tags;
+        outlineBound = outlineBound || p->outline;
+    }
+
+    return AssociationAssessmentNotesFeature::areNotesAssociatedMetric(
+        1.,
+        outlineBound?1.:0.,
+        // N w/o tags is similar to other Ns w/o tags
+        aaFeatures[y].tagIds.empty()?1.:std::min(1.f,tagsBound),
+        std::min(1.f,titlesBound),
+        std::min(1.f,descriptionsBound),
+        0.);
+}
+
+// Neighbors of Ns w/ lower index cannot be reused as they keep the best Ns only - row is calculated
+// from scratch.
+// This is a method called from AI ~ AI state/async/critical sections handled by caller.
 void AiAaBoW::calculateAaRow(size_t y)
 {
     MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
-    // calculate row and column that cross diagonal on [y][y]
 
-    // check diagonal to find out whether the cross has been already calculated
-    if(aaMatrix[y][y] == 1.) {
+    // forgotten N has no row
+    if(aaCalculated[y] || !notes[y]) {
         return;
     }
 
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-
     notes[y]->setAiAaMatrixIndex(y);
-    for(size_t x=0; x<aaMatrix.size(); x++) {
-        // set diagonal at the end
-        if(x!=y) {
-            // skip if value has been already calculated
-            if(aaMatrix[y][x] == AA_NOT_SET) {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    vector<pair<size_t,float>>& neighbors = aaNeighbors[y];
+    neighbors.clear();
+    if(exhaustiveAa) {
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x!=y && notes[x]) {
+                offerAaNeighbor(neighbors, x, calculateAa(x, y));
+            }
+        }
+    } else {
+        vector<AaPosting> postings{};
+        collectAaPostings(y, postings);
+
+        // ordered IDs of ranked candidates
+        vector<size_t> candidates{};
+        size_t merged;
+        for(merged=0; merged<postings.size(); merged++) {
+            // margin covers rounding of bound vs. ranking calculation
+            if(neighbors.size() == static_cast<size_t>(AA_LEADERBOARD_SIZE)
+                 && calculateAaBound(y, postings.begin()+merged, postings.end())+0.0001 < neighbors.back().second)
+            {
+                break;
+            }
+
+            size_t ranked = candidates.size();
+            for(size_t x:*postings[merged].notes) {
+                if(x!=y && !std::binary_search(candidates.begin(), candidates.begin()+ranked, x)) {
+                    offerAaNeighbor(neighbors, x, calculateAa(x, y));
+                    candidates.push_back(x);
+                }
+            }
+            std::inplace_merge(candidates.begin(), candidates.begin()+ranked, candidates.end());
+        }
+        MF_DEBUG("AA.BoW: " << candidates.size() << " AA candidates from " << merged << "/" << postings.size()
+                 << " postings of " << notes.size() << " Ns" << endl);
+
+        // remaining Ns of the group have the same ranking i.e. Ns w/ the lowest IDs win
+        for(auto& group:aaGroups) {
+            size_t offered = 0;
+            for(size_t x:group.second) {
+                if(offered == static_cast<size_t>(AA_LEADERBOARD_SIZE)) {
+                    break;
+                }
+                if(x!=y && !std::binary_search(candidates.begin(), candidates.end(), x)) {
+                    offerAaNeighbor(neighbors, x, calculateAa(x, y));
+                    offered++;
+                }
             }
         }
     }
 
-    // set diagonal at the end to indicate calculation is done (consider reentrancy)
-    aaMatrix[y][y] = 1.;
+    // set flag at the end to indicate calculation is done (consider reentrancy)
+    aaCalculated[y] = true;
 
-#ifdef DO_MF_DEBUG
     MF_DEBUG("AA.BoW: AA row calculated!" << endl);
-    //printAa();
-    //assertAaSymmetry();
-#endif
 }
 
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::precalculateAa()
+float AiAaBoW::calculateAa(size_t x, size_t y) const
 {
-#ifdef DO_MF_DEBUG
-    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.+notes.size()/2.);
-    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
-    float c=0;
-    float p;
-#endif
+    const AaFeatures& f1 = aaFeatures[x];
+    const AaFeatures& f2 = aaFeatures[y];
+
+    return AssociationAssessmentNotesFeature::areNotesAssociatedMetric(
+        f1.type==f2.type?1.:0.,
+        f1.outline==f2.outline?1.:0.,
+        calculateSimilarityByTags(f1, f2),
+        calculateSimilarityByTitles(f1.titleWords, f2.titleWords),
+        calculateSimilarityByWords(*f1.descriptionWords, *f2.descriptionWords),
+        0.); // TODO mutual rels and same target rels
+}
 
-    // calculate FULL matrix of Ns associativity assessment for every N1 and N2 tuple
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-    for(size_t y=0; y<aaMatrix.size(); y++) {
-        notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
+void AiAaBoW::precalculateAaTile(size_t y0, size_t x0, vector<vector<pair<size_t,float>>>& neighbors)
+{
+    const size_t yEnd = std::min(y0+AA_TILE_SIZE, notes.size());
+    const size_t xEnd = std::min(x0+AA_TILE_SIZE, notes.size());
+    for(size_t y=y0; y<yEnd; y++) {
+        if(!notes[y]) {
+            continue;
+        }
+        // calculate only values ABOVE diagonal
+        for(size_t x=std::max(x0, y+1); x<xEnd; x++) {
+            if(!notes[x]) {
+                continue;
+            }
+            float aa = calculateAa(x, y);
+            // AA ranking is symmetric - offer it to both Ns
+            offerAaNeighbor(neighbors[x], y, aa);
+            offerAaNeighbor(neighbors[y], x, aa);
+        }
+    }
+}
 
-#ifdef DO_MF_DEBUG
-        p = c/(UNIQUE_AA_CELLS/100.);
-        MF_DEBUG("    " << (int)p << "% AA matrix rankings for '" << notes[y]->getName() << "'" << endl);
-#endif
+// This is a method called from AI ~ AI state/async/critical sections handled by caller.
+void AiAaBoW::precalculateAa(unsigned threads)
+{
+    if(!threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
 
-        // calculate only values ABOVE diagonal i.e. initialize x=y
-        for(size_t x=y; x<aaMatrix.size(); x++) {
-#ifdef DO_MF_DEBUG
-            c++;
-#endif
+    // tiles above (and on) diagonal
+    vector<pair<size_t,size_t>> tiles{};
+    for(size_t y=0; y<notes.size(); y+=AA_TILE_SIZE) {
+        for(size_t x=y; x<notes.size(); x+=AA_TILE_SIZE) {
+            tiles.push_back(std::make_pair(y,x));
+        }
+    }
+    if(threads > tiles.size()) {
+        threads = std::max<size_t>(1, tiles.size());
+    }
+    MF_DEBUG("  Building AA neighbors from " << (notes.size()*notes.size()/2.-notes.size()/2.) << " UNIQUE rankings in "
+             << tiles.size() << " tiles using " << threads << " thread(s)..." << endl);
+
+    // calculate Ns associativity assessment for every N1 and N2 tuple - every worker has own neighbors
+    vector<vector<vector<pair<size_t,float>>>> workerNeighbors(threads, vector<vector<pair<size_t,float>>>(notes.size()));
+    atomic<size_t> nextTile{0};
+    auto worker = [this,&tiles,&nextTile](vector<vector<pair<size_t,float>>>* neighbors) {
+        for(size_t t=nextTile++; t<tiles.size(); t=nextTile++) {
+            precalculateAaTile(tiles[t].first, tiles[t].second, *neighbors);
+        }
+    };
+    vector<thread> workers{};
+    for(unsigned i=1; i<threads; i++) {
+        workers.push_back(thread{worker, &workerNeighbors[i]});
+    }
+    // calling thread works too
+    worker(&workerNeighbors[0]);
+    for(thread& w:workers) {
+        w.join();
+    }
 
-            if(x==y) {
-                aaMatrix[x][y] = 1.;
-            } else {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    // merge neighbors of workers
+    for(size_t i=0; i<notes.size(); i++) {
+        vector<pair<size_t,float>>& neighbors = aaNeighbors[i];
+        neighbors.swap(workerNeighbors[0][i]);
+        for(unsigned w=1; w<threads; w++) {
+            for(auto& neighbor:workerNeighbors[w][i]) {
+                offerAaNeighbor(neighbors, neighbor.first, neighbor.second);
             }
+            vector<pair<size_t,float>>{}.swap(workerNeighbors[w][i]);
         }
+        aaCalculated[i] = true;
     }
+    modelDirty = true;
 
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("  AA matrix built!" << endl);
-    //printAa();
-    assertAaSymmetry();
-#endif
+    MF_DEBUG("  AA neighbors built!" << endl);
 }
 
-float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
+float AiAaBoW::calculateSimilarityByTitles(const vector<Lexicon::WordId>& v1, const vector<Lexicon::WordId>& v2)
 {
-    StringCharProvider cp1{t1};
-    WordFrequencyList v1{&lexicon};
-    tokenizer.tokenize(cp1, v1, false, true, false);
-    StringCharProvider cp2{t2};
-    WordFrequencyList v2{&lexicon};
-    tokenizer.tokenize(cp2, v2, false, true, false);
-
     // calculate overlap
     if(!v1.size() || !v2.size()) {
         return 0.;
     } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
+        // words are ordered by ID i.e. overlap is calculated by merge w/o lookups
         float iWeight=0, uWeight=0;
-
-        for(auto& e:v1.iterable()) {
+        auto w1 = v1.begin();
+        auto w2 = v2.begin();
+        while(w1 != v1.end() && w2 != v2.end()) {
             uWeight += 1;
-            if(v2.contains(e.first)) {
+            if(*w1 < *w2) {
+                ++w1;
+            } else if(*w2 < *w1) {
+                ++w2;
+            } else {
                 iWeight += 1;
-                intersection.add(e.first);
-            }
-        }
-
-        for(auto& e:v2.iterable()) {
-            if(!intersection.contains(e.first)) {
-                uWeight += 1;
-                if(v1.contains(e.first)) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
-                }
+                ++w1;
+                ++w2;
             }
         }
+        uWeight += (v1.end()-w1) + (v2.end()-w2);
 
         //MF_DEBUG("  titleSimilarity = "<<iWeight<<" / "<<uWeight << endl);
         // intersection % of union
@@ -320,37 +996,36 @@ float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
 }
 
 // algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
-float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vector<const Tag*>* t2)
+float AiAaBoW::calculateSimilarityByTags(const AaFeatures& f1, const AaFeatures& f2)
 {
-    if(!t1->size()) {
-        if(!t2->size()) {
+    const vector<uint32_t>& t1 = f1.tagIds;
+    const vector<uint32_t>& t2 = f2.tagIds;
+    if(!t1.size()) {
+        if(!t2.size()) {
             return 1.;
         } else {
             return 0.;
         }
+    } else if(!(f1.tagsMask & f2.tagsMask)) {
+        // no shared tag
+        return 0.;
     } else {
-        // direct access for efficiency
-        vector<const Tag*> intersection{};
+        // tags are ordered by ID i.e. runs of the same tag are merged
         float iWeight=0, uWeight=0;
-
-        // iterate at most *threashold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& t:*t1) {
-            uWeight += 1;
-            if(std::find(t2->begin(),t2->end(),t) != t2->end()) {
-                iWeight += 1;
-                intersection.push_back(t);
-            }
-        }
-        // uWeight contains weight of v1's tags, iWeight weight of v1 intersection v2
-
-        // iterate tags from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        for(auto& t:*t2) {
-            if(std::find(intersection.begin(),intersection.end(),t) == intersection.end()) {
-                uWeight += 1;
-                if(std::find(t1->begin(),t1->end(),t) != t1->end()) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
+        size_t i1=0, i2=0;
+        while(i1<t1.size() || i2<t2.size()) {
+            uint32_t t = i2==t2.size() || (i1<t1.size() && t1[i1]<t2[i2]) ? t1[i1] : t2[i2];
+            size_t c1=0, c2=0;
+            while(i1<t1.size() && t1[i1]==t) { c1++; i1++; }
+            while(i2<t2.size() && t2[i2]==t) { c2++; i2++; }
+            if(c1) {
+                // tags of t1 go to union, shared ones to intersection too
+                uWeight += c1;
+                if(c2) {
+                    iWeight += c1;
                 }
+            } else {
+                uWeight += c2;
             }
         }
 
@@ -361,158 +1036,94 @@ float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vec
 }
 
 // consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
-float AiAaBoW::calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold)
+float AiAaBoW::calculateSimilarityByWords(
+        const vector<WordFrequencyList::RelevantWord>& v1,
+        const vector<WordFrequencyList::RelevantWord>& v2)
 {
-    if(!v1.size() || !v2.size()) {
+    if(v1.empty() || v2.empty()) {
         return 0.;
     } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
         float iWeight=0, uWeight=0;
-        int t=0;
-
-        // iterate at most *threashold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& e:v1.iterable()) {
-            if(t++>=threshold) break;
 
-            float w = lexicon.get(e.first)->weight;
-            uWeight += w;
-            if(v2.contains(e.first)) {
-                iWeight += w;
-                intersection.add(e.first);
-            }
-        }
-        // uWeight contains weight of 1st 10 v1's words, iWeight weight of v1 intersection v2
-
-        // iterate at most *threashold* words from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        t=0;
-        for(auto& e:v2.iterable()) {
-            // consider at most threashold words from v2
-            if(++t>=threshold) break;
-
-            if(!intersection.contains(e.first)) {
-                float w = lexicon.get(e.first)->weight;
-                uWeight += w;
-                if(v1.contains(e.first)) {
-                    iWeight += w;
-                    // no need to update iVector as it won't be needed
-                }
-            }
+        // merge vectors ordered by word ID: every word + to UNION once, matching + to INTERSECTION
+        size_t i=0, j=0;
+        while(i<v1.size() && j<v2.size()) {
+            const Lexicon::WordId w1 = v1[i].word;
+            const Lexicon::WordId w2 = v2[j].word;
+            // word weight is frozen on learning i.e. it's the same in both vectors
+            const float weight = w1<=w2 ? v1[i].weight : v2[j].weight;
+            uWeight += weight;
+            iWeight += w1==w2 ? weight : 0;
+            i += w1<=w2;
+            j += w2<=w1;
         }
+        for(; i<v1.size(); i++) uWeight += v1[i].weight;
+        for(; j<v2.size(); j++) uWeight += v2[j].weight;
 
         // intersection % of union
         float result = (iWeight/(uWeight/100.))/100;
-        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" (t="<<t<<") -> " << result << endl);
+        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight << " -> " << result << endl);
         return result;
     }
 }
 
-bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
+bool AiAaBoW::calculateLeaderboardSync(const Note* n)
 {
-    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << t << endl);
+    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << this_thread::get_id() << endl);
 
     // If N was REMOVED, then nobody will ask for leaderboard.
     // If N was MODIFIED, then leaderboard will not be accurate (but it's not critical).
     // If N was ADDED, then I don't have data - no leaderboard provided.
-    if(n->getAiAaMatrixIndex() != AA_NOT_SET) {
-        // check cache
-        auto cachedLeaderboard = leaderboardCache.find(n);
-        if(cachedLeaderboard != leaderboardCache.end()) {
-            return true;
-        }
-
-        // calculate row/column of AA matrix & build leaderboard
-        calculateAaRow(n->getAiAaMatrixIndex());
-
-        int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
-        for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
-            aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
-        }
-
-        float aa;
-        for(size_t x=0, y=n->getAiAaMatrixIndex(); x<notes.size(); x++) {
-            if(x==y) continue; // self on diagonal
-
-            aa = aaMatrix[x][y];
-
-            if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
-                // find target leaderboard row
-                size_t target;
-                for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
-                    if(aaLeaderboard[target][0] == AA_NOT_SET) {
-                        break; // fill empty row -> no shift needed
-                    } else {
-                        if(aa > aaMatrix[aaLeaderboard[target][0]][aaLeaderboard[target][1]]) {
-                            break;
-                        }
-                    }
-                }
-
-                /// empty row > no shift needed
-                if(aaLeaderboard[target][0] != AA_NOT_SET) {
-                    // shift leaderboard
-                    int sx = aaLeaderboard[target][0];
-                    int sy = aaLeaderboard[target][1];
-                    for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
-                        if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
-                            int tx=aaLeaderboard[ll][0];
-                            int ty=aaLeaderboard[ll][1];
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            sx=tx;
-                            sy=ty;
-                        } else {
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            break;
-                        }
-                    }
-                }
-
-                // assign value
-                aaLeaderboard[target][0]=x;
-                aaLeaderboard[target][1]=y;
-            }
-        }
+    if(n->getAiAaMatrixIndex() != AA_NOT_SET
+         && static_cast<size_t>(n->getAiAaMatrixIndex()) < notes.size()
+         && notes[n->getAiAaMatrixIndex()] == n)
+    {
+        // workers calculate different rows (tasks are keyed by N) and cache is checked by frontend
+        // before task is submitted - row is calculated unless it has been calculated by precalculation
+        size_t y = n->getAiAaMatrixIndex();
+        calculateAaRow(y);
 
         MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
         vector<pair<Note*,float>> leaderboard{};
-        for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
-            MF_DEBUG("  #" << i << " " <<
-                     notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
-                     " ~ " << aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]] << endl);
-            leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]]));
+        for(auto& neighbor:aaNeighbors[y]) {
+            MF_DEBUG("  #" << leaderboard.size() << " " <<
+                     notes[neighbor.first]->getName() << " (" << notes[neighbor.first]->getOutline()->getName() << ")" <<
+                     " ~ " << neighbor.second << endl);
+            leaderboard.push_back(std::make_pair(notes[neighbor.first],neighbor.second));
         }
 
         // cache leaderboard (copied)
+        lock_guard<mutex> criticalSection{leaderboardMutex};
         leaderboardCache[n] = leaderboard;
     }
 
-    leaderboardWip.erase(n);
     mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
     return true;
 }
 
-void AiAaBoW::assertAaSymmetry()
+void AiAaBoW::clearTitles()
 {
-    MF_DEBUG("AI: checking AA symmetry..." << endl);
-    for(size_t i=0; i<aaMatrix.size(); ++i) {
-        for(size_t j=0; i<aaMatrix.size(); ++i) {
-            if(aaMatrix[i][j] != aaMatrix[j][i]) {
-                MF_DEBUG("  Symmetry ERROR: aa["<<i<<"]["<<j<<"]" << endl);
-            }
-        }
+    for(WordFrequencyList* title:titles) {
+        delete title;
     }
-    MF_DEBUG("AI: AA symmetry checked!" << endl);
+    titles.clear();
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::sleep() {
+    waitForWorkers();
+    saveModel();
+    modelDirty = false;
+
     lexicon.clear();
     notes.clear();
+    freeIds.clear();
     outlines.clear();
     bow.clear();
+    clearTitles();
+    descriptions.clear();
+    relevantWeights.clear();
+    clearAaPostings();
 
     return true;
 }
@@ -520,7 +1131,8 @@ bool AiAaBoW::sleep() {
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::amnesia() {
     sleep();
-    aaMatrix.clear();
+    aaNeighbors.clear();
+    aaCalculated.clear();
 
     return true;
 }
@@ -20,11 +20,16 @@
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 
 #include <future>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include "../mind.h"
+#include "../../gear/task_executor.h"
 #include "ai_aa.h"
 #include "./nlp/markdown_tokenizer.h"
 #include "./nlp/note_char_provider.h"
+#include "./nlp/chunk_provider.h"
 #include "./nlp/bag_of_words.h"
 #include "./nlp/common_words_blacklist.h"
 
@@ -41,10 +46,13 @@ class Mind;
 class AiAaBoW : public AiAssociationsAssessment
 {
 private:
-    static constexpr int THREAD_POOL_SIZE = 2; // IMPROVE thread pool size to be either configured OR #CPU detected and 1/2 or 1/3 used
+    // AA matrix is precalculated by tiles of this size (rows of tile's Ns and columns fit cache)
+    static constexpr size_t AA_TILE_SIZE = 64;
     static constexpr float AA_NOT_SET = -1.;
     static constexpr int AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
     static constexpr float AA_TITLE_WORD_BONUS = 0.2;
+    // restoring AI model is worth only if (the most of) Ns are restored - otherwise memory is learned from scratch
+    static constexpr float AA_MODEL_RESTORE_THRESHOLD = 0.75;
 
 private:
     Mind& mind;
@@ -61,8 +69,66 @@ private:
 
     // Os - vector index is used as ID through other data structures like similarity matrices
     std::vector<Outline*> outlines; // IMPROVE make O* pair where .second is O embedding w/ classifications/attributes
-    // Ns - vector index is used as ID through other data structures
+    // Ns - vector index is used as ID through other data structures, nullptr if N was forgotten
     std::vector<Note*> notes; // IMPROVE make N* pair where .second is N embedding w/ classifications/attributes
+    // IDs of forgotten Ns to be reused by new Ns (IDs of other Ns are never changed)
+    std::vector<size_t> freeIds;
+    // N title/description word vectors - vector index is N ID; title vectors are owned, descriptions are owned by BoW
+    std::vector<WordFrequencyList*> titles;
+    std::vector<WordFrequencyList*> descriptions;
+    // weights of relevant words frozen on learning (lexicon weights change as Ns are remembered) so that
+    // every word has the same weight in all N vectors i.e. AA ranking is symmetric and its bound holds
+    std::vector<float> relevantWeights;
+
+    // features of N precomputed when N is learned i.e. AA ranking of Ns is arithmetic
+    // w/o access to Ns, tokenization nor lookups
+    struct AaFeatures {
+        const NoteType* type;
+        const Outline* outline;
+        // sorted IDs of title words
+        std::vector<Lexicon::WordId> titleWords;
+        // tags as learned (keys of tag postings)
+        std::vector<const Tag*> tags;
+        // sorted dense tag IDs (w/ duplicates) and their mask (ID modulo 64) to skip Ns w/o shared tag
+        std::vector<uint32_t> tagIds;
+        uint64_t tagsMask;
+        // relevant words of N description
+        const std::vector<WordFrequencyList::RelevantWord>* descriptionWords;
+    };
+    // vector index is N ID
+    std::vector<AaFeatures> aaFeatures;
+    // dense tag IDs
+    std::map<const Tag*,uint32_t> tagIds;
+
+    /*
+     * AA candidates
+     *
+     * Ns which share no relevant description word, title word, tag nor O get AA ranking
+     * which depends only on their type and whether they have tags. Therefore AA row must be
+     * calculated only for candidates found in postings and for few Ns from every group.
+     */
+
+    // posting of N's word, tag or O w/ the maximum similarity it may contribute to AA ranking
+    struct AaPosting {
+        const std::vector<size_t>* notes;
+        float descriptions;
+        float titles;
+        float tags;
+        bool outline;
+    };
+
+    // N IDs by word ID of relevant words of N descriptions
+    std::vector<std::vector<size_t>> descriptionPostings;
+    // N IDs by word ID of words of N titles
+    std::vector<std::vector<size_t>> titlePostings;
+    std::map<const Tag*,std::vector<size_t>> tagPostings;
+    std::map<const Outline*,std::vector<size_t>> outlinePostings;
+    // N IDs by N type and having no tags
+    std::map<std::pair<const NoteType*,bool>,std::vector<size_t>> aaGroups;
+    // tag similarity of N w/ duplicate tags is not bounded by the number of shared tags
+    bool aaDuplicateTags;
+    // compare N w/ all other Ns when AA row is calculated (verification of candidates)
+    bool exhaustiveAa;
 
     /*
      * Associations
@@ -71,15 +137,22 @@ private:
     // associate Ns as you READ: N -> O/N
     // IMPROVE thing*,float - both O and N to be association
     std::map<const Note*,std::vector<std::pair<Note*,float>>> leaderboardCache;
-    std::set<const Note*> leaderboardWip;
+    // leaderboard cache is written by workers and read by frontend
+    std::mutex leaderboardMutex;
 
     // associate as you WRITE: word(s) -> O/N
     // IMPROVE std::map<const Note*,std::vector<std::pair<string*,float>>> leaderboardCache;
 
-    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry).
-    // Changed from float** to vector<vector>> to enable row/col extension on new N/O
-    // (keep & avoid realloc)
-    std::vector<std::vector<float>> aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // AA neighbors - at most AA_LEADERBOARD_SIZE N IDs w/ the highest AA rankings (and their
+    // rankings) for every N i.e. memory is O(N*k) instead of O(N^2) matrix. Vector index is
+    // N ID, neighbors are ordered by ranking (descending) and N ID (ascending) for equal rankings.
+    std::vector<std::vector<std::pair<size_t,float>>> aaNeighbors; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Ns whose neighbors were calculated against *all* other Ns - vector index is N ID
+    // (not vector<bool> as workers calculate different rows concurrently)
+    std::vector<char> aaCalculated;
+
+    // AI model (lexicon, word vectors and AA neighbors) changed since it was saved or restored
+    bool modelDirty;
 
 public:
     explicit AiAaBoW(Memory& memory, Mind& mind);
@@ -121,36 +194,133 @@ public:
         return std::shared_future<bool>(p.get_future());
     }
 
+    /**
+     * @brief Forget Ns of O.
+     */
+    virtual void forget(const Outline* outline);
+
+    /**
+     * @brief Learn created or modified N.
+     *
+     * Only N is (re)tokenized - lexicon frequencies are adjusted, but relevant words of all Ns
+     * keep weights frozen on learning (new words are frozen when first seen) until the next
+     * learning. N is re-ranked
+     * w/ all other Ns to invalidate only AA rows (and cached leaderboards) which are affected.
+     */
+    virtual void remember(Note* note);
+
+    /**
+     * @brief Forget N - N's ID is freed for reuse w/o renumbering other Ns.
+     */
+    virtual void forget(const Note* note);
+
     virtual bool sleep();
 
     virtual bool amnesia();
 
+    /**
+     * @brief Precalculate entire AA.
+     *
+     * Upper triangle of (virtual) AA matrix is split to tiles which are
+     * calculated by worker threads - idle worker takes the next tile. Every
+     * worker keeps its own neighbors which are merged at the end. Calculation
+     * of AA ranking is read-only (memory must be learned first) and neighbors
+     * are totally ordered therefore results do not depend on the number
+     * of threads or scheduling.
+     *
+     * LONG running method.
+     *
+     * @param threads   number of worker threads, 0 to use all CPUs.
+     */
+    void precalculateAa(unsigned threads=0);
+
+    /**
+     * @brief Calculate AA row i.e. neighbors of N from associations with *all* other Ns.
+     *
+     * Only candidates (Ns w/ shared word, tag or O) and AA_LEADERBOARD_SIZE
+     * Ns from every group of the remaining Ns are ranked unless AA is exhaustive.
+     * Postings of candidates are merged from the shortest one and merge stops once
+     * Ns from the remaining postings cannot get to neighbors (upper bound of their
+     * AA ranking is lower than ranking of the last neighbor) i.e. row calculation
+     * is sub-linear in the number of Ns for selective postings and results are exact.
+     *
+     * @param y     N ID.
+     */
+    void calculateAaRow(size_t y);
+
+    /**
+     * @brief Calculate AA ranking of two Ns from their features - method is read-only to be thread safe.
+     */
+    float calculateAa(size_t x, size_t y) const;
+
+    /**
+     * @brief Save AI model if it changed - lexicon, word vectors and calculated AA neighbors of Ns.
+     *
+     * Model is saved next to memory snapshot (unless snapshots are disabled) on learning,
+     * sleep and destruction. Every N is stamped w/ its modification time, revision and
+     * content hash so that the next dream() restores valid Ns instead of learning them.
+     *
+     * @return true if model was saved.
+     */
+    bool saveModel();
+
+    const std::vector<std::vector<std::pair<size_t,float>>>& getAaNeighbors() const { return aaNeighbors; }
+    TaskExecutor& getWorkers() { return workers; }
+
+    /**
+     * @brief Calculate AA rows by comparison of N w/ all other Ns instead of candidates only.
+     *
+     * Results are the same - exhaustive comparison is meant for verification.
+     */
+    void setExhaustiveAa(bool exhaustive) { exhaustiveAa = exhaustive; }
+    bool isExhaustiveAa() const { return exhaustiveAa; }
+
+    /**
+     * @brief Calculate similarity of two sparse vectors of relevant words (weighted Jaccard).
+     *
+     * Vectors are ordered by word ID i.e. similarity is calculated by linear merge
+     * w/o allocations.
+     */
+    static float calculateSimilarityByWords(
+            const std::vector<WordFrequencyList::RelevantWord>& v1,
+            const std::vector<WordFrequencyList::RelevantWord>& v2);
+
 private:
 
     /*
-     * Worker threads:
-     *  1. packaged task is assigned to thread
-     *  2. thread performs the task and calls detach() on self when finishes
-     *     to indicate that it's ready to be deleted
-     *  3. if main thread detects that !thread.joinable(), then it can be deleted;
-     *     cleanup is done on any new thread launch AND/OR by this class destructor.
+     * Workers:
+     *  - learning and leaderboard calculations are tasks of bounded executor (threads
+     *    are joined on destruction),
+     *  - leaderboard tasks are keyed by N i.e. requests for N which is being calculated
+     *    share the future and new request cancels queued requests for other Ns (user
+     *    navigated away from them),
+     *  - data which are read by workers are modified only when there are no running
+     *    tasks (see waitForWorkers()).
      */
-
-    // IMPROVE introduce a LIMIT on number of running threads in configuration
-    std::vector<std::thread*> runningWorkers;
-    std::mutex runningWorkersMutex;
+    TaskExecutor workers;
 
 private:
 
     /**
      * @brief Learn Memory to start thinking.
      */
-    bool learnMemorySync(std::thread* t = nullptr);
+    bool learnMemorySync();
+
+    /**
+     * @brief Restore AI model saved by the last run - Ns whose stamp changed are (un)learned incrementally.
+     * @return false if model is missing, invalid or too stale - memory must be learned from scratch.
+     */
+    bool restoreModelSync();
+
+    /**
+     * @brief Learn created or modified N - caller ensures there are no running workers.
+     */
+    void rememberSync(Note* note);
 
     /**
      * @brief Calculate leaderboard and indicate that it has been stored to cache.
      */
-    bool calculateLeaderboardSync(const Note* n, std::thread* t = nullptr);
+    bool calculateLeaderboardSync(const Note* n);
 
     /**
      * @brief Initialize blacklist using common words.
@@ -161,61 +331,97 @@ private:
     void initializeWordBlacklist();
 
     /**
-     * @brief Precalculate entire AA.
-     *
-     * LONG running method.
+     * @brief Offer N w/ given AA ranking to bounded neighbors ordered from the best.
      */
-    void precalculateAa();
+    static void offerAaNeighbor(std::vector<std::pair<size_t,float>>& neighbors, size_t id, float aa);
 
     /**
-     * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
-     *
-     * LONG running method on bigger repositories.
+     * @brief Precalculate AA rankings of Ns w/ IDs in given tile above diagonal to given neighbors.
      */
-    void calculateAaRow(size_t y);
+    void precalculateAaTile(size_t y0, size_t x0, std::vector<std::vector<std::pair<size_t,float>>>& neighbors);
 
     /**
-     * @brief Calculate similarity of two word vectors.
+     * @brief Build features of N from its word vectors, tags, type and O.
      */
-    float calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold=1000);
+    void buildAaFeatures(size_t y);
 
     /**
-     * @brief Calculate similarity of two tag lists.
+     * @brief Build postings of relevant words, title words, tags and Os used to find AA candidates.
      */
-    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
+    void buildAaPostings();
 
     /**
-     * @brief Calculate similarity of two N/O names.
+     * @brief Collect postings of N's relevant words, title words, tags and O ordered by length.
      */
-    float calculateSimilarityByTitles(const std::string& t1, const std::string& t2);
+    void collectAaPostings(size_t y, std::vector<AaPosting>& postings) const;
 
     /**
-     * @brief Check AA matrix symmetry.
+     * @brief Calculate upper bound of AA ranking of Ns which are only in given postings.
      */
-    void assertAaSymmetry();
+    float calculateAaBound(size_t y, std::vector<AaPosting>::const_iterator begin, std::vector<AaPosting>::const_iterator end) const;
+
+    void clearAaPostings();
 
     /**
-     * @brief Get AA leaderboard from cache.
+     * @brief Tokenize N's description and title to word vectors of N ID.
      */
-    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
+    void tokenizeNote(size_t y);
+
+    /**
+     * @brief Remove N's word vectors and postings and adjust lexicon frequencies.
+     */
+    void unlearnNote(size_t y);
+
+    /**
+     * @brief Add N to (ordered) postings of its relevant words, title words, tags and O (N features must be built).
+     */
+    void addAaPostings(size_t y);
+    void removeAaPostings(size_t y);
 
     /**
-     * @brief Remove finished workers and add new one.
+     * @brief Invalidate AA rows and cached leaderboards affected by N change.
+     * @param reassess  re-rank N w/ Ns whose AA rows are calculated (N was changed), else
+     *                  just invalidate rows w/ N (N was forgotten).
      */
-    void addWorkerAndCleanZombies(std::thread* t);
+    void invalidateAa(size_t y, bool reassess);
+
+    /**
+     * @brief Cancel queued and wait for running workers as they may access Ns, word vectors and AA neighbors.
+     */
+    void waitForWorkers();
+
+    /**
+     * @brief Calculate similarity of two sorted tag ID lists.
+     *
+     * Tag of the first list counts to intersection if it's in the second list, tag of the second
+     * list counts to union if it's not in the first list (duplicate tags count repeatedly).
+     */
+    static float calculateSimilarityByTags(const AaFeatures& f1, const AaFeatures& f2);
+
+    /**
+     * @brief Calculate similarity of two sorted N/O name word ID lists.
+     */
+    static float calculateSimilarityByTitles(const std::vector<Lexicon::WordId>& v1, const std::vector<Lexicon::WordId>& v2);
+
+    void clearTitles();
+
+    /**
+     * @brief Get AA leaderboard from cache.
+     */
+    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
 
 public:
 #ifdef DO_MF_DEBUG
     void printAa() {
-        std::cout << "AA Matrix:" << std::endl;
-        for(size_t i=0; i<aaMatrix.size(); i++) {
+        std::cout << "AA neighbors:" << std::endl;
+        for(size_t i=0; i<aaNeighbors.size(); i++) {
             std::cout << "AA[" << i << "] = ";
-            for(size_t j=0; j<aaMatrix.size(); j++) {
-                if(aaMatrix[i][j] == -1) {
-                    std::cout << "_ ";
-                } else {
-                    std::cout << aaMatrix[i][j] << " ";
+            if(aaCalculated[i]) {
+                for(auto& neighbor:aaNeighbors[i]) {
+                    std::cout << neighbor.first << "~" << neighbor.second << " ";
                 }
+            } else {
+                std::cout << "_";
             }
             std::cout << std::endl;
         }
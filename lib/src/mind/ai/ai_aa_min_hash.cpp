@@ -0,0 +1,361 @@
+/*
+ ai_aa_min_hash.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ai_aa_min_hash.h"
+
+#include <algorithm>
+
+#include "../fts_index.h"
+
+namespace m8r {
+
+using namespace std;
+
+constexpr unsigned AiAaMinHash::DEFAULT_BANDS;
+constexpr unsigned AiAaMinHash::DEFAULT_ROWS;
+
+namespace {
+
+// 64b finalizer of SplitMix64 - hash function of MinHash row is mix(word ^ seed)
+inline uint64_t mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// FNV-1a folded to 32b - word hashes must not depend on the platform to make leaderboards reproducible
+inline uint32_t hashWord(const string& word)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(unsigned char c:word) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+void appendWords(const string& text, const CommonWordsBlacklist& commonWords, vector<string>& terms, vector<uint32_t>& words)
+{
+    terms.clear();
+    FtsIndex::tokenize(text, terms);
+    for(const string& term:terms) {
+        if(term.size()>1 && !commonWords.findWord(term)) {
+            words.push_back(hashWord(term));
+        }
+    }
+}
+
+void sortUnique(vector<uint32_t>& words)
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+}
+
+// Jaccard index of sorted word sets
+float calculateJaccard(const uint32_t* b1, const uint32_t* e1, const uint32_t* b2, const uint32_t* e2)
+{
+    const size_t size = (e1-b1)+(e2-b2);
+    size_t intersection = 0;
+    while(b1<e1 && b2<e2) {
+        if(*b1 < *b2) {
+            ++b1;
+        } else if(*b2 < *b1) {
+            ++b2;
+        } else {
+            ++intersection; ++b1; ++b2;
+        }
+    }
+    return size?static_cast<float>(intersection)/(size-intersection):0;
+}
+
+bool bucketComparator(const pair<uint32_t,uint32_t>& p1, const pair<uint32_t,uint32_t>& p2)
+{
+    return p1.first < p2.first;
+}
+
+} // anonymous namespace
+
+AiAaMinHash::AiAaMinHash(Memory& memory, Mind& mind, unsigned bands, unsigned rows)
+    : mind(mind),
+      memory(memory),
+      commonWords{},
+      bands(bands?bands:1),
+      rows(rows?rows:1)
+{
+    // seeds are fixed so that buckets (and leaderboards) are the same across runs
+    for(unsigned i=0; i<this->bands*this->rows; i++) {
+        seeds.push_back(mix(i+1));
+    }
+}
+
+AiAaMinHash::~AiAaMinHash()
+{
+}
+
+shared_future<bool> AiAaMinHash::dream()
+{
+    MF_DEBUG("AA.MinHash: LEARNING memory w/ " << bands << " bands of " << rows << " rows..." << endl);
+#ifdef DO_MF_DEBUG
+    auto begin = chrono::high_resolution_clock::now();
+#endif
+
+    sleep();
+    memory.getAllNotes(notes);
+
+    wordsOffsets.reserve(notes.size()+1);
+    wordsOffsets.push_back(0);
+    buckets.resize(bands);
+    for(auto& bucket:buckets) {
+        bucket.reserve(notes.size());
+    }
+
+    vector<uint32_t> w{}, signature(seeds.size());
+    for(size_t i=0; i<notes.size(); i++) {
+        notes[i]->setAiAaMatrixIndex(i);
+
+        w.clear();
+        collectWords(notes[i], w);
+        words.insert(words.end(), w.begin(), w.end());
+        wordsOffsets.push_back(words.size());
+        // Ns w/o words are not in buckets
+        if(sign(w.data(), w.data()+w.size(), signature)) {
+            for(unsigned b=0; b<bands; b++) {
+                buckets[b].push_back(std::make_pair(hashBand(signature, b), static_cast<uint32_t>(i)));
+            }
+        }
+    }
+    words.shrink_to_fit();
+    // N IDs are increasing i.e. stable sort keeps Ns in bucket ordered by ID
+    for(auto& bucket:buckets) {
+        std::stable_sort(bucket.begin(), bucket.end(), bucketComparator);
+    }
+
+#ifdef DO_MF_DEBUG
+    auto end = chrono::high_resolution_clock::now();
+    MF_DEBUG("AA.MinHash: " << notes.size() << " Ns learned in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+#endif
+
+    mind.persistMindState(Configuration::MindState::THINKING);
+
+    promise<bool> p{};
+    p.set_value(true);
+    return shared_future<bool>(p.get_future());
+}
+
+void AiAaMinHash::collectWords(const string& text, vector<uint32_t>& words) const
+{
+    vector<string> terms{};
+    appendWords(text, commonWords, terms, words);
+    sortUnique(words);
+}
+
+void AiAaMinHash::collectWords(const Note* note, vector<uint32_t>& words) const
+{
+    collectWords(note->getName(), note->getDescription(), words);
+}
+
+void AiAaMinHash::collectWords(const string& name, const vector<string*>& description, vector<uint32_t>& words) const
+{
+    vector<string> terms{};
+    appendWords(name, commonWords, terms, words);
+    for(const string* line:description) {
+        if(line) {
+            appendWords(*line, commonWords, terms, words);
+        }
+    }
+    sortUnique(words);
+}
+
+bool AiAaMinHash::sign(const uint32_t* begin, const uint32_t* end, vector<uint32_t>& signature) const
+{
+    if(begin == end) {
+        return false;
+    }
+
+    for(size_t i=0; i<seeds.size(); i++) {
+        const uint64_t seed = seeds[i];
+        uint32_t minimum = UINT32_MAX;
+        for(const uint32_t* word=begin; word<end; ++word) {
+            uint32_t h = static_cast<uint32_t>(mix(*word ^ seed) >> 32);
+            if(h < minimum) {
+                minimum = h;
+            }
+        }
+        signature[i] = minimum;
+    }
+    return true;
+}
+
+uint32_t AiAaMinHash::hashBand(const vector<uint32_t>& signature, unsigned band) const
+{
+    uint64_t h = band;
+    for(unsigned r=band*rows; r<(band+1)*rows; r++) {
+        h = mix(h ^ signature[r]) + r;
+    }
+    return static_cast<uint32_t>(h >> 32);
+}
+
+void AiAaMinHash::assess(const uint32_t* begin, const uint32_t* end, const Note* self, vector<pair<Note*,float>>& associations) const
+{
+    associations.clear();
+    vector<uint32_t> signature(seeds.size());
+    if(!sign(begin, end, signature)) {
+        return;
+    }
+
+    // candidates ~ Ns which share bucket in at least one band
+    vector<uint32_t> candidates{};
+    for(unsigned b=0; b<buckets.size(); b++) {
+        auto range = std::equal_range(
+            buckets[b].begin(),
+            buckets[b].end(),
+            std::make_pair(hashBand(signature, b), 0u),
+            bucketComparator);
+        for(auto i=range.first; i!=range.second; ++i) {
+            candidates.push_back(i->second);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // candidates are ranked exactly - LSH affects recall only
+    vector<pair<uint32_t,float>> ranked{};
+    for(uint32_t c:candidates) {
+        if(!notes[c] || notes[c] == self) {
+            continue;
+        }
+        float similarity = calculateJaccard(begin, end, words.data()+wordsOffsets[c], words.data()+wordsOffsets[c+1]);
+        if(similarity > 0) {
+            ranked.push_back(std::make_pair(c, similarity));
+        }
+    }
+
+    // the best Ns (lower ID for equal similarity) so that leaderboard is deterministic
+    const size_t size = std::min(ranked.size(), static_cast<size_t>(AA_LEADERBOARD_SIZE));
+    std::partial_sort(
+        ranked.begin(),
+        ranked.begin()+size,
+        ranked.end(),
+        [](const pair<uint32_t,float>& p1, const pair<uint32_t,float>& p2) {
+            return p1.second > p2.second || (p1.second == p2.second && p1.first < p2.first);
+        });
+    for(size_t i=0; i<size; i++) {
+        associations.push_back(std::make_pair(notes[ranked[i].first], ranked[i].second));
+    }
+}
+
+shared_future<bool> AiAaMinHash::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations)
+{
+    const int i = note->getAiAaMatrixIndex();
+    if(i >= 0 && static_cast<size_t>(i) < notes.size() && notes[i] == note) {
+        assess(words.data()+wordsOffsets[i], words.data()+wordsOffsets[i+1], note, associations);
+
+        promise<bool> p{};
+        p.set_value(true);
+        return shared_future<bool>(p.get_future());
+    }
+
+    // N was created after learning
+    vector<uint32_t> w{};
+    collectWords(note, w);
+    return getAssociatedNotes(w, associations, note);
+}
+
+shared_future<bool> AiAaMinHash::getAssociatedNotes(Outline* outline, vector<pair<Note*,float>>& associations)
+{
+    vector<uint32_t> w{};
+    collectWords(outline->getName(), outline->getDescription(), w);
+    return getAssociatedNotes(w, associations, outline->getOutlineDescriptorAsNote());
+}
+
+shared_future<bool> AiAaMinHash::getAssociatedNotes(const string& words, vector<pair<Note*,float>>& associations, const Note* self)
+{
+    vector<uint32_t> w{};
+    collectWords(words, w);
+    return getAssociatedNotes(w, associations, self);
+}
+
+shared_future<bool> AiAaMinHash::getAssociatedNotes(const vector<uint32_t>& words, vector<pair<Note*,float>>& associations, const Note* self)
+{
+    assess(words.data(), words.data()+words.size(), self, associations);
+
+    promise<bool> p{};
+    p.set_value(true);
+    return shared_future<bool>(p.get_future());
+}
+
+void AiAaMinHash::forget(const Outline* outline)
+{
+    // words and buckets of forgotten Ns are kept until the next learning, Ns are dropped
+    for(const Note* n:outline->getNotes()) {
+        forget(n);
+    }
+}
+
+void AiAaMinHash::remember(Note* note)
+{
+    // Ns are signed on learning
+    if(wordsOffsets.empty()) {
+        return;
+    }
+    forget(note);
+
+    const size_t i = notes.size();
+    notes.push_back(note);
+    note->setAiAaMatrixIndex(i);
+
+    vector<uint32_t> w{}, signature(seeds.size());
+    collectWords(note, w);
+    words.insert(words.end(), w.begin(), w.end());
+    wordsOffsets.push_back(words.size());
+    if(sign(w.data(), w.data()+w.size(), signature)) {
+        for(unsigned b=0; b<bands; b++) {
+            // N has the highest ID i.e. it's the last one in its bucket
+            auto bucket = std::make_pair(hashBand(signature, b), static_cast<uint32_t>(i));
+            buckets[b].insert(
+                std::upper_bound(buckets[b].begin(), buckets[b].end(), bucket, bucketComparator),
+                bucket);
+        }
+    }
+}
+
+void AiAaMinHash::forget(const Note* note)
+{
+    // words and buckets of forgotten N are kept until the next learning, N is dropped
+    const int i = note->getAiAaMatrixIndex();
+    if(i >= 0 && static_cast<size_t>(i) < notes.size() && notes[i] == note) {
+        notes[i] = nullptr;
+    }
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+bool AiAaMinHash::sleep()
+{
+    notes.clear();
+    words.clear();
+    wordsOffsets.clear();
+    buckets.clear();
+
+    return true;
+}
+
+} // m8r namespace
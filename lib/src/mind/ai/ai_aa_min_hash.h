@@ -0,0 +1,141 @@
+/*
+ ai_aa_min_hash.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_MIN_HASH_H
+#define M8R_AI_ASSOCIATIONS_ASSESSMENT_MIN_HASH_H
+
+#include <future>
+#include <vector>
+#include <cstdint>
+
+#include "ai_aa.h"
+#include "../mind.h"
+#include "./nlp/common_words_blacklist.h"
+
+namespace m8r {
+
+class Mind;
+
+/**
+ * @brief MinHash/LSH based (approximate) associations assessment for huge repositories.
+ *
+ * Description:
+ * - N is represented by the set of (lower case) words of its title and description
+ *   w/o common words. Similarity of Ns is Jaccard index of their word sets.
+ * - N gets MinHash signature of bands*rows minimal word hashes which is split to bands
+ *   of rows and every band is hashed to a bucket (banded LSH). Ns which share at least
+ *   one bucket w/ N are candidates which are ranked by Jaccard index of their word sets.
+ * - Ns w/ similarity s become candidates w/ probability 1-(1-s^rows)^bands i.e. more bands
+ *   increase recall (and memory), more rows increase precision (fewer candidates to rank).
+ * - Memory is O(N) - hashes of N words and N ID in bucket of every band (there is no AA matrix
+ *   nor postings of words), learning is linear in the size of memory, leaderboard is calculated
+ *   synchronously.
+ */
+class AiAaMinHash : public AiAssociationsAssessment
+{
+public:
+    // recall ~90% for the best Ns w/ Jaccard index ~0.15 (see AI benchmark)
+    static constexpr unsigned DEFAULT_BANDS = 16;
+    static constexpr unsigned DEFAULT_ROWS = 1;
+
+private:
+    Mind& mind;
+    Memory& memory;
+    CommonWordsBlacklist commonWords;
+
+    const unsigned bands;
+    const unsigned rows;
+    // seed of hash function for every signature row
+    std::vector<uint64_t> seeds;
+
+    // Ns - vector index is used as ID through words and buckets, nullptr if N was forgotten
+    std::vector<Note*> notes;
+    // sorted hashes of N words - words of N ID are in [wordsOffsets[ID],wordsOffsets[ID+1])
+    std::vector<uint32_t> words;
+    std::vector<size_t> wordsOffsets;
+    // (band hash, N ID) pairs ordered by hash - one vector per band
+    std::vector<std::vector<std::pair<uint32_t,uint32_t>>> buckets;
+
+public:
+    explicit AiAaMinHash(Memory& memory, Mind& mind, unsigned bands=DEFAULT_BANDS, unsigned rows=DEFAULT_ROWS);
+    AiAaMinHash(const AiAaMinHash&) = delete;
+    AiAaMinHash(const AiAaMinHash&&) = delete;
+    AiAaMinHash &operator=(const AiAaMinHash&) = delete;
+    AiAaMinHash &operator=(const AiAaMinHash&&) = delete;
+    virtual ~AiAaMinHash();
+
+    virtual std::shared_future<bool> dream();
+
+    /**
+     * @brief Get associated Ns.
+     *
+     * Ns which were learned use their signature, Ns which were created
+     * after learning are signed on demand.
+     */
+    virtual std::shared_future<bool> getAssociatedNotes(const Note* note, std::vector<std::pair<Note*,float>>& associations);
+    virtual std::shared_future<bool> getAssociatedNotes(Outline* outline, std::vector<std::pair<Note*,float>>& associations);
+    virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
+
+    virtual void forget(const Outline* outline);
+
+    /**
+     * @brief Learn created or modified N.
+     *
+     * N is signed to a new slot (ID) - words and buckets of its old slot are kept
+     * until the next learning like words and buckets of forgotten Ns.
+     */
+    virtual void remember(Note* note);
+    virtual void forget(const Note* note);
+
+    virtual bool sleep();
+
+    virtual bool amnesia() {
+        return sleep();
+    }
+
+    unsigned getBands() const { return bands; }
+    unsigned getRows() const { return rows; }
+    size_t getNotesCount() const { return notes.size(); }
+
+    /**
+     * @brief Collect hashes of words (w/o common words) in given text - hashes are sorted and unique.
+     */
+    void collectWords(const std::string& text, std::vector<uint32_t>& words) const;
+    void collectWords(const Note* note, std::vector<uint32_t>& words) const;
+
+private:
+    void collectWords(const std::string& name, const std::vector<std::string*>& description, std::vector<uint32_t>& words) const;
+
+    /**
+     * @brief Calculate MinHash signature of word hashes.
+     * @return false if there are no words to sign.
+     */
+    bool sign(const uint32_t* begin, const uint32_t* end, std::vector<uint32_t>& signature) const;
+
+    uint32_t hashBand(const std::vector<uint32_t>& signature, unsigned band) const;
+
+    /**
+     * @brief Find Ns which share a bucket w/ word set and rank them by Jaccard index.
+     */
+    void assess(const uint32_t* begin, const uint32_t* end, const Note* self, std::vector<std::pair<Note*,float>>& associations) const;
+
+    std::shared_future<bool> getAssociatedNotes(const std::vector<uint32_t>& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
+};
+
+}
+#endif // M8R_AI_ASSOCIATIONS_ASSESSMENT_MIN_HASH_H
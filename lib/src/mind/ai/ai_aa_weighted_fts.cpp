@@ -178,17 +178,14 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
 
 void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,float>>* result, vector<string>& regexps, const bool ignoreCase)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
     if(ignoreCase) {
-        // case INSENSITIVE
+        // case INSENSITIVE - regexps are lower case, text is folded by search kernel w/o copying
 
         // O matches
         float oScore = 0;
-        string s{};
         // O.title matches
-        stringToLower(outline->getName(), s);
         for(auto& regexp:regexps) {
-            if(s.find(regexp)!=string::npos) {
+            if(stringFindIgnoreCase(outline->getName(), regexp)!=string::npos) {
                 oScore += 100.;
             }
         }
@@ -196,15 +193,9 @@ void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,f
         float matches = 0.;
         for(string* d:outline->getDescription()) {
             if(d) {
-                s.clear();
-                stringToLower(*d, s);
                 for(auto& regexp:regexps) {
                     // find all matches (regexp matched more than once)
-                    size_t m = s.find(regexp, 0);
-                    while(m != string::npos) {
-                        matches++;
-                        m = s.find(regexp,m+1);
-                    }
+                    matches += stringCountIgnoreCase(*d, regexp);
                 }
             }
         }
@@ -226,10 +217,8 @@ void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,f
                 continue;
             }
             // N.title matches
-            s.clear();
-            stringToLower(note->getName(), s);
             for(auto& regexp:regexps) {
-                if(s.find(regexp)!=string::npos) {
+                if(stringFindIgnoreCase(note->getName(), regexp)!=string::npos) {
                     nScore += 100.;
                 }
             }
@@ -237,15 +226,9 @@ void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,f
             float matches=0.;
             for(string* d:note->getDescription()) {
                 if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
                     for(auto& regexp:regexps) {
                         // find them all
-                        size_t m = s.find(regexp, 0);
-                        while(m != string::npos) {
-                            matches++;
-                            m = s.find(regexp,m+1);
-                        }
+                        matches += stringCountIgnoreCase(*d, regexp);
                     }
                 }
             }
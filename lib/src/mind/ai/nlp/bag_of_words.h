@@ -78,6 +78,17 @@ public:
         return bow[t];
     }
 
+    /**
+     * @brief Remove (and delete) document's word frequency list.
+     */
+    void remove(const Thing* t) {
+        auto i = bow.find(const_cast<Thing*>(t));
+        if(i != bow.end()) {
+            delete i->second;
+            bow.erase(i);
+        }
+    }
+
     void reorderDocVectorsByWeight();
 
 #ifdef DO_MF_DEBUG
@@ -0,0 +1,78 @@
+/*
+ chunk_provider.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_CHUNK_PROVIDER_H
+#define M8R_CHUNK_PROVIDER_H
+
+#include <string>
+
+#include "../../../model/note.h"
+
+namespace m8r {
+
+/*
+ * Chunk providers give text as contiguous chunks (joined by newline) instead
+ * of a stream of chars - they are not virtual, tokenizer is a template:
+ *
+ *   template<class F> void forEachChunk(F f) const;
+ *
+ * calls f(const char* begin, const char* end, bool newline) for every chunk,
+ * newline indicates that the chunk is followed by newline (otherwise it's the
+ * end of text).
+ */
+
+/**
+ * @brief String as a single chunk - see StringCharProvider.
+ */
+class StringChunkProvider
+{
+private:
+    const std::string& s;
+
+public:
+    explicit StringChunkProvider(const std::string& s) : s(s) {}
+
+    template<class F> void forEachChunk(F f) const {
+        if(!s.empty()) {
+            f(s.data(), s.data()+s.size(), false);
+        }
+    }
+};
+
+/**
+ * @brief N name and description lines as chunks w/o copying N to a string - see NoteCharProvider.
+ */
+class NoteChunkProvider
+{
+private:
+    const Note* note;
+
+public:
+    explicit NoteChunkProvider(const Note* note) : note(note) {}
+
+    template<class F> void forEachChunk(F f) const {
+        const std::string& name = note->getName();
+        f(name.data(), name.data()+name.size(), true);
+        for(const std::string* line:note->getDescription()) {
+            f(line->data(), line->data()+line->size(), true);
+        }
+    }
+};
+
+}
+#endif // M8R_CHUNK_PROVIDER_H
@@ -19,14 +19,64 @@
 #ifndef M8R_COMMON_WORDS_BLACKLIST_H
 #define M8R_COMMON_WORDS_BLACKLIST_H
 
+#include <cstdint>
+#include <string>
+
 #include "../../../gear/trie.h"
 
 namespace m8r {
 
+/**
+ * @brief Blacklist of the most common (English) words.
+ *
+ * Common words are a fixed set known at compile time - they are found
+ * by minimal perfect hash w/o allocation (see perfect_hash.h), words
+ * added at runtime are kept in trie.
+ */
 class CommonWordsBlacklist
 {
+public:
+    /*
+     * Minimal perfect hash table of common words (see perfect_hash.h) - words are
+     * in slot order. Table is generated by perfecthash::build() (table of a changed
+     * set of words is printed by PerfectHashTestCase.CommonWords) and it's verified
+     * at compile time.
+     */
+    struct CommonWords {
+        static constexpr size_t SIZE = 80;
+        static constexpr const char* words[SIZE] = {
+            "other", "our", "about", "they", "are", "has", "me", "some", "than", "you",
+            "to", "their", "had", "all", "her", "want", "could", "with", "was", "should",
+            "your", "his", "more", "from", "is", "have", "which", "if", "then", "there",
+            "may", "a", "an", "by", "I", "like", "but", "can", "as", "for",
+            "any", "when", "where", "that", "do", "were", "us", "such", "or", "he",
+            "these", "one", "in", "so", "am", "also", "get", "will", "been", "did",
+            "would", "who", "and", "those", "does", "at", "no", "not", "it", "the",
+            "of", "be", "new", "my", "we", "on", "how", "what", "its", "this"
+        };
+        static constexpr uint8_t lengths[SIZE] = {
+            5, 3, 5, 4, 3, 3, 2, 4, 4, 3, 2, 5, 3, 3, 3, 4, 5, 4, 3, 6,
+            4, 3, 4, 4, 2, 4, 5, 2, 4, 5, 3, 1, 2, 2, 1, 4, 3, 3, 2, 3,
+            3, 4, 5, 4, 2, 4, 2, 4, 2, 2, 5, 3, 2, 2, 2, 4, 3, 4, 4, 3,
+            5, 3, 3, 5, 4, 2, 2, 3, 2, 3, 2, 2, 3, 2, 2, 2, 3, 4, 3, 4
+        };
+        static constexpr uint32_t seeds[SIZE] = {
+            0, 0x80000000, 0x8000000b, 0, 0, 0, 0x8000000f, 3,
+            3, 14, 0, 0, 0, 0, 0x80000010, 0,
+            0, 0, 0x80000016, 0, 0, 0, 5, 3,
+            0x80000017, 4, 0, 0, 0x80000019, 2, 0, 0x8000001c,
+            0, 0, 0x8000001d, 0, 0, 0, 0x80000029, 3,
+            0x8000002a, 1, 0, 0, 0, 0, 0, 0x8000002b,
+            0, 0, 0x80000032, 0x80000037, 0, 0, 0, 8,
+            0x80000038, 1, 0, 0x8000003a, 4, 0, 0x8000003c, 20,
+            0, 0, 0x8000003f, 0, 0, 0, 30, 5,
+            3, 4, 0, 0, 0, 0, 0, 0x8000004f
+        };
+    };
+
 private:
-    Trie wordBlacklist;
+    Trie addedWords;
+    bool hasAddedWords;
 
 public:
     explicit CommonWordsBlacklist();
@@ -36,11 +86,17 @@ public:
     CommonWordsBlacklist &operator=(const CommonWordsBlacklist&&) = delete;
     ~CommonWordsBlacklist();
 
-    bool findWord(std::string s) const {
-        return wordBlacklist.findWord(s);
+    static bool isCommonWord(const char* s, size_t size);
+    static bool isCommonWord(const std::string& s) {
+        return isCommonWord(s.data(), s.size());
+    }
+
+    bool findWord(const std::string& s) const {
+        return isCommonWord(s) || (hasAddedWords && addedWords.findWord(s));
     }
     void addWord(std::string word) {
-        wordBlacklist.addWord(word);
+        addedWords.addWord(word);
+        hasAddedWords = true;
     }
 };
 
@@ -0,0 +1,304 @@
+/*
+ language_detector.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "language_detector.h"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace m8r {
+
+using namespace std;
+
+constexpr size_t LanguageDetector::MAX_TRIGRAMS;
+constexpr size_t LanguageDetector::MIN_TRIGRAMS;
+constexpr float LanguageDetector::MARGIN;
+
+namespace {
+
+struct LanguageSeed {
+    Stemmer::Language language;
+    const char* words;
+};
+
+/*
+ * The most frequent words of languages (w/ few common endings) from which
+ * trigram profiles are built - non-ASCII letters are escaped so that source
+ * doesn't depend on compiler charset.
+ */
+const LanguageSeed LANGUAGE_SEEDS[] = {
+    {Stemmer::ENGLISH,
+        "the of and to in is that for it as was with be by on not he this are or his from at "
+        "which but have an they you were her she there been one all we their has would when "
+        "if so no will more can what about other into than its also only some time how these "
+        "two may then do first any my now such like our over even most made after where many "
+        "before through new should well because each just those people much being "
+        "information thinking working"},
+    {Stemmer::GERMAN,
+        u8"der die und in den von zu das mit sich des auf f\u00fcr ist im dem nicht ein eine "
+        u8"als auch es an werden aus er hat dass sie nach wird bei einer um am sind noch wie "
+        u8"einem \u00fcber einen so zum war haben nur oder aber vor zur bis mehr durch man "
+        u8"sein wurde sehr schon wenn kann diese dieser zwischen immer ich wir ihr uns gegen "
+        u8"unter heute jahr zeit m\u00fcssen k\u00f6nnen leben arbeit"},
+    {Stemmer::FRENCH,
+        u8"de la le et les des en un du une que est pour qui dans par plus pas au sur ne se ce "
+        u8"il sont avec son cette elle ou mais comme nous vous leur ont \u00e9t\u00e9 "
+        u8"\u00eatre aussi m\u00eame tout fait ces aux bien sans peut tous deux entre "
+        u8"apr\u00e8s avoir encore tr\u00e8s o\u00f9 donc chez alors faire notre lui dont "
+        u8"depuis quand \u00e9tait"},
+    {Stemmer::SPANISH,
+        u8"de la que el en y a los del se las por un para con no una su al lo como m\u00e1s "
+        u8"pero sus le ya o este porque esta entre cuando muy sin sobre tambi\u00e9n me hasta "
+        u8"hay donde quien desde todo nos durante todos uno les ni contra otros ese eso ante "
+        u8"ellos est\u00e1 son fue ser hace puede tiene a\u00f1os hab\u00eda as\u00ed vez"},
+    {Stemmer::ITALIAN,
+        u8"di e il la che a per un in \u00e8 del non una sono della le si con da gli al come "
+        u8"ma pi\u00f9 anche nel questo alla lo dei ha delle se ci ne mi perch\u00e9 molto "
+        u8"essere quando tutti degli sul loro cos\u00ec stato fatto dopo nella solo sua suo "
+        u8"ancora questa tra fra sempre gi\u00e0 io noi anni"},
+    {Stemmer::PORTUGUESE,
+        u8"de a o que e do da em um para \u00e9 com n\u00e3o uma os no se na por mais as dos "
+        u8"como mas foi ao ele das tem \u00e0 seu sua ou ser quando muito h\u00e1 nos j\u00e1 "
+        u8"est\u00e1 eu tamb\u00e9m s\u00f3 pelo pela at\u00e9 isso ela entre era depois sem "
+        u8"mesmo aos ter seus quem nas esse eles est\u00e3o voc\u00ea tinha foram essa num nem "
+        u8"suas"},
+    {Stemmer::DUTCH,
+        "de van een het en in is dat op te zijn voor met die niet aan er om ook als dan maar "
+        "bij of uit nog wordt door naar worden heeft hij over zo kan deze zou al wel geen "
+        "moet hebben werd wat veel wij zij zich haar mijn tot omdat tegen onder jaar tussen "
+        "nieuwe goed"},
+    {Stemmer::DANISH,
+        u8"og i at det en den til er som p\u00e5 de med han af for ikke der var mig sig men et "
+        u8"har om vi min havde ham hun nu over da fra du ud sin dem os op man hans hvor eller "
+        u8"hvad skal selv her alle vil blev kunne ind n\u00e5r v\u00e6re noget ville deres "
+        u8"efter ogs\u00e5 meget skulle denne dette mod disse hvis nogle blive mange bliver "
+        u8"v\u00e6ret s\u00e5dan"},
+    {Stemmer::NORWEGIAN,
+        u8"og i jeg det at en et den til er som p\u00e5 de med han av ikke der s\u00e5 var meg "
+        u8"seg men har om vi min hadde hun n\u00e5 over da ved fra du ut sin dem oss opp man "
+        u8"kan hans hvor eller hva skal selv her alle vil bli ble kunne inn n\u00e5r v\u00e6re "
+        u8"noen noe ville etter ogs\u00e5 mye mellom bare fordi f\u00f8r hvorfor dette disse "
+        u8"uten hvordan ingen blir samme hver hvem b\u00e5de enn siden"},
+    {Stemmer::SWEDISH,
+        u8"och det att i en jag hon som han p\u00e5 den med var sig f\u00f6r s\u00e5 till "
+        u8"\u00e4r men ett om hade de av icke mig du henne d\u00e5 sin nu har inte hans honom "
+        u8"skulle hennes d\u00e4r min man ej vid kunde n\u00e5got fr\u00e5n ut n\u00e4r efter "
+        u8"upp vi dem vara vad \u00f6ver \u00e4n dig kan sina h\u00e4r ha mot alla under "
+        u8"n\u00e5gon eller allt mycket sedan denna sj\u00e4lv detta utan varit hur ingen ni "
+        u8"bli blev oss dessa n\u00e5gra deras blir"},
+    {Stemmer::FINNISH,
+        u8"olla olen on ovat oli ja ei se ett\u00e4 h\u00e4n mutta kun niin tai jos my\u00f6s "
+        u8"kuin sen mit\u00e4 t\u00e4m\u00e4 siit\u00e4 joka ne he me te min\u00e4 sin\u00e4 "
+        u8"h\u00e4nen heid\u00e4n jotka kanssa vain sitten nyt viel\u00e4 mukaan koska "
+        u8"sek\u00e4 kaikki t\u00e4ss\u00e4 t\u00e4m\u00e4n voi ollut olisi ole mik\u00e4 "
+        u8"sit\u00e4 kuitenkin j\u00e4lkeen hyvin noin aina paljon"},
+    // и в не на я что он с как а то все ...
+    {Stemmer::RUSSIAN,
+        u8"\u0438 \u0432 \u043d\u0435 \u043d\u0430 \u044f \u0447\u0442\u043e \u043e\u043d "
+        u8"\u0441 \u043a\u0430\u043a \u0430 \u0442\u043e \u0432\u0441\u0435 \u043e\u043d\u0430 "
+        u8"\u0442\u0430\u043a \u0435\u0433\u043e \u043d\u043e \u0434\u0430 \u0442\u044b \u043a "
+        u8"\u0443 \u0436\u0435 \u0432\u044b \u0437\u0430 \u0431\u044b \u043f\u043e "
+        u8"\u0442\u043e\u043b\u044c\u043a\u043e \u0435\u0435 \u043c\u043d\u0435 "
+        u8"\u0431\u044b\u043b\u043e \u0432\u043e\u0442 \u043e\u0442 \u043c\u0435\u043d\u044f "
+        u8"\u0435\u0449\u0435 \u043d\u0435\u0442 \u043e \u0438\u0437 \u0435\u043c\u0443 "
+        u8"\u0442\u0435\u043f\u0435\u0440\u044c \u043a\u043e\u0433\u0434\u0430 "
+        u8"\u0434\u0430\u0436\u0435 \u043d\u0443 \u043b\u0438 \u0435\u0441\u043b\u0438 "
+        u8"\u0443\u0436\u0435 \u0438\u043b\u0438 \u043d\u0438 \u0431\u044b\u0442\u044c "
+        u8"\u0431\u044b\u043b \u043d\u0435\u0433\u043e \u0434\u043e \u0432\u0430\u0441 "
+        u8"\u043e\u043f\u044f\u0442\u044c \u0432\u0430\u043c \u0432\u0435\u0434\u044c "
+        u8"\u0442\u0430\u043c \u043f\u043e\u0442\u043e\u043c \u0441\u0435\u0431\u044f "
+        u8"\u043d\u0438\u0447\u0435\u0433\u043e \u043c\u043e\u0436\u0435\u0442 "
+        u8"\u043e\u043d\u0438 \u0442\u0443\u0442 \u0433\u0434\u0435 \u0435\u0441\u0442\u044c "
+        u8"\u043d\u0430\u0434\u043e \u043d\u0435\u0439 \u0434\u043b\u044f \u043c\u044b "
+        u8"\u0442\u0435\u0431\u044f \u0438\u0445 \u0447\u0435\u043c \u0431\u044b\u043b\u0430 "
+        u8"\u0441\u0430\u043c \u0431\u0435\u0437 \u0442\u043e\u0436\u0435 "
+        u8"\u0441\u0435\u0431\u0435 \u043f\u043e\u0434 \u0431\u0443\u0434\u0435\u0442 "
+        u8"\u0442\u043e\u0433\u0434\u0430 \u043a\u0442\u043e \u044d\u0442\u043e\u0442 "
+        u8"\u0442\u043e\u0433\u043e \u043f\u043e\u0442\u043e\u043c\u0443 "
+        u8"\u044d\u0442\u043e\u0433\u043e \u043a\u0430\u043a\u043e\u0439 "
+        u8"\u0441\u043e\u0432\u0441\u0435\u043c \u0437\u0434\u0435\u0441\u044c "
+        u8"\u044d\u0442\u043e\u043c \u043e\u0434\u0438\u043d \u043f\u043e\u0447\u0442\u0438 "
+        u8"\u043c\u043e\u0439 \u0442\u0435\u043c \u0447\u0442\u043e\u0431\u044b "
+        u8"\u0441\u0435\u0439\u0447\u0430\u0441 \u0431\u044b\u043b\u0438 "
+        u8"\u043c\u043e\u0436\u043d\u043e \u043f\u0440\u0438 \u043f\u043e\u0441\u043b\u0435 "
+        u8"\u043d\u0430\u0434 \u0431\u043e\u043b\u044c\u0448\u0435 "
+        u8"\u0447\u0435\u0440\u0435\u0437 \u044d\u0442\u0438 \u043d\u0430\u0441 "
+        u8"\u043f\u0440\u043e \u0432\u0441\u0435\u0433\u043e \u043d\u0438\u0445 "
+        u8"\u043c\u043d\u043e\u0433\u043e"},
+};
+
+constexpr uint32_t SPACE = ' ';
+constexpr uint64_t TRIGRAM_MASK = (1ULL<<63)-1;
+
+inline uint64_t hashTrigram(uint64_t trigram)
+{
+    // Fibonacci hashing - high bits are well mixed
+    return (trigram*11400714819323198485ULL)>>32;
+}
+
+inline uint64_t pushCodePoint(uint64_t window, uint32_t codePoint)
+{
+    // code point has at most 21 bits i.e. window keeps 3 code points
+    return ((window<<21)|codePoint) & TRIGRAM_MASK;
+}
+
+/*
+ * Call f(trigram) for trigrams of case folded words padded by space:
+ * "the" gives " th", "the" and "he ", "a" gives " a ". Beginning
+ * of text is word boundary. Iteration stops when f returns false.
+ */
+template<class F>
+void forEachTrigram(const char* p, const char* end, uint64_t& window, size_t& letters, F f)
+{
+    if(letters) {
+        letters = 0;
+        if(!f(pushCodePoint(window, SPACE))) {
+            return;
+        }
+    }
+    while(p < end) {
+        uint32_t c = utf8Decode(p, end);
+        bool letter;
+        if(c < 0x80) {
+            // ASCII fast path
+            c |= 0x20;
+            letter = c>='a' && c<='z';
+        } else {
+            letter = unicodeIsLetter(c);
+            c = unicodeFoldCase(c);
+        }
+        if(letter) {
+            if(!letters) {
+                window = SPACE;
+            }
+            window = pushCodePoint(window, c);
+            if(++letters > 1 && !f(window)) {
+                return;
+            }
+        } else if(letters) {
+            letters = 0;
+            if(!f(pushCodePoint(window, SPACE))) {
+                return;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+LanguageDetector::Evidence::Evidence()
+    : scores{},
+      trigrams{0},
+      matched{0},
+      window{0},
+      letters{0}
+{
+}
+
+LanguageDetector::LanguageDetector(Stemmer::Language defaultLanguage)
+    : defaultLanguage(defaultLanguage),
+      tableMask{0}
+{
+    unordered_map<uint64_t,array<unsigned,Stemmer::LANGUAGE_COUNT>> counts{};
+    array<unsigned,Stemmer::LANGUAGE_COUNT> totals{};
+    for(const LanguageSeed& seed:LANGUAGE_SEEDS) {
+        const char* end = seed.words+strlen(seed.words);
+        uint64_t window = 0;
+        size_t letters = 0;
+        auto count = [&](uint64_t trigram) {
+            counts[trigram][seed.language]++;
+            totals[seed.language]++;
+            return true;
+        };
+        forEachTrigram(seed.words, end, window, letters, count);
+        forEachTrigram(end, end, window, letters, count);
+    }
+
+    // table is at most half full
+    size_t tableSize = 1;
+    while(tableSize < 2*counts.size()) {
+        tableSize <<= 1;
+    }
+    tableMask = tableSize-1;
+    trigrams.assign(tableSize, 0);
+    indices.assign(tableSize, 0);
+
+    // Laplace smoothing so that trigram unknown to language is unlikely, but possible
+    const float vocabulary = counts.size();
+    profiles.reserve(counts.size());
+    for(const auto& c:counts) {
+        uint64_t slot = hashTrigram(c.first) & tableMask;
+        while(trigrams[slot]) {
+            slot = (slot+1) & tableMask;
+        }
+        trigrams[slot] = c.first;
+        indices[slot] = profiles.size();
+
+        profiles.push_back(array<float,Stemmer::LANGUAGE_COUNT>{});
+        for(int l=0; l<Stemmer::LANGUAGE_COUNT; l++) {
+            profiles.back()[l] = log((c.second[l]+1.f)/(totals[l]+vocabulary));
+        }
+    }
+}
+
+LanguageDetector::~LanguageDetector()
+{
+}
+
+void LanguageDetector::addTrigram(uint64_t trigram, Evidence& evidence) const
+{
+    evidence.trigrams++;
+    for(uint64_t slot = hashTrigram(trigram) & tableMask; trigrams[slot]; slot = (slot+1) & tableMask) {
+        if(trigrams[slot] == trigram) {
+            const array<float,Stemmer::LANGUAGE_COUNT>& p = profiles[indices[slot]];
+            evidence.matched++;
+            for(int l=0; l<Stemmer::LANGUAGE_COUNT; l++) {
+                evidence.scores[l] += p[l];
+            }
+            return;
+        }
+    }
+}
+
+void LanguageDetector::score(const char* begin, const char* end, Evidence& evidence) const
+{
+    forEachTrigram(begin, end, evidence.window, evidence.letters, [&](uint64_t trigram) {
+        addTrigram(trigram, evidence);
+        return evidence.trigrams < MAX_TRIGRAMS;
+    });
+}
+
+Stemmer::Language LanguageDetector::decide(const Evidence& evidence) const
+{
+    if(evidence.matched < MIN_TRIGRAMS) {
+        return defaultLanguage;
+    }
+
+    int best = defaultLanguage;
+    for(int l=0; l<Stemmer::LANGUAGE_COUNT; l++) {
+        if(evidence.scores[l] > evidence.scores[best]) {
+            best = l;
+        }
+    }
+    if(evidence.scores[best]-evidence.scores[defaultLanguage] < MARGIN*evidence.matched) {
+        return defaultLanguage;
+    }
+    return static_cast<Stemmer::Language>(best);
+}
+
+} // m8r namespace
@@ -0,0 +1,116 @@
+/*
+ language_detector.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_LANGUAGE_DETECTOR_H
+#define M8R_LANGUAGE_DETECTOR_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <vector>
+
+#include "../../../gear/string_utils.h"
+#include "chunk_provider.h"
+#include "stemmer/stemmer.h"
+
+namespace m8r {
+
+/**
+ * @brief Detect language of text so that it can be stemmed by the right stemmer.
+ *
+ * Detector is a naive Bayes classifier of character trigrams (case folded
+ * code points, words are padded by space). Trigram profiles of languages
+ * are built from the most frequent words of each language - they capture
+ * function words and common endings which is enough to distinguish
+ * languages of stemmers on a paragraph of text.
+ *
+ * Detection is cheap - only the first MAX_TRIGRAMS trigrams of text are
+ * scored and profiles are kept in open addressing table. Default language is returned if text is too short or if other
+ * language doesn't win w/ a clear margin.
+ */
+class LanguageDetector
+{
+public:
+    // paragraph is enough to detect language of N
+    static constexpr size_t MAX_TRIGRAMS = 200;
+    // fewer trigrams found in profiles give default language
+    static constexpr size_t MIN_TRIGRAMS = 10;
+    // language must beat default language by average log likelihood ratio per trigram
+    static constexpr float MARGIN = 0.15;
+
+    /**
+     * @brief Scores of languages collected from chunks of text.
+     */
+    struct Evidence {
+        std::array<float,Stemmer::LANGUAGE_COUNT> scores;
+        size_t trigrams;
+        size_t matched;
+        // last code points and number of letters of the current word
+        uint64_t window;
+        size_t letters;
+
+        explicit Evidence();
+    };
+
+private:
+    Stemmer::Language defaultLanguage;
+
+    // open addressing table: trigram (3 code points packed to 63b, 0 ~ empty slot) -> index of probabilities
+    std::vector<uint64_t> trigrams;
+    std::vector<uint32_t> indices;
+    uint64_t tableMask;
+    // log probability of trigram in languages
+    std::vector<std::array<float,Stemmer::LANGUAGE_COUNT>> profiles;
+
+public:
+    explicit LanguageDetector(Stemmer::Language defaultLanguage=Stemmer::ENGLISH);
+    LanguageDetector(const LanguageDetector&) = delete;
+    LanguageDetector(const LanguageDetector&&) = delete;
+    LanguageDetector &operator=(const LanguageDetector&) = delete;
+    LanguageDetector &operator=(const LanguageDetector&&) = delete;
+    ~LanguageDetector();
+
+    Stemmer::Language getDefaultLanguage() const { return defaultLanguage; }
+    size_t getProfilesSize() const { return profiles.size(); }
+
+    template<class ChunkProvider>
+    Stemmer::Language detect(const ChunkProvider& text) const {
+        Evidence evidence{};
+        text.forEachChunk([&](const char* begin, const char* end, bool) {
+            if(evidence.trigrams < MAX_TRIGRAMS) {
+                score(begin, end, evidence);
+            }
+        });
+        return decide(evidence);
+    }
+    Stemmer::Language detect(const std::string& text) const {
+        return detect(StringChunkProvider{text});
+    }
+
+    /**
+     * @brief Score trigrams of text chunk - chunk boundary is word boundary.
+     */
+    void score(const char* begin, const char* end, Evidence& evidence) const;
+    Stemmer::Language decide(const Evidence& evidence) const;
+
+private:
+    void addTrigram(uint64_t trigram, Evidence& evidence) const;
+};
+
+}
+#endif // M8R_LANGUAGE_DETECTOR_H
@@ -18,16 +18,52 @@
 */
 #include "lexicon.h"
 
+#include <algorithm>
+
 namespace m8r {
 
+constexpr Lexicon::WordId Lexicon::NO_WORD;
+
 Lexicon::Lexicon()
+    : weightsDirty{false},
+      prefixIndex{},
+      prefixIndexDirty{false}
 {
-    // inaccurate, but until the 1st word is added ;)
-    maxFrequency = 1;
 }
 
 Lexicon::~Lexicon()
 {
 }
 
+void Lexicon::findByPrefix(const std::string& prefix, size_t k, std::vector<WordId>& result) const
+{
+    if(prefixIndexDirty) {
+        // words w/o occurrences are not indexed
+        std::vector<WordId> sorted{};
+        for(WordId w=0; w<words.size(); w++) {
+            if(frequencies[w]>0) {
+                sorted.push_back(w);
+            }
+        }
+        std::sort(sorted.begin(), sorted.end(), [this](WordId a, WordId b) { return words[a]<words[b]; });
+
+        std::vector<std::string> sortedWords{};
+        std::vector<uint32_t> sortedFrequencies{};
+        sortedWords.reserve(sorted.size());
+        sortedFrequencies.reserve(sorted.size());
+        for(WordId w:sorted) {
+            sortedWords.push_back(words[w]);
+            sortedFrequencies.push_back(frequencies[w]);
+        }
+        prefixIndex.build(sortedWords, &sortedFrequencies);
+        prefixIndexDirty = false;
+    }
+
+    std::vector<std::pair<std::string,uint32_t>> found{};
+    prefixIndex.findPrefix(prefix, k, found);
+    for(const auto& f:found) {
+        result.push_back(find(f.first));
+    }
+}
+
 } // m8r namespace
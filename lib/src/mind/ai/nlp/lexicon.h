@@ -19,9 +19,10 @@
 #ifndef M8R_LEXICON_H
 #define M8R_LEXICON_H
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 #ifdef DO_MF_DEBUG
 #include <iostream>
@@ -29,6 +30,7 @@
 
 #include "../../../debug.h"
 #include "../../../gear/lang_utils.h"
+#include "../../../gear/trie.h"
 
 namespace m8r {
 
@@ -36,44 +38,31 @@ namespace m8r {
  * @brief Lexicon of all words w/ global frequencies.
  *
  * Lexicon is the *only* data structure in MF's AI that keeps words by *value*.
- * Other data structures use either pointers or references to be memory efficient.
- *
+ * Every word has dense integer ID (index of word in lexicon) - other data
+ * structures use IDs to be memory efficient and to compare words as integers.
+ * Word attributes are stored in flat vectors indexed by ID.
  */
 // IMPROVE Stanford GloVe lexicon w/ word attributes & semantic domains (configure > check existence > use OR skip)
 class Lexicon
 {
 public:
+    typedef uint32_t WordId;
 
-    struct WordEmbedding {
-        // IMPROVE consider use of ptr to map's key
-        std::string word;
-        int frequency;
-        float weight;
-
-        explicit WordEmbedding() {
-            frequency = 0;
-            weight = 0.;
-        }
-        explicit WordEmbedding(const std::string& ww, int f, float w) {
-            word = ww;
-            frequency = f;
-            weight = w;
-        }
-    };
-
+    static constexpr WordId NO_WORD = UINT32_MAX;
 
 private:
-    // map of word-to-frequency pairs for fast lookup and duplicity detection
-    // IMPROVE C++ SL uses map's comparator for string to do comparisons - thefore insert
-    //         complexity is O(log(n)) string comparisons. Consider TRIE data structure
-    //         instead.
-    std::map<std::string,WordEmbedding> m;
-
-    // sorted/ordered words by weight/frequency/... referencing/pointing to map
-    //std::vector<WordEmbedding*> words;
-
-    // keeping max word frequency for efficient weighs calculation
-    int maxFrequency;
+    // map of word-to-ID pairs for fast lookup and duplicity detection
+    std::unordered_map<std::string,WordId> ids;
+
+    // word attributes - vector index is word ID
+    std::vector<std::string> words;
+    std::vector<int> frequencies;
+    // weights are recalculated lazily - on the first read after frequencies change
+    mutable std::vector<float> weights;
+    mutable bool weightsDirty;
+    // prefix index w/ frequencies as weights - rebuilt lazily on the first prefix query after change
+    mutable Trie prefixIndex;
+    mutable bool prefixIndexDirty;
 
 public:
     explicit Lexicon();
@@ -83,36 +72,72 @@ public:
     Lexicon &operator=(const Lexicon&&) = delete;
     ~Lexicon();
 
-    size_t size() const { return m.size(); }
-    void clear() { m.clear(); }
-    const std::map<std::string,WordEmbedding>& get() const { return m; }
+    size_t size() const { return words.size(); }
+    void clear() {
+        ids.clear();
+        words.clear();
+        frequencies.clear();
+        weights.clear();
+        weightsDirty = false;
+        prefixIndex.clear();
+        prefixIndexDirty = false;
+    }
 
-    WordEmbedding* get(const std::string& word) {
-        std::map<std::string,WordEmbedding>::iterator i = m.find(word);
-        if(i != m.end()) {
-            return &i->second;
+    /**
+     * @brief Get ID of the word or NO_WORD if word is not in lexicon.
+     */
+    WordId find(const std::string& word) const {
+        auto i = ids.find(word);
+        if(i != ids.end()) {
+            return i->second;
         } else {
-            return nullptr;
+            return NO_WORD;
         }
     }
-    WordEmbedding* get(const std::string* word) {
-        return get(*word);
-    }
 
-    WordEmbedding* add(const std::string& word) {
-        WordEmbedding* result;
-        if((result=get(word)) != nullptr) {
-            ++result->frequency;
-            if(result->frequency>maxFrequency) maxFrequency=result->frequency;
-            return result;
+    /**
+     * @brief Add word occurrence(s) and get word's ID.
+     */
+    WordId add(const std::string& word, int count=1) {
+        auto i = ids.find(word);
+        weightsDirty = true;
+        prefixIndexDirty = true;
+        if(i != ids.end()) {
+            frequencies[i->second] += count;
+            return i->second;
         } else {
-            WordEmbedding we{word,1,0};
-            m[word] = we;
-            return &(m[word]);
+            WordId id = static_cast<WordId>(words.size());
+            ids[word] = id;
+            words.push_back(word);
+            frequencies.push_back(count);
+            weights.push_back(0.);
+            return id;
         }
     }
-    WordEmbedding* add(const std::string* word) {
-        return add(*word);
+
+    /**
+     * @brief Remove word occurrences - word w/ no occurrence is kept to keep IDs stable.
+     */
+    void remove(WordId id, int count=1) {
+        frequencies[id] = count<frequencies[id]?frequencies[id]-count:0;
+        weightsDirty = true;
+        prefixIndexDirty = true;
+    }
+
+    /**
+     * @brief Find at most k most frequent words w/ given prefix (e.g. for completion).
+     */
+    void findByPrefix(const std::string& prefix, size_t k, std::vector<WordId>& result) const;
+
+    const std::string& getWord(WordId id) const { return words[id]; }
+    int getFrequency(WordId id) const { return frequencies[id]; }
+    float getWeight(WordId id) const {
+        if(weightsDirty) recalculateWeights();
+        return weights[id];
+    }
+    const std::vector<float>& getWeights() const {
+        if(weightsDirty) recalculateWeights();
+        return weights;
     }
 
     /**
@@ -129,21 +154,27 @@ public:
      *   https://www.youtube.com/watch?v=KIT-LbvNt_I&list=PLBv09BD7ez_77rla9ZYx-OAdgo2r9USm4
      *
      */
-    void recalculateWeights() {
-        for(auto& e:m) {
-            e.second.weight =  1. - ((((float)e.second.frequency)/100.) / (((float)maxFrequency)/100.));
+    void recalculateWeights() const {
+        // max word frequency across all words in lexicon (frequencies may decrease)
+        int maxFrequency = 1;
+        for(int frequency:frequencies) {
+            if(frequency>maxFrequency) maxFrequency=frequency;
+        }
+        for(size_t i=0; i<weights.size(); i++) {
+            weights[i] =  1. - ((((float)frequencies[i])/100.) / (((float)maxFrequency)/100.));
 
             // IMPROVE fixed constant is eight too big or small
             // ensure max(w)'s weigh to be > 0
-            if(!e.second.weight) e.second.weight = 0.01;
+            if(!weights[i]) weights[i] = 0.01;
         }
+        weightsDirty = false;
     }
 
 #ifdef DO_MF_DEBUG
     void print() const {
-        MF_DEBUG("Lexicon[" << m.size() << "]:" << std::endl);
-        for(auto& e:m) {
-            MF_DEBUG("  " << e.second.word << "  " << e.second.frequency << "  " << e.second.weight << std::endl);
+        MF_DEBUG("Lexicon[" << words.size() << "]:" << std::endl);
+        for(size_t i=0; i<words.size(); i++) {
+            MF_DEBUG("  " << words[i] << "  " << frequencies[i] << "  " << getWeight(i) << std::endl);
         }
     }
 #endif
@@ -22,8 +22,28 @@ namespace m8r {
 
 using namespace std;
 
+constexpr unsigned char MarkdownTokenizer::CharTable::WORD;
+constexpr unsigned char MarkdownTokenizer::CharTable::DELIMITER;
+constexpr unsigned char MarkdownTokenizer::CharTable::HYPHEN;
+constexpr unsigned char MarkdownTokenizer::CharTable::UTF8;
+
+const MarkdownTokenizer::CharTable MarkdownTokenizer::charTable{};
+
+MarkdownTokenizer::CharTable::CharTable()
+{
+    for(unsigned c=0; c<256; c++) {
+        if(c<128) {
+            classes[c] = isNonAlpha(static_cast<char>(c)) ? DELIMITER : WORD;
+        } else {
+            classes[c] = UTF8;
+        }
+        lower[c] = c>='A' && c<='Z' ? static_cast<char>(c-'A'+'a') : static_cast<char>(c);
+    }
+    classes[static_cast<unsigned char>('-')] = HYPHEN;
+}
+
 MarkdownTokenizer::MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist)
-    : lexicon(lexicon), blacklist(blacklist), stemmer{}
+    : lexicon(lexicon), blacklist(blacklist), stemCache{}, languageDetector{}
 {
 }
 
@@ -31,7 +51,13 @@ MarkdownTokenizer::~MarkdownTokenizer()
 {
 }
 
-void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+void MarkdownTokenizer::tokenize(
+        CharProvider& md,
+        WordFrequencyList& wfl,
+        bool useBlacklist,
+        bool lowercase,
+        bool stem,
+        Stemmer::Language language)
 {
     // tokenize relationships
     bool parseRels=false;
@@ -125,12 +151,28 @@ void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool
         case '<':
         case '>':
         case '/':
-            handleWord(wfl, w, stem, useBlacklist);
+            handleWord(wfl, w, stem, useBlacklist, language);
             break;
         default:
             if(md.get() < 0) {
-                // skip HIGH Unicode chars
-                handleWord(wfl, w, stem, useBlacklist);
+                // UTF-8 sequence - letters are part of word, punctuation and symbols are delimiters
+                char sequence[4];
+                size_t length = 0;
+                sequence[length++] = md.get();
+                while(length<4 && md.hasNext() && (static_cast<unsigned char>(md.getLookahead())&0xC0) == 0x80) {
+                    sequence[length++] = md.next();
+                }
+                const char* p = sequence;
+                const uint32_t codePoint = utf8Decode(p, sequence+length);
+                if(p == sequence+length && unicodeIsLetter(codePoint)) {
+                    if(lowercase) {
+                        utf8Append(w, unicodeFoldCase(codePoint));
+                    } else {
+                        w.append(sequence, length);
+                    }
+                } else {
+                    handleWord(wfl, w, stem, useBlacklist, language);
+                }
             } else {
                 if(lowercase) {
                     w += tolower(md.get());
@@ -142,28 +184,56 @@ void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool
             break;
         }
     }
-
-    lexicon.recalculateWeights();
+    // word at the end of text
+    handleWord(wfl, w, stem, useBlacklist, language);
 }
 
-void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist)
+void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist, Stemmer::Language language)
 {
-    if(w.size()>1) {
+    // words w/ single letter are skipped (non-ASCII letter has 2-4 bytes)
+    if(w.size()>1 && (w.size()>4 || utf8Length(w)>1)) {
         // stem
         if(stem) {
-            w = stemmer.stem(w);
+            stemCache.stem(w, language);
         }
 
         // remove common words
         if(!useBlacklist || !blacklist.findWord(w)) {
             // increment token frequency
-            Lexicon::WordEmbedding* we = lexicon.add(w);
-            ++wfl[&(we->word)];
+            ++wfl[lexicon.add(w)];
         }
     }
     w.clear();
 }
 
+void MarkdownTokenizer::handleToken(
+        WordFrequencyList& wfl,
+        const StringView& token,
+        string& w,
+        bool lowercase,
+        bool stem,
+        bool useBlacklist,
+        Stemmer::Language language)
+{
+    if(token.size>1) {
+        if(lowercase) {
+            w.clear();
+            const char* end = token.data+token.size;
+            for(const char* p=token.data; p<end; ) {
+                if(static_cast<unsigned char>(*p) < 0x80) {
+                    w += charTable.lower[static_cast<unsigned char>(*p++)];
+                } else {
+                    // tokens contain valid UTF-8 letters only
+                    utf8Append(w, unicodeFoldCase(utf8Decode(p, end)));
+                }
+            }
+        } else {
+            w.assign(token.data, token.size);
+        }
+        handleWord(wfl, w, stem, useBlacklist, language);
+    }
+}
+
 bool MarkdownTokenizer::isNonAlpha(char c)
 {
     switch(c) {
@@ -23,11 +23,14 @@
 
 #include "../../../debug.h"
 #include "../../../gear/lang_utils.h"
+#include "../../../gear/string_utils.h"
 #include "../../../mind/ai/nlp/common_words_blacklist.h"
 #include "char_provider.h"
+#include "chunk_provider.h"
+#include "language_detector.h"
 #include "lexicon.h"
 #include "word_frequency_list.h"
-#include "stemmer/stemmer.h"
+#include "stemmer/stem_cache.h"
 
 namespace m8r {
 
@@ -37,8 +40,10 @@ namespace m8r {
  * On tokenization:
  *
  *   - hardcoded delimiters
+ *   - UTF-8 aware: non-ASCII letters are part of words, Unicode punctuation
+ *     and symbols are delimiters, case is folded by simple Unicode folding
  *   - filters out words w/ length <1
- *   - stems words (optional)
+ *   - stems words (optional) by stemmer of the given language
  *   - computes token frequency via Lexicon
  *
  * See also:
@@ -46,6 +51,25 @@ namespace m8r {
  */
 class MarkdownTokenizer
 {
+    /**
+     * @brief Byte classes and lower case bytes for table driven tokenization.
+     */
+    struct CharTable {
+        static constexpr unsigned char WORD = 0;
+        static constexpr unsigned char DELIMITER = 1;
+        // hyphen is part of word unless it's followed by hyphen
+        static constexpr unsigned char HYPHEN = 2;
+        // byte of UTF-8 sequence - decoded code point is either letter or delimiter
+        static constexpr unsigned char UTF8 = 3;
+
+        unsigned char classes[256];
+        char lower[256];
+
+        explicit CharTable();
+    };
+
+    static const CharTable charTable;
+
     Lexicon& lexicon;
 
     /**
@@ -53,7 +77,10 @@ class MarkdownTokenizer
      */
     CommonWordsBlacklist& blacklist;
 
-    Stemmer stemmer;
+    // stems are memoized as the most of words are repeated
+    StemCache stemCache;
+
+    LanguageDetector languageDetector;
 
 public:
     explicit MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist);
@@ -63,10 +90,85 @@ public:
     MarkdownTokenizer &operator=(const MarkdownTokenizer&&) = delete;
     ~MarkdownTokenizer();
 
+    StemCache& getStemCache() { return stemCache; }
+
+    /**
+     * @brief Detect language of text to choose stemmer.
+     */
+    template<class ChunkProvider>
+    Stemmer::Language detectLanguage(const ChunkProvider& text) const {
+        return languageDetector.detect(text);
+    }
+
     /**
      * @brief Tokenize a stream of characters.
      */
-    void tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+    void tokenize(
+            CharProvider& md,
+            WordFrequencyList& wfl,
+            bool useBlacklist=true,
+            bool lowercase=true,
+            bool stem=true,
+            Stemmer::Language language=Stemmer::ENGLISH);
+
+    /**
+     * @brief Tokenize chunks of text - fast path which gives the same words as tokenization of chars.
+     *
+     * Chunks are scanned directly (no virtual call per character), bytes are classified
+     * by table and words are views of chunks - only words which get to lexicon are copied
+     * (to the buffer which is reused).
+     */
+    template<class ChunkProvider>
+    void tokenizeChunks(
+            const ChunkProvider& text,
+            WordFrequencyList& wfl,
+            bool useBlacklist=true,
+            bool lowercase=true,
+            bool stem=true,
+            Stemmer::Language language=Stemmer::ENGLISH)
+    {
+        std::string w{};
+        text.forEachChunk([&](const char* begin, const char* end, bool newline) {
+            splitChunk(begin, end, newline, [&](const StringView& token) {
+                handleToken(wfl, token, w, lowercase, stem, useBlacklist, language);
+            });
+        });
+    }
+
+    /**
+     * @brief Split chunk of text to words (views of chunk).
+     *
+     * Chunk w/o newline is the end of text i.e. hyphen at its end is a delimiter
+     * - the same way as by tokenization of chars.
+     */
+    template<class F>
+    static void splitChunk(const char* begin, const char* end, bool newline, F emit) {
+        const char* word = begin;
+        for(const char* p=begin; p<end; ++p) {
+            const unsigned char c = charTable.classes[static_cast<unsigned char>(*p)];
+            if(c == CharTable::WORD || (c == CharTable::HYPHEN && (p+1<end ? p[1]!='-' : newline))) {
+                continue;
+            }
+            const char* next = p+1;
+            if(c == CharTable::UTF8) {
+                const char* sequenceEnd = p;
+                const bool letter = unicodeIsLetter(utf8Decode(sequenceEnd, end));
+                next = sequenceEnd;
+                if(letter) {
+                    p = next-1;
+                    continue;
+                }
+            }
+            if(p > word) {
+                emit(StringView{word, static_cast<size_t>(p-word)});
+            }
+            word = next;
+            p = next-1;
+        }
+        if(end > word) {
+            emit(StringView{word, static_cast<size_t>(end-word)});
+        }
+    }
 
     /**
      * @brief Remove non-alpha numeric characters from the 1st word and return it.
@@ -84,7 +186,15 @@ public:
     static bool isNonAlpha(char c);
 
 private:
-    inline void handleWord(WordFrequencyList& wfl, std::string &w, bool stem, bool useBlacklist);
+    inline void handleWord(WordFrequencyList& wfl, std::string &w, bool stem, bool useBlacklist, Stemmer::Language language);
+    void handleToken(
+            WordFrequencyList& wfl,
+            const StringView& token,
+            std::string& w,
+            bool lowercase,
+            bool stem,
+            bool useBlacklist,
+            Stemmer::Language language);
 };
 
 }
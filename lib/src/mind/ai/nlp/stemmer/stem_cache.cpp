@@ -0,0 +1,100 @@
+/*
+ stem_cache.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "stem_cache.h"
+
+namespace m8r {
+
+using namespace std;
+
+constexpr size_t StemCache::DEFAULT_CAPACITY;
+
+StemCache::StemCache(size_t capacity)
+    : stemmer{},
+      capacity(capacity?capacity:1),
+      lookups{0},
+      hits{0},
+      evictions{0}
+{
+}
+
+StemCache::~StemCache()
+{
+}
+
+void StemCache::stem(string& word, Stemmer::Language language)
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+
+    lookups++;
+    // language is appended to the key in place so that lookup doesn't allocate
+    word += static_cast<char>(language);
+    auto s = surfaces.find(word);
+    if(s != surfaces.end()) {
+        hits++;
+        word.assign(stems[s->second]);
+        return;
+    }
+
+    if(surfaces.size() >= capacity) {
+        surfaces.clear();
+        stems.clear();
+        stemIds.clear();
+        evictions++;
+    }
+
+    string stem = stemmer.stem(word.substr(0, word.size()-1), language);
+    auto id = stemIds.insert(std::make_pair(stem, static_cast<uint32_t>(stems.size())));
+    if(id.second) {
+        stems.push_back(stem);
+    }
+    surfaces[word] = id.first->second;
+    word.swap(stem);
+}
+
+size_t StemCache::size()
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    return surfaces.size();
+}
+
+size_t StemCache::getLookups()
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    return lookups;
+}
+
+size_t StemCache::getHits()
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    return hits;
+}
+
+size_t StemCache::getEvictions()
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    return evictions;
+}
+
+float StemCache::getHitRate()
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    return lookups?static_cast<float>(hits)/lookups:0;
+}
+
+} // m8r namespace
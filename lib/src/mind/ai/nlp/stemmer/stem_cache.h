@@ -0,0 +1,89 @@
+/*
+ stem_cache.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_STEM_CACHE_H
+#define M8R_STEM_CACHE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+#include "stemmer.h"
+
+namespace m8r {
+
+/**
+ * @brief Bounded memo of stemmer results.
+ *
+ * Stemming of a word converts it to wide string and back, while vocabulary
+ * of natural language is skewed i.e. the most of word occurrences are
+ * repetitions of few surface forms. Cache maps surface form to stem ID
+ * (stems shared by more surface forms are stored once) so that stemming
+ * of a known surface form costs one hash lookup.
+ *
+ * Cache is bounded - when it's full, it's cleared and warmed up again.
+ * Cache is thread safe (stemmer is called under lock).
+ */
+class StemCache
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1<<16;
+
+private:
+    Stemmer stemmer;
+
+    const size_t capacity;
+
+    std::mutex cacheMutex;
+    // surface form w/ language suffix -> stem ID (index of stem)
+    std::unordered_map<std::string,uint32_t> surfaces;
+    std::vector<std::string> stems;
+    std::unordered_map<std::string,uint32_t> stemIds;
+
+    size_t lookups;
+    size_t hits;
+    size_t evictions;
+
+public:
+    explicit StemCache(size_t capacity=DEFAULT_CAPACITY);
+    StemCache(const StemCache&) = delete;
+    StemCache(const StemCache&&) = delete;
+    StemCache &operator=(const StemCache&) = delete;
+    StemCache &operator=(const StemCache&&) = delete;
+    ~StemCache();
+
+    /**
+     * @brief Replace word w/ its stem in given language.
+     */
+    void stem(std::string& word, Stemmer::Language language=Stemmer::ENGLISH);
+
+    size_t getCapacity() const { return capacity; }
+    size_t size();
+    size_t getLookups();
+    size_t getHits();
+    size_t getEvictions();
+    /**
+     * @brief Get hit rate in [0,1] since construction.
+     */
+    float getHitRate();
+};
+
+}
+#endif // M8R_STEM_CACHE_H
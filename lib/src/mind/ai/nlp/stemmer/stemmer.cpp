@@ -22,6 +22,8 @@ namespace m8r {
 
 using namespace std;
 
+constexpr int Stemmer::LANGUAGE_COUNT;
+
 Stemmer::Stemmer()
 {
     language = ENGLISH;
@@ -31,15 +33,64 @@ Stemmer::~Stemmer()
 {
 }
 
-string Stemmer::stem(string word)
+const char* Stemmer::getLanguageName(Language lang)
+{
+    static const char* names[LANGUAGE_COUNT] = {
+        "English", "German", "French", "Spanish", "Italian", "Portuguese",
+        "Dutch", "Danish", "Norwegian", "Swedish", "Finnish", "Russian"
+    };
+    return names[lang];
+}
+
+string Stemmer::stem(const string& word, Language lang)
 {
     // IMPROVE: despite stemmer works in wstring mode, MindForger runs just in string mode - wstring to come later when entire application is switched
-    std::wstringstream swide;
-    swide << word.c_str();
-    wstring wide = swide.str();
+    wstring wide;
+    try {
+        wide = converter.from_bytes(word);
+    } catch(const range_error&) {
+        return word;
+    }
 
-    // IMPROVE switch by language (configuration)
-    StemEnglish(wide);
+    switch(lang) {
+    case GERMAN:
+        StemGerman(wide);
+        break;
+    case FRENCH:
+        StemFrench(wide);
+        break;
+    case SPANISH:
+        StemSpanish(wide);
+        break;
+    case ITALIAN:
+        StemItalian(wide);
+        break;
+    case PORTUGUESE:
+        StemPortuguese(wide);
+        break;
+    case DUTCH:
+        StemDutch(wide);
+        break;
+    case DANISH:
+        StemDanish(wide);
+        break;
+    case NORWEGIAN:
+        StemNorwgian(wide);
+        break;
+    case SWEDISH:
+        StemSwedish(wide);
+        break;
+    case FINNISH:
+        StemFinnish(wide);
+        break;
+    case RUSSIAN:
+        StemRussian(wide);
+        break;
+    case ENGLISH:
+    default:
+        StemEnglish(wide);
+        break;
+    }
 
     return converter.to_bytes(wide);
 }
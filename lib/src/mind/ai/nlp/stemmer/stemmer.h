@@ -43,14 +43,30 @@ namespace m8r {
 class Stemmer
 {
 public:
+    /**
+     * @brief Languages of bundled Snowball stemmers.
+     */
     enum Language {
-        ENGLISH
+        ENGLISH,
+        GERMAN,
+        FRENCH,
+        SPANISH,
+        ITALIAN,
+        PORTUGUESE,
+        DUTCH,
+        DANISH,
+        NORWEGIAN,
+        SWEDISH,
+        FINNISH,
+        RUSSIAN
     };
+    static constexpr int LANGUAGE_COUNT = RUSSIAN+1;
 
 private:
     Language language;
 
     stemming::english_stem<> StemEnglish;
+    stemming::french_stem<> StemFrench;
     stemming::german_stem<> StemGerman;
     stemming::finnish_stem<> StemFinnish;
     stemming::swedish_stem<> StemSwedish;
@@ -60,6 +76,7 @@ private:
     stemming::norwegian_stem<> StemNorwgian;
     stemming::danish_stem<> StemDanish;
     stemming::portuguese_stem<> StemPortuguese;
+    stemming::russian_stem<> StemRussian;
 
     std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
@@ -73,7 +90,16 @@ public:
 
     void setLanguage(Language lang) { this->language = lang; }
 
-    std::string stem(std::string word);
+    static const char* getLanguageName(Language lang);
+
+    /**
+     * @brief Stem UTF-8 word using stemmer of the current language.
+     */
+    std::string stem(std::string word) { return stem(word, language); }
+    /**
+     * @brief Stem UTF-8 word using stemmer of given language - invalid UTF-8 is not stemmed.
+     */
+    std::string stem(const std::string& word, Language lang);
 };
 
 }
@@ -39,18 +39,41 @@ void WordFrequencyList::sort() {
     // reset array
     wordsByWeight.clear();
 
-    for(auto& w:word2Frequency) {
-        wordsByWeight.push_back(&w);
-    }
+    wordsByWeight.assign(word2Frequency.begin(), word2Frequency.end());
     std::sort(wordsByWeight.begin(),wordsByWeight.end(),wordWeightComparator);
 }
 
+void WordFrequencyList::buildRelevantWords(size_t count) {
+    relevantWords.clear();
+    for(size_t i=0; i<wordsByWeight.size() && i<count; i++) {
+        relevantWords.push_back(
+            RelevantWord{wordsByWeight[i].first, wordsByWeight[i].second, lexicon->getWeight(wordsByWeight[i].first)});
+    }
+    // ordered by ID so that vectors can be compared by merge
+    std::sort(
+        relevantWords.begin(),
+        relevantWords.end(),
+        [](const RelevantWord& w1, const RelevantWord& w2) { return w1.word < w2.word; });
+}
+
+void WordFrequencyList::freezeWeights(std::vector<float>& weights) {
+    for(RelevantWord& w:relevantWords) {
+        if(w.word >= weights.size()) {
+            weights.resize(w.word+1, float{UNDEF_WEIGHT});
+        }
+        if(weights[w.word] == UNDEF_WEIGHT) {
+            weights[w.word] = w.weight;
+        } else {
+            w.weight = weights[w.word];
+        }
+    }
+}
+
 float WordFrequencyList::recalculateWeight() {
     weight = 0;
     for(auto& w:word2Frequency) {
-        Lexicon::WordEmbedding* e = lexicon->get(w.first);
-        // IMPROVE if(e) result += e->weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
-        if(e) weight += e->weight;
+        // IMPROVE result += weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
+        weight += lexicon->getWeight(w.first);
     }
     return weight;
 }
@@ -45,18 +45,29 @@ class WordFrequencyList
         Lexicon *l;
         WordWeightComparator(Lexicon* l) : l(l) {}
 
-        // functor to compare words by weight
+        // functor to compare words by weight (words w/ the same weight by ID to get stable order)
         bool operator()(
-                const std::pair<const std::string* const,int>*const& p1,
-                const std::pair<const std::string* const,int>*const& p2
+                const std::pair<Lexicon::WordId,int>& p1,
+                const std::pair<Lexicon::WordId,int>& p2
         ) {
-            return l->get(p1->first)->weight > l->get(p2->first)->weight;
+            float w1 = l->getWeight(p1.first);
+            float w2 = l->getWeight(p2.first);
+            return w1 > w2 || (w1 == w2 && p1.first < p2.first);
         }
     };
 
 public:
     static constexpr float UNDEF_WEIGHT = -1;
 
+    /**
+     * @brief Word of sparse vector w/ frequency and (lexicon) weight.
+     */
+    struct RelevantWord {
+        Lexicon::WordId word;
+        int frequency;
+        float weight;
+    };
+
     static void evalUnion(WordFrequencyList& l1, WordFrequencyList& l2, WordFrequencyList& u)
     {
         // IMPROVE u.iterable().insert(l1.iterable().begin(),l1.iterable().end());
@@ -86,14 +97,19 @@ private:
     float weight;
 
     /**
-     * @brief List of words occuring in a Thing ordered by weight.
+     * @brief List of words (IDs w/ frequencies) occuring in a Thing ordered by weight.
      */
-    std::vector<std::pair<const std::string *const,int>*> wordsByWeight;
+    std::vector<std::pair<Lexicon::WordId,int>> wordsByWeight;
 
     /**
      * @brief TRANSIENT map used for quick inserts (can be cleared once list is built).
      */
-    std::map<const std::string*,int> word2Frequency;
+    std::map<Lexicon::WordId,int> word2Frequency;
+
+    /**
+     * @brief Sparse vector of words w/ the highest weight ordered by word ID.
+     */
+    std::vector<RelevantWord> relevantWords;
 
 public:
     explicit WordFrequencyList(Lexicon* lexicon);
@@ -103,9 +119,14 @@ public:
     WordFrequencyList &operator=(const WordFrequencyList&&) = delete;
     ~WordFrequencyList();
 
-    int& operator[](std::string* key) { return word2Frequency[key]; }
+    int& operator[](Lexicon::WordId key) { weight = UNDEF_WEIGHT; return word2Frequency[key]; }
     size_t size() const { return word2Frequency.size(); }
-    const std::map<const std::string*,int>& iterable() const { return word2Frequency; }
+    const std::map<Lexicon::WordId,int>& iterable() const { return word2Frequency; }
+    /**
+     * @brief Get words ordered by weight - valid after sort().
+     */
+    const std::vector<std::pair<Lexicon::WordId,int>>& byWeight() const { return wordsByWeight; }
+    const std::vector<RelevantWord>& getRelevantWords() const { return relevantWords; }
 
     float getWeight() {
         if(weight==UNDEF_WEIGHT) {
@@ -115,8 +136,8 @@ public:
         }
     }
 
-    int contains(const std::string* word) {
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
+    int contains(Lexicon::WordId word) const {
+        std::map<Lexicon::WordId,int>::const_iterator i = word2Frequency.find(word);
         if(i != word2Frequency.end()) {
             return true;
         } else {
@@ -124,28 +145,45 @@ public:
         }
     }
 
-    int add(const std::string* word) {
+    int add(Lexicon::WordId word) {
         weight = UNDEF_WEIGHT;
 
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
+        std::map<Lexicon::WordId,int>::iterator i = word2Frequency.find(word);
         if(i != word2Frequency.end()) {
-            ++i->second;
-            return word2Frequency[word];
+            return ++i->second;
         } else {
             word2Frequency[word] = 1;
             return 1;
         }
     }
 
-    void set(const std::string* word, int frequency) {
+    void set(Lexicon::WordId word, int frequency) {
         word2Frequency[word] = frequency;
     }
 
+    /**
+     * @brief Set sparse vector of relevant words (e.g. restored from AI model) - words must be ordered by ID.
+     */
+    void setRelevantWords(std::vector<RelevantWord>& words) {
+        relevantWords.swap(words);
+    }
+
     /**
      * @brief Sort words by weight.
      */
     void sort();
 
+    /**
+     * @brief Build sparse vector of (at most) given number of words w/ the highest weight - valid after sort().
+     */
+    void buildRelevantWords(size_t count);
+
+    /**
+     * @brief Make weights of relevant words consistent w/ other vectors: words w/ frozen
+     * weight get it, weights of other words (UNDEF_WEIGHT in weights) are frozen.
+     */
+    void freezeWeights(std::vector<float>& weights);
+
     /**
      * @brief Get weight of vector words.
      */
@@ -155,12 +193,12 @@ public:
     void print() const {
         std::cout << "WordFrequencyList[" << word2Frequency.size() << "]:" << std::endl;
         for(auto& w:wordsByWeight) {
-            std::cout << "  " << (*w->first) << " [" << w->second << "] " << std::endl;
+            std::cout << "  " << lexicon->getWord(w.first) << " [" << w.second << "] " << std::endl;
         }
     }
     void printFlat() const {
         for(auto& w:wordsByWeight) {
-            std::cout << (*w->first) << " [" << w->second << "] ";
+            std::cout << lexicon->getWord(w.first) << " [" << w.second << "] ";
         }
     }
 #endif
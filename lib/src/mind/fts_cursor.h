@@ -0,0 +1,54 @@
+/*
+ fts_cursor.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_FTS_CURSOR_H
+#define M8R_FTS_CURSOR_H
+
+#include <cstdint>
+
+namespace m8r {
+
+/**
+ * @brief Position in ranked FTS results.
+ *
+ * Results are ranked by descending score, ties are ordered as outlines
+ * and notes are ordered in memory. Cursor remembers rank of the last
+ * delivered result i.e. next page is computed from results ranked after
+ * it w/o keeping the whole result set. Cursor is valid until memory
+ * is modified.
+ */
+struct FtsCursor
+{
+    bool begin;
+    int score;
+    uint64_t order;
+
+    FtsCursor() : begin(true), score(0), order(0) {}
+
+    void reset() { begin = true; score = 0; order = 0; }
+
+    /**
+     * @brief Is result w/ given rank after the cursor?
+     */
+    bool isBefore(int score, uint64_t order) const {
+        return begin || score < this->score || (score == this->score && order > this->order);
+    }
+};
+
+}
+#endif // M8R_FTS_CURSOR_H
@@ -0,0 +1,280 @@
+/*
+ fts_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fts_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "../gear/string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+namespace {
+
+inline bool isTermChar(unsigned char c)
+{
+    return (c>='a' && c<='z') || (c>='A' && c<='Z') || (c>='0' && c<='9') || c>=0x80;
+}
+
+void collectTrigrams(const string& s, vector<uint32_t>& trigrams)
+{
+    for(size_t i=2; i<s.size(); i++) {
+        trigrams.push_back(
+            (static_cast<uint32_t>(static_cast<unsigned char>(s[i-2]))<<16)
+              | (static_cast<uint32_t>(static_cast<unsigned char>(s[i-1]))<<8)
+              | static_cast<unsigned char>(s[i]));
+    }
+}
+
+void sortUnique(vector<uint32_t>& v)
+{
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+// split lower case text to terms
+void splitTerms(const string& s, vector<string>& terms)
+{
+    size_t begin = string::npos;
+    for(size_t i=0; i<s.size(); i++) {
+        if(isTermChar(s[i])) {
+            if(begin==string::npos) {
+                begin = i;
+            }
+        } else if(begin!=string::npos) {
+            terms.push_back(s.substr(begin, i-begin));
+            begin = string::npos;
+        }
+    }
+    if(begin!=string::npos) {
+        terms.push_back(s.substr(begin));
+    }
+}
+
+// drop removed documents from the sorted list and renumber the rest
+bool compactList(vector<uint32_t>& list, const vector<uint32_t>& ids, const vector<bool>& live)
+{
+    size_t w = 0;
+    for(size_t r=0; r<list.size(); r++) {
+        if(live[list[r]]) {
+            list[w++] = ids[list[r]];
+        }
+    }
+    list.resize(w);
+    return w;
+}
+
+} // anonymous namespace
+
+FtsIndex::FtsIndex()
+    : removedDocuments(0)
+{
+}
+
+FtsIndex::~FtsIndex()
+{
+}
+
+void FtsIndex::tokenize(const string& text, vector<string>& terms)
+{
+    // lower case the whole text so that terms are consistent with case insensitive FTS
+    string s{};
+    stringToLower(text, s);
+    splitTerms(s, terms);
+}
+
+void FtsIndex::clear()
+{
+    trigrams.clear();
+    foldedTrigrams.clear();
+    documents.clear();
+    outlineDocuments.clear();
+    removedDocuments = 0;
+}
+
+void FtsIndex::addText(const string& text, vector<uint32_t>& textTrigrams, vector<uint32_t>& textFoldedTrigrams)
+{
+    string s{};
+    stringToLower(text, s);
+
+    // trigrams are collected per line as FTS doesn't match strings across lines
+    collectTrigrams(text, textTrigrams);
+    collectTrigrams(s, textFoldedTrigrams);
+}
+
+void FtsIndex::addDocument(const Outline* outline, const Note* note, const string& name, const vector<string*>& description)
+{
+    uint32_t document = static_cast<uint32_t>(documents.size());
+    documents.push_back(Document{outline, note});
+    outlineDocuments[outline].push_back(document);
+
+    vector<uint32_t> documentTrigrams{}, documentFoldedTrigrams{};
+    addText(name, documentTrigrams, documentFoldedTrigrams);
+    for(const string* d:description) {
+        if(d) {
+            addText(*d, documentTrigrams, documentFoldedTrigrams);
+        }
+    }
+
+    // document IDs are increasing i.e. trigram lists stay sorted
+    sortUnique(documentTrigrams);
+    for(uint32_t t:documentTrigrams) {
+        trigrams[t].push_back(document);
+    }
+    sortUnique(documentFoldedTrigrams);
+    for(uint32_t t:documentFoldedTrigrams) {
+        foldedTrigrams[t].push_back(document);
+    }
+}
+
+void FtsIndex::add(const Outline* outline)
+{
+    remove(outline);
+
+    addDocument(outline, nullptr, outline->getName(), outline->getDescription());
+    for(const Note* note:outline->getNotes()) {
+        addDocument(outline, note, note->getName(), note->getDescription());
+    }
+}
+
+void FtsIndex::remove(const Outline* outline)
+{
+    auto i = outlineDocuments.find(outline);
+    if(i == outlineDocuments.end()) {
+        return;
+    }
+
+    // postings of removed documents are dropped lazily on compaction
+    for(uint32_t document:i->second) {
+        documents[document].outline = nullptr;
+    }
+    removedDocuments += i->second.size();
+    outlineDocuments.erase(i);
+
+    if(removedDocuments > documents.size()/2) {
+        compact();
+    }
+}
+
+void FtsIndex::compact()
+{
+    vector<uint32_t> ids(documents.size());
+    vector<bool> live(documents.size());
+    vector<Document> compacted{};
+    compacted.reserve(documents.size()-removedDocuments);
+    for(size_t d=0; d<documents.size(); d++) {
+        if(documents[d].outline) {
+            ids[d] = static_cast<uint32_t>(compacted.size());
+            live[d] = true;
+            compacted.push_back(documents[d]);
+        }
+    }
+
+    for(auto lists:{&trigrams, &foldedTrigrams}) {
+        for(auto i=lists->begin(); i!=lists->end(); ) {
+            if(compactList(i->second, ids, live)) {
+                ++i;
+            } else {
+                i = lists->erase(i);
+            }
+        }
+    }
+
+    for(auto& o:outlineDocuments) {
+        for(uint32_t& document:o.second) {
+            document = ids[document];
+        }
+    }
+
+    documents.swap(compacted);
+    removedDocuments = 0;
+}
+
+void FtsIndex::findTrigrams(const string& s, bool ignoreCase, vector<uint32_t>& matches) const
+{
+    vector<uint32_t> keys{};
+    if(ignoreCase) {
+        string q{};
+        stringToLower(s, q);
+        collectTrigrams(q, keys);
+    } else {
+        collectTrigrams(s, keys);
+    }
+    sortUnique(keys);
+
+    const unordered_map<uint32_t,vector<uint32_t>>& index = ignoreCase?foldedTrigrams:trigrams;
+    vector<const vector<uint32_t>*> lists{};
+    for(uint32_t key:keys) {
+        auto list = index.find(key);
+        if(list == index.end()) {
+            return;
+        }
+        lists.push_back(&list->second);
+    }
+
+    // intersect from the shortest list
+    std::sort(
+        lists.begin(),
+        lists.end(),
+        [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+    matches = *lists[0];
+    vector<uint32_t> intersection{};
+    for(size_t l=1; l<lists.size() && !matches.empty(); l++) {
+        intersection.clear();
+        std::set_intersection(
+            matches.begin(), matches.end(),
+            lists[l]->begin(), lists[l]->end(),
+            back_inserter(intersection));
+        matches.swap(intersection);
+    }
+}
+
+bool FtsIndex::find(const string& s, bool ignoreCase, Candidates& candidates) const
+{
+    candidates.clear();
+
+    // strings shorter than trigram match too many documents to be worth indexing
+    if(s.size() < 3) {
+        return false;
+    }
+    vector<uint32_t> matches{};
+    findTrigrams(s, ignoreCase, matches);
+    // not selective query - scan is cheaper than candidates lookup
+    if(matches.size() > documents.size()/2) {
+        return false;
+    }
+
+    for(uint32_t match:matches) {
+        const Document& document = documents[match];
+        if(document.outline) {
+            candidates.outlines.insert(document.outline);
+            if(document.note) {
+                candidates.notes.insert(document.note);
+            } else {
+                candidates.descriptors.insert(document.outline);
+            }
+        }
+    }
+
+    return true;
+}
+
+} // m8r namespace
@@ -0,0 +1,119 @@
+/*
+ fts_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_FTS_INDEX_H_
+#define M8R_FTS_INDEX_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+#include "../model/outline.h"
+#include "../model/note.h"
+
+namespace m8r {
+
+/**
+ * @brief Full-text search inverted index.
+ *
+ * Document is either outline descriptor (name and description of outline)
+ * or note. Index maps trigrams (3 bytes) of name and description lines
+ * to sorted lists of documents - both case sensitive and case folded
+ * variants.
+ *
+ * Index is used to narrow FTS to candidate documents: strings of at least
+ * 3 characters are searched by intersection of trigram lists, shorter
+ * strings are left to linear scan. Candidates are guaranteed to be superset
+ * of documents which contain searched string, therefore caller must verify
+ * candidates using substring match. Documents are referenced by pointers
+ * which are used as keys only and never dereferenced.
+ *
+ * Outlines are (re)indexed as a whole on learn/remember/forget.
+ */
+class FtsIndex
+{
+public:
+    struct Candidates {
+        // outlines with at least one candidate document
+        std::unordered_set<const Outline*> outlines;
+        // outlines with candidate outline descriptor
+        std::unordered_set<const Outline*> descriptors;
+        std::unordered_set<const Note*> notes;
+
+        void clear() { outlines.clear(); descriptors.clear(); notes.clear(); }
+    };
+
+private:
+    struct Document {
+        // nullptr if document was removed
+        const Outline* outline;
+        // nullptr for outline descriptor
+        const Note* note;
+    };
+
+    std::unordered_map<uint32_t,std::vector<uint32_t>> trigrams;
+    std::unordered_map<uint32_t,std::vector<uint32_t>> foldedTrigrams;
+    std::vector<Document> documents;
+    std::unordered_map<const Outline*,std::vector<uint32_t>> outlineDocuments;
+    size_t removedDocuments;
+
+public:
+    explicit FtsIndex();
+    FtsIndex(const FtsIndex&) = delete;
+    FtsIndex(const FtsIndex&&) = delete;
+    FtsIndex &operator=(const FtsIndex&) = delete;
+    FtsIndex &operator=(const FtsIndex&&) = delete;
+    ~FtsIndex();
+
+    /**
+     * @brief Split text to lower case terms - term is a maximal sequence
+     *        of alphanumeric or non-ASCII characters.
+     */
+    static void tokenize(const std::string& text, std::vector<std::string>& terms);
+
+    void clear();
+
+    /**
+     * @brief Index outline - outline which is already indexed is reindexed.
+     */
+    void add(const Outline* outline);
+    void remove(const Outline* outline);
+    bool contains(const Outline* outline) const { return outlineDocuments.find(outline)!=outlineDocuments.end(); }
+
+    /**
+     * @brief Find candidate documents which may contain given string.
+     * @return false if index cannot answer the query (string shorter than trigram
+     *         or not selective string) and linear scan must be used instead.
+     */
+    bool find(const std::string& s, bool ignoreCase, Candidates& candidates) const;
+
+    size_t getTrigramsCount() const { return trigrams.size(); }
+    size_t getDocumentsCount() const { return documents.size()-removedDocuments; }
+
+private:
+    void addText(const std::string& text, std::vector<uint32_t>& textTrigrams, std::vector<uint32_t>& textFoldedTrigrams);
+    void addDocument(const Outline* outline, const Note* note, const std::string& name, const std::vector<std::string*>& description);
+    void findTrigrams(const std::string& s, bool ignoreCase, std::vector<uint32_t>& matches) const;
+    void compact();
+};
+
+} // m8r namespace
+
+#endif /* M8R_FTS_INDEX_H_ */
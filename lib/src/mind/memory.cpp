@@ -32,6 +32,8 @@ Memory::Memory(Configuration& configuration)
     persistence = new FilesystemPersistence{representation};
     cache = true;
     mindScope = nullptr;
+    snapshot = true;
+    setLearnThreads(thread::hardware_concurrency());
 }
 
 vector<Stencil*>& Memory::getStencils(ResourceType type)
@@ -59,8 +61,24 @@ void Memory::learn()
 
     if(config.getActiveRepository()->getMode() == Repository::RepositoryMode::REPOSITORY) {
         MF_DEBUG(endl << "Markdown files:");
-        for(const string* markdownFile:repositoryIndexer.getMarkdownFiles()) {
-            Outline* outline = representation.outline(File(*markdownFile));
+        const set<const string*> markdownFilesSet = repositoryIndexer.getMarkdownFiles();
+        vector<const string*> markdownFiles{markdownFilesSet.begin(), markdownFilesSet.end()};
+        vector<Outline*> parsedOutlines{};
+        size_t parsedCount;
+        map<string,MemorySnapshot::Fingerprint> fingerprints{};
+        MemorySnapshot memorySnapshot{ontology};
+        if(snapshot) {
+            memorySnapshot.open(config.getMemorySnapshotPath());
+            parsedCount = learnOutlines(markdownFiles, parsedOutlines, &memorySnapshot, &fingerprints);
+        } else {
+            parsedCount = learnOutlines(markdownFiles, parsedOutlines);
+        }
+        // virgin Os are not in snapshot i.e. they are parsed on every learning
+        size_t virginCount = 0;
+        // merge in the order of files so that Memory content doesn't depend on threads scheduling
+        for(size_t i=0; i<markdownFiles.size(); i++) {
+            const string* markdownFile = markdownFiles[i];
+            Outline* outline = parsedOutlines[i];
             MF_DEBUG(endl << "  '" << *markdownFile << "' format " << (outline->getFormat()==MarkdownDocument::Format::MINDFORGER?"MF":"MD"));
 
             // fix O type according to repository type
@@ -76,10 +94,24 @@ void Memory::learn()
             if(outline->isVirgin()) {
                 MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
                 delete outline;
+                virginCount++;
             } else {
                 outlines.push_back(outline);
                 outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+                ftsIndex.add(outline);
+            }
+        }
+
+        if(snapshot) {
+            MF_DEBUG(endl << "Outlines parsed: " << parsedCount << " / from snapshot: " << markdownFiles.size()-parsedCount);
+            // refresh snapshot only if it doesn't match repository
+            if(parsedCount>virginCount || memorySnapshot.size()!=outlines.size()) {
+                memorySnapshot.close();
+                if(!MemorySnapshot::save(config.getMemorySnapshotPath(), outlines, fingerprints)) {
+                    MF_DEBUG(endl << "Unable to save memory snapshot " << config.getMemorySnapshotPath());
+                }
             }
+            this->fingerprints.swap(fingerprints);
         }
 
         MF_DEBUG(endl << "Outline stencils:");
@@ -121,6 +153,7 @@ void Memory::learn()
             } else {
                 outlines.push_back(outline);
                 outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+                ftsIndex.add(outline);
             }
 
             MF_DEBUG(endl);
@@ -133,11 +166,164 @@ void Memory::learn()
 #endif
 }
 
+size_t Memory::learnOutlines(
+        const vector<const string*>& files,
+        vector<Outline*>& parsed,
+        MemorySnapshot* memorySnapshot,
+        map<string,MemorySnapshot::Fingerprint>* fingerprints)
+{
+    parsed.assign(files.size(), nullptr);
+    if(files.empty()) {
+        return 0;
+    }
+
+    // workers take files one by one - outlines differ in size a lot
+    atomic<size_t> next{0};
+    atomic<size_t> parsedCount{0};
+    exception_ptr failure{};
+    mutex failureMutex{};
+    mutex fingerprintsMutex{};
+    auto worker = [&]() {
+        size_t i;
+        while((i=next++) < files.size()) {
+            try {
+                if(memorySnapshot) {
+                    MemorySnapshot::Fingerprint fingerprint{};
+                    if(MemorySnapshot::fingerprint(*files[i], fingerprint)) {
+                        parsed[i] = memorySnapshot->outline(*files[i], fingerprint);
+                        lock_guard<mutex> criticalSection{fingerprintsMutex};
+                        (*fingerprints)[*files[i]] = fingerprint;
+                    }
+                }
+                if(!parsed[i]) {
+                    parsed[i] = representation.outline(File(*files[i]));
+                    parsedCount++;
+                }
+            } catch(...) {
+                lock_guard<mutex> criticalSection{failureMutex};
+                if(!failure) {
+                    failure = current_exception();
+                }
+                next = files.size();
+            }
+        }
+    };
+
+    size_t threadsCount = learnThreads<files.size()?learnThreads:files.size();
+    vector<thread> workers{};
+    for(size_t t=1; t<threadsCount; t++) {
+        workers.push_back(thread{worker});
+    }
+    // calling thread is one of workers
+    worker();
+    for(thread& t:workers) {
+        t.join();
+    }
+
+    if(failure) {
+        for(Outline*& o:parsed) {
+            if(o) {
+                delete o;
+                o = nullptr;
+            }
+        }
+        rethrow_exception(failure);
+    }
+
+    return parsedCount;
+}
+
+bool Memory::learn(const RepositoryChange& change, Outline*& forgotten, Outline*& learned)
+{
+    forgotten = learned = nullptr;
+
+    if(change.kind != RepositoryChange::Kind::OUTLINE) {
+        vector<Stencil*>& stencils
+            = change.kind==RepositoryChange::Kind::OUTLINE_STENCIL?outlineStencils:noteStencils;
+        auto stencil = find_if(
+            stencils.begin(),
+            stencils.end(),
+            [&change](const Stencil* s) { return s->getFilePath()==change.path; });
+        if(change.type == RepositoryChange::Type::DELETED) {
+            if(stencil == stencils.end()) {
+                return false;
+            }
+            delete *stencil;
+            stencils.erase(stencil);
+        } else if(stencil == stencils.end()) {
+            Stencil* s = new Stencil{change.path, change.kind==RepositoryChange::Kind::OUTLINE_STENCIL?ResourceType::OUTLINE:ResourceType::NOTE};
+            persistence->load(s);
+            stencils.push_back(s);
+        } else {
+            persistence->load(*stencil);
+        }
+        return true;
+    }
+
+    Outline* old = getOutline(change.path);
+    Outline* outline = nullptr;
+    if(change.type != RepositoryChange::Type::DELETED) {
+        MemorySnapshot::Fingerprint fingerprint{};
+        if(!MemorySnapshot::fingerprint(change.path, fingerprint)) {
+            return false;
+        }
+        auto known = fingerprints.find(change.path);
+        if(old && known!=fingerprints.end() && known->second==fingerprint) {
+            MF_DEBUG(endl << "  '" << change.path << "' is unchanged (own write) > SKIPPING it");
+            return false;
+        }
+        fingerprints[change.path] = fingerprint;
+
+        outline = representation.outline(File(change.path));
+        switch(config.getActiveRepository()->getType()) {
+        case Repository::RepositoryType::MINDFORGER:
+            outline->setFormat(MarkdownDocument::Format::MINDFORGER);
+            break;
+        case Repository::RepositoryType::MARKDOWN:
+            outline->setFormat(MarkdownDocument::Format::MARKDOWN);
+            break;
+        }
+        if(outline->isVirgin()) {
+            MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
+            delete outline;
+            outline = nullptr;
+        }
+    } else {
+        fingerprints.erase(change.path);
+    }
+
+    if(!old && !outline) {
+        return false;
+    }
+
+    if(old) {
+        auto position = std::find(outlines.begin(), outlines.end(), old);
+        if(outline) {
+            // swap in place so that outlines order is preserved
+            *position = outline;
+        } else {
+            outlines.erase(position);
+        }
+        outlinesMap.erase(change.path);
+        ftsIndex.remove(old);
+        forgotten = old;
+    } else {
+        outlines.push_back(outline);
+    }
+    if(outline) {
+        outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+        ftsIndex.add(outline);
+        learned = outline;
+    }
+    return true;
+}
+
 void Memory::amnesia()
 {
     aware = false;
 
     repositoryIndexer.clear();
+    fingerprints.clear();
 
     // IMPROVE reset ontology i.e. clear custom types & keep only default ontology
     // ontology.reset();
@@ -147,6 +333,7 @@ void Memory::amnesia()
     }
     outlines.clear();
     outlinesMap.clear();
+    ftsIndex.clear();
 
     for(Outline*& outline:limboOutlines) {
         delete outline;
@@ -189,6 +376,8 @@ void Memory::remember(const std::string& outlineKey)
         o->makeModified();
         o->checkAndFixProperties();
         persistence->save(o);
+        MemorySnapshot::fingerprint(o->getKey(), fingerprints[o->getKey()]);
+        ftsIndex.add(o);
     } else {
         throw MindForgerException{"Save: unable to find outline w/ given key"};
     }
@@ -204,16 +393,19 @@ void Memory::remember(Outline* outline)
 
     outline->checkAndFixProperties();
     persistence->save(outline);
+    MemorySnapshot::fingerprint(outline->getKey(), fingerprints[outline->getKey()]);
 
     if(!getOutline(outline->getKey())) {
         outlines.push_back(outline);
         outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
     }
+    ftsIndex.add(outline);
 }
 
 void Memory::forget(Outline* outline)
 {
     outlinesMap.erase(outline->getKey());
+    ftsIndex.remove(outline);
     limboOutlines.push_back(outline);
     outlines.erase(std::remove(outlines.begin(), outlines.end(), outline), outlines.end());
 }
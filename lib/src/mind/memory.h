@@ -21,6 +21,9 @@
 
 #include <vector>
 #include <map>
+#include <atomic>
+#include <thread>
+#include <exception>
 
 #include "../debug.h"
 #include "../exceptions.h"
@@ -36,7 +39,9 @@
 #include "../model/resource_types.h"
 #include "../persistence/persistence.h"
 #include "../persistence/filesystem_persistence.h"
+#include "../persistence/memory_snapshot.h"
 #include "aspect/mind_scope_aspect.h"
+#include "fts_index.h"
 
 namespace m8r {
 
@@ -57,6 +62,20 @@ private:
      */
     bool cache;
 
+    /**
+     * @brief Maximum number of threads parsing repository outlines.
+     */
+    unsigned learnThreads;
+
+    /**
+     * @brief Load unchanged outlines from memory snapshot.
+     *
+     * If TRUE, then outlines of files which didn't change since
+     * the last learn() are decoded from binary snapshot instead
+     * of being lexed and parsed.
+     */
+    bool snapshot;
+
     Configuration& config;    
     RepositoryIndexer repositoryIndexer;
     Ontology ontology;
@@ -69,11 +88,18 @@ private:
     std::vector<Stencil*> outlineStencils;
     std::vector<Stencil*> noteStencils;
 
+    // forgotten outlines (kept alive until amnesia)
     std::vector<Outline*> limboOutlines;
 
+    // fingerprints of outline files as learned or saved - used to ignore own writes
+    std::map<std::string,MemorySnapshot::Fingerprint> fingerprints;
+
     // IMPROVE unordered_map
     std::map<std::string,Outline*> outlinesMap;
 
+    // inverted index of outlines and notes (re)built on learn/remember/forget
+    FtsIndex ftsIndex;
+
 public:
     explicit Memory(Configuration& configuration);
     Memory(const Memory&) = delete;
@@ -88,7 +114,23 @@ public:
      * @brief Learn repository content.
      */
     void learn();
+    /**
+     * @brief Learn change of a repository file.
+     *
+     * Changed outline is parsed and swapped in place of the old one, deleted
+     * outline is removed. Replaced/removed outline is not deleted - caller
+     * owns it and deletes it once caches and listeners dropped it.
+     *
+     * @param forgotten     outline which was replaced or removed (or nullptr).
+     * @param learned       outline which was created or swapped in (or nullptr).
+     * @return true if Memory changed.
+     */
+    bool learn(const RepositoryChange& change, Outline*& forgotten, Outline*& learned);
     bool isAware() { return aware; }
+    unsigned getLearnThreads() const { return learnThreads; }
+    void setLearnThreads(unsigned learnThreads) { this->learnThreads = learnThreads?learnThreads:1; }
+    bool isSnapshot() const { return snapshot; }
+    void setSnapshot(bool snapshot) { this->snapshot = snapshot; }
 
     /**
      * @brief Forget everything.
@@ -127,6 +169,11 @@ public:
      */
     Ontology& getOntology() { return ontology; }
 
+    /**
+     * @brief Get full-text search index of remembered outlines.
+     */
+    const FtsIndex& getFtsIndex() const { return ftsIndex; }
+
     /**
      * @brief Get the number of outlines.
      */
@@ -177,6 +224,21 @@ public:
 private:
     const OutlineType* toOutlineType(const MarkdownAstSectionMetadata&);
 
+    /**
+     * @brief Parse Markdown files to outlines using a bounded pool of worker threads.
+     *
+     * Outlines are returned in the order of files. If memory snapshot is given,
+     * then unchanged outlines are decoded from it and fingerprints of files are
+     * collected so that the snapshot can be refreshed.
+     *
+     * @return number of outlines which had to be parsed from Markdown.
+     */
+    size_t learnOutlines(
+            const std::vector<const std::string*>& files,
+            std::vector<Outline*>& parsed,
+            MemorySnapshot* memorySnapshot=nullptr,
+            std::map<std::string,MemorySnapshot::Fingerprint>* fingerprints=nullptr);
+
 };
 
 } /* namespace */
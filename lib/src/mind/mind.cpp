@@ -18,6 +18,8 @@
  */
 #include "mind.h"
 
+#include <queue>
+
 using namespace std;
 
 namespace m8r {
@@ -66,8 +68,12 @@ bool Mind::learn()
 
     if(config.getMindState()!=Configuration::MindState::DREAMING && !activeProcesses) {
         MF_DEBUG("Learning..." << endl);
+        bool watching = memory.getRepositoryIndexer().isWatching();
         mindAmnesia();
         memory.learn();
+        if(watching) {
+            memory.getRepositoryIndexer().watch();
+        }
         MF_DEBUG("Mind LEARNED" << endl);
         return true;
     } else {
@@ -248,6 +254,65 @@ bool Mind::mindAmnesia()
     }
 }
 
+bool Mind::watch()
+{
+    MF_DEBUG("@Watch" << endl);
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    return memory.getRepositoryIndexer().watch();
+}
+
+int Mind::learnRepositoryChanges()
+{
+    MF_DEBUG("@LearnRepositoryChanges" << endl);
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    if(config.getMindState()==Configuration::MindState::DREAMING || activeProcesses) {
+        // changes stay queued until Mind is ready
+        MF_DEBUG("Learn changes: CANNOT learn because Mind is DREAMING and/or there are " << activeProcesses << " active Mind processes" << endl);
+        return -1;
+    }
+
+    vector<RepositoryChange> changes{};
+    if(!memory.getRepositoryIndexer().updateIndex(changes)) {
+        return 0;
+    }
+
+    int learned = 0;
+    Outline* forgottenOutline;
+    Outline* learnedOutline;
+    for(const RepositoryChange& change:changes) {
+        if(memory.learn(change, forgottenOutline, learnedOutline)) {
+            learned++;
+            if(forgottenOutline) {
+                ai->forget(forgottenOutline);
+                for(MindListener* l:listeners) {
+                    l->forget(forgottenOutline);
+                }
+                // AI and listeners dropped it
+                delete forgottenOutline;
+            }
+            if(learnedOutline) {
+                if(config.getMindState()==Configuration::MindState::THINKING) {
+                    ai->remember(learnedOutline);
+                }
+                for(MindListener* l:listeners) {
+                    l->remember(learnedOutline);
+                }
+            }
+        }
+    }
+
+    if(learned) {
+        // lazily refreshed caches
+        deleteWatermark++;
+        allNotesCache.clear();
+    }
+
+    MF_DEBUG("Mind LEARNED " << learned << " repository change(s)" << endl);
+    return learned;
+}
+
 /*
  * REMEMBERING
  */
@@ -281,21 +346,22 @@ void Mind::getOutlineNames(vector<string>& names) const
 }
 
 // One match in either title or body is enought to be added to the result
-void Mind::findNoteFts(vector<Note*>* result, const string& regexp, const bool ignoreCase, Outline* outline)
+void Mind::findNoteFts(
+        vector<Note*>* result,
+        const string& regexp,
+        const bool ignoreCase,
+        Outline* outline,
+        const FtsIndex::Candidates* candidates)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
+    bool descriptor = !candidates || candidates->descriptors.count(outline);
     if(ignoreCase) {
-        // case INSENSITIVE
-        string s{};
-        stringToLower(outline->getName(), s);
-        if(s.find(regexp)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    if(s.find(regexp)!=string::npos) {
+        // case INSENSITIVE - regexp is lower case, text is folded by search kernel w/o copying
+        if(descriptor) {
+            if(stringFindIgnoreCase(outline->getName(), regexp)!=string::npos) {
+                result->push_back(outline->getOutlineDescriptorAsNote());
+            } else {
+                for(string* d:outline->getDescription()) {
+                    if(d && stringFindIgnoreCase(*d, regexp)!=string::npos) {
                         result->push_back(outline->getOutlineDescriptorAsNote());
                         break;
                     }
@@ -303,41 +369,37 @@ void Mind::findNoteFts(vector<Note*>* result, const string& regexp, const bool i
             }
         }
         for(Note* note:outline->getNotes()) {
-            if(scopeAspect.isOutOfScope(note)) {
+            if(scopeAspect.isOutOfScope(note) || (candidates && !candidates->notes.count(note))) {
                 continue;
             }
-            s.clear();
-            stringToLower(note->getName(), s);
-            if(s.find(regexp)!=string::npos) {
+            if(stringFindIgnoreCase(note->getName(), regexp)!=string::npos) {
                 result->push_back(note);
             } else {
                 for(string* d:note->getDescription()) {
-                    if(d) {
-                        s.clear();
-                        stringToLower(*d, s);
-                        if(s.find(regexp)!=string::npos) {
-                            result->push_back(note);
-                            break;
-                        }
+                    if(d && stringFindIgnoreCase(*d, regexp)!=string::npos) {
+                        result->push_back(note);
+                        break;
                     }
                 }
             }
         }
     } else {
         // case SENSITIVE
-        if(outline->getName().find(regexp)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d && d->find(regexp)!=string::npos) {
-                    result->push_back(outline->getOutlineDescriptorAsNote());
-                    // avoid multiple matches in the result
-                    break;
+        if(descriptor) {
+            if(outline->getName().find(regexp)!=string::npos) {
+                result->push_back(outline->getOutlineDescriptorAsNote());
+            } else {
+                for(string* d:outline->getDescription()) {
+                    if(d && d->find(regexp)!=string::npos) {
+                        result->push_back(outline->getOutlineDescriptorAsNote());
+                        // avoid multiple matches in the result
+                        break;
+                    }
                 }
             }
         }
         for(Note* note:outline->getNotes()) {
-            if(scopeAspect.isOutOfScope(note)) {
+            if(scopeAspect.isOutOfScope(note) || (candidates && !candidates->notes.count(note))) {
                 continue;
             }
             if(note->getName().find(regexp)!=string::npos) {
@@ -370,17 +432,289 @@ vector<Note*>* Mind::findNoteFts(const string& regexp, const bool ignoreCase, Ou
         r += regexp;
     }
 
+    // FTS index narrows the search to candidates, short raw substring queries (w/o any term) are scanned
+    FtsIndex::Candidates candidates{};
+    const FtsIndex& ftsIndex = memory.getFtsIndex();
+    bool indexed = (!outlineScope || ftsIndex.contains(outlineScope)) && ftsIndex.find(r, ignoreCase, candidates);
+
+    if(outlineScope) {
+        if(!indexed || candidates.outlines.count(outlineScope)) {
+            findNoteFts(result, r, ignoreCase, outlineScope, indexed?&candidates:nullptr);
+        }
+    } else {
+        const vector<m8r::Outline*>& outlines = memory.getOutlines();
+        for(Outline* outline:outlines) {
+            if(scopeAspect.isOutOfScope(outline)) {
+                continue;
+            }
+            if(!indexed) {
+                findNoteFts(result, r, ignoreCase, outline);
+            } else if(candidates.outlines.count(outline)) {
+                findNoteFts(result, r, ignoreCase, outline, &candidates);
+            }
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// name occurrence is worth this number of description occurrences
+constexpr int FTS_NAME_WEIGHT = 4;
+// score saturates i.e. long notes don't outweigh the rest and text is scanned only up to saturation
+constexpr int FTS_MAX_SCORE = 16;
+
+int countOccurrences(const string& text, const string& s, const bool ignoreCase, int max)
+{
+    int count = 0;
+    if(ignoreCase) {
+        for(size_t i = stringFindIgnoreCase(text, s); i!=string::npos && count<max; i = stringFindIgnoreCase(text, s, i+1)) {
+            count++;
+        }
+    } else {
+        for(size_t i = text.find(s); i!=string::npos && count<max; i = text.find(s, i+1)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+struct FtsHit {
+    int score;
+    uint64_t order;
+    Note* note;
+};
+
+// heap comparator - top of the heap is the worst ranked hit
+struct FtsHitBetter {
+    bool operator()(const FtsHit& a, const FtsHit& b) const {
+        return a.score > b.score || (a.score == b.score && a.order < b.order);
+    }
+};
+
+} // anonymous namespace
+
+int Mind::scoreNoteFts(
+        const string& s,
+        const bool ignoreCase,
+        const string& name,
+        const vector<string*>& description,
+        const int max)
+{
+    const int limit = std::min(max, FTS_MAX_SCORE);
+    int score = FTS_NAME_WEIGHT*countOccurrences(name, s, ignoreCase, (limit+FTS_NAME_WEIGHT-1)/FTS_NAME_WEIGHT);
+    for(string* d:description) {
+        if(score >= limit) {
+            break;
+        }
+        if(d) {
+            score += countOccurrences(*d, s, ignoreCase, limit-score);
+        }
+    }
+    return std::min(score, FTS_MAX_SCORE);
+}
+
+size_t Mind::findNoteFts(
+        const string& s,
+        const bool ignoreCase,
+        Outline* outlineScope,
+        size_t limit,
+        FtsCursor& cursor,
+        SearchListener* listener)
+{
+    if(allNotesCache.size()) {
+        allNotesCache.clear();
+    }
+
+    string r{};
+    if(ignoreCase) {
+        stringToLower(s, r);
+    } else {
+        r += s;
+    }
+    if(r.empty() || !limit) {
+        return 0;
+    }
+
+    FtsIndex::Candidates candidates{};
+    const FtsIndex& ftsIndex = memory.getFtsIndex();
+    bool indexed = (!outlineScope || ftsIndex.contains(outlineScope)) && ftsIndex.find(r, ignoreCase, candidates);
+
+    // bounded heap of the best hits ranked after the cursor
+    priority_queue<FtsHit,vector<FtsHit>,FtsHitBetter> best{};
+    size_t hits = 0;
+    auto rank = [&](const string& name, const vector<string*>& description, uint64_t order, Note* note) {
+        // score is computed only up to the value which is needed to rank the note:
+        // to compare it with the cursor and to beat the worst hit in the heap (ties are
+        // ranked in memory order i.e. later note must have higher score)
+        int max = cursor.begin?1:cursor.score+1;
+        if(best.size() < limit) {
+            max = FTS_MAX_SCORE;
+        } else if(best.top().score < FTS_MAX_SCORE) {
+            max = std::max(max, best.top().score+1);
+        }
+        int score = scoreNoteFts(r, ignoreCase, name, description, max);
+        if(score && cursor.isBefore(score, order)) {
+            hits++;
+            if(best.size() < limit || score > best.top().score) {
+                if(max < FTS_MAX_SCORE) {
+                    score = scoreNoteFts(r, ignoreCase, name, description);
+                }
+                if(best.size() == limit) {
+                    best.pop();
+                }
+                best.push(FtsHit{score, order, note});
+            }
+        }
+    };
+
+    const vector<m8r::Outline*>& outlines = memory.getOutlines();
+    for(size_t o=0; o<outlines.size(); o++) {
+        Outline* outline = outlines[o];
+        if((outlineScope && outline!=outlineScope)
+             || (!outlineScope && scopeAspect.isOutOfScope(outline))
+             || (indexed && !candidates.outlines.count(outline)))
+        {
+            continue;
+        }
+
+        // rank ties are ordered as outlines/notes in memory
+        uint64_t order = static_cast<uint64_t>(o)<<32;
+        if(!indexed || candidates.descriptors.count(outline)) {
+            rank(outline->getName(), outline->getDescription(), order, outline->getOutlineDescriptorAsNote());
+        }
+        const vector<Note*>& notes = outline->getNotes();
+        for(size_t n=0; n<notes.size(); n++) {
+            Note* note = notes[n];
+            if(scopeAspect.isOutOfScope(note) || (indexed && !candidates.notes.count(note))) {
+                continue;
+            }
+            rank(note->getName(), note->getDescription(), order+n+1, note);
+        }
+    }
+
+    // heap pops the worst hit first
+    vector<FtsHit> page(best.size());
+    for(size_t i=page.size(); i>0; i--) {
+        page[i-1] = best.top();
+        best.pop();
+    }
+    if(!page.empty()) {
+        cursor.begin = false;
+        cursor.score = page.back().score;
+        cursor.order = page.back().order;
+    }
+    for(FtsHit& hit:page) {
+        listener->found(hit.note);
+    }
+
+    return hits;
+}
+
+int Mind::findNoteRegexp(
+        SearchListener* listener,
+        Regexp& regexp,
+        const string& literal,
+        Outline* outline,
+        const FtsIndex::Candidates* candidates)
+{
+    auto matches = [&regexp,&literal](const string& name, const vector<string*>& description) {
+        if(literal.empty()
+             || (regexp.isIgnoreCase()?stringFindIgnoreCase(name, literal):name.find(literal))!=string::npos)
+        {
+            if(regexp.search(name)) {
+                return true;
+            }
+        }
+        for(string* d:description) {
+            if(d
+                 && (literal.empty()
+                     || (regexp.isIgnoreCase()?stringFindIgnoreCase(*d, literal):d->find(literal))!=string::npos)
+                 && regexp.search(*d))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    int found = 0;
+    if(!candidates || candidates->descriptors.count(outline)) {
+        if(matches(outline->getName(), outline->getDescription())) {
+            listener->found(outline->getOutlineDescriptorAsNote());
+            found++;
+        }
+    }
+    for(Note* note:outline->getNotes()) {
+        if(scopeAspect.isOutOfScope(note) || (candidates && !candidates->notes.count(note))) {
+            continue;
+        }
+        if(matches(note->getName(), note->getDescription())) {
+            listener->found(note);
+            found++;
+        }
+    }
+    return found;
+}
+
+int Mind::findNoteRegexp(const string& regexp, const bool ignoreCase, Outline* outlineScope, SearchListener* listener)
+{
+    Regexp r{regexp, ignoreCase};
+    if(!r.isValid()) {
+        return -1;
+    }
+
+    if(allNotesCache.size()) {
+        allNotesCache.clear();
+    }
+
+    // every match contains the literal > FTS index narrows the search to documents which contain it
+    string literal = r.getLongestRequiredLiteral();
+    FtsIndex::Candidates candidates{};
+    const FtsIndex& ftsIndex = memory.getFtsIndex();
+    bool indexed = !literal.empty()
+        && (!outlineScope || ftsIndex.contains(outlineScope))
+        && ftsIndex.find(literal, ignoreCase, candidates);
+
+    int found = 0;
     if(outlineScope) {
-        findNoteFts(result, r, ignoreCase, outlineScope);
+        if(!indexed || candidates.outlines.count(outlineScope)) {
+            found += findNoteRegexp(listener, r, literal, outlineScope, indexed?&candidates:nullptr);
+        }
     } else {
-        const vector<m8r::Outline*> outlines = memory.getOutlines();
+        const vector<m8r::Outline*>& outlines = memory.getOutlines();
         for(Outline* outline:outlines) {
             if(scopeAspect.isOutOfScope(outline)) {
                 continue;
             }
-            findNoteFts(result, r, ignoreCase, outline);
+            if(!indexed) {
+                found += findNoteRegexp(listener, r, literal, outline);
+            } else if(candidates.outlines.count(outline)) {
+                found += findNoteRegexp(listener, r, literal, outline, &candidates);
+            }
         }
     }
+    return found;
+}
+
+namespace {
+
+class CollectingSearchListener : public SearchListener
+{
+public:
+    vector<Note*>* result;
+
+    explicit CollectingSearchListener(vector<Note*>* result) : result(result) {}
+    virtual void found(Note* note) override { result->push_back(note); }
+};
+
+} // anonymous namespace
+
+vector<Note*>* Mind::findNoteRegexp(const string& regexp, const bool ignoreCase, Outline* outlineScope)
+{
+    vector<Note*>* result = new vector<Note*>();
+    CollectingSearchListener listener{result};
+    findNoteRegexp(regexp, ignoreCase, outlineScope, &listener);
     return result;
 }
 
@@ -715,6 +1049,14 @@ bool Mind::outlineForget(string outlineKey)
     if(o) {
         deleteWatermark++;
 
+        {
+            lock_guard<mutex> criticalSection{exclusiveMind};
+            ai->forget(o);
+            for(MindListener* l:listeners) {
+                l->forget(o);
+            }
+        }
+
         memory.forget(o);
         auto k = memory.createLimboKey(&o->getName());
         o->setKey(k);
@@ -803,12 +1145,36 @@ Outline* Mind::noteRefactor(Note* noteToRefactor, const string& targetOutlineKey
     }
 }
 
+void Mind::noteRemember(Note* note)
+{
+    memory.remember(note->getOutlineKey());
+
+    lock_guard<mutex> criticalSection{exclusiveMind};
+    // DREAMING AI would block (GUI) until learning finishes - N is learned by the next learning
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        ai->remember(note);
+    }
+}
+
 Outline* Mind::noteForget(Note* note)
 {
     Outline* o = note->getOutline();
     if(o) {
         deleteWatermark++;
 
+        // N is deleted w/ its children - AI must drop them before
+        vector<Note*> forgotten{note};
+        o->getNoteChildren(note, &forgotten);
+        {
+            lock_guard<mutex> criticalSection{exclusiveMind};
+            for(Note* n:forgotten) {
+                ai->forget(n);
+                for(MindListener* l:listeners) {
+                    l->forget(n);
+                }
+            }
+        }
+
         note->getOutline()->forgetNote(note);
         return o;
     } else {
@@ -883,7 +1249,6 @@ void Mind::recognizePersons(const Outline* outline, int entityFilter, std::vecto
 // unique_ptr template BREAKS Qt Developer indentation > stored at EOF
 unique_ptr<vector<Outline*>> Mind::findOutlineByNameFts(const string& expr) const
 {
-    // IMPROVE implement regexp and other search options by reusing HSTR code
     // IMPROVE PERF this method is extremely inefficient > use cached map (stack member) evicted on memory modification
     unique_ptr<vector<Outline*>> result{new vector<Outline*>()};
     if(expr.size()) {
@@ -897,4 +1262,21 @@ unique_ptr<vector<Outline*>> Mind::findOutlineByNameFts(const string& expr) cons
     return result;
 }
 
+unique_ptr<vector<Outline*>> Mind::findOutlineByNameRegexp(const string& regexp, const bool ignoreCase) const
+{
+    Regexp r{regexp, ignoreCase};
+    if(!r.isValid()) {
+        return unique_ptr<vector<Outline*>>{};
+    }
+
+    unique_ptr<vector<Outline*>> result{new vector<Outline*>()};
+    const vector<Outline*>& outlines = memory.getOutlines();
+    for(Outline* outline:outlines) {
+        if(r.search(outline->getName())) {
+            result->push_back(outline);
+        }
+    }
+    return result;
+}
+
 } /* namespace */
@@ -22,13 +22,18 @@
 #include <inttypes.h>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 #include "memory.h"
+#include "mind_listener.h"
+#include "search_listener.h"
+#include "fts_cursor.h"
 #include "knowledge_graph.h"
 #include "ai/ai.h"
 #include "ontology/thing_class_rel_triple.h"
 #include "aspect/mind_scope_aspect.h"
 #include "../config/configuration.h"
+#include "../gear/regexp.h"
 #include "../representations/markdown/markdown_configuration_representation.h"
 #ifdef MF_NER
     #include "ai/nlp/named_entity_recognition.h"
@@ -136,9 +141,9 @@ private:
     int deleteWatermark;
 
     /**
-     * @brief Active mental processes.
+     * @brief Active mental processes (updated by AI workers).
      */
-    int activeProcesses;
+    std::atomic<int> activeProcesses;
 
     /**
      * Where the mind thinks.
@@ -181,6 +186,11 @@ private:
      */
     std::vector<Note*> allNotesCache;
 
+    /**
+     * @brief Listeners notified on outlines learned/forgotten on repository change.
+     */
+    std::vector<MindListener*> listeners;
+
     /**
      * @brief Time scope.
      */
@@ -245,6 +255,31 @@ public:
      */
     bool amnesia();
 
+    /**
+     * @brief Watch learned repository for external changes (git pull, sync tools, other editors).
+     *
+     * Watching is kept on learn() of another repository.
+     */
+    bool watch();
+
+    /**
+     * @brief Learn external changes of watched repository w/o full learn().
+     *
+     * Only changed outlines are parsed and swapped in Memory, caches
+     * and listeners are notified about forgotten/learned outlines.
+     * Forgotten outline is deleted once listeners are notified i.e.
+     * listeners must drop it in forget().
+     * Use RepositoryIndexer::getWatchFd() to find out when to call it.
+     *
+     * @return number of changes learned or -1 if Mind is DREAMING or busy.
+     */
+    int learnRepositoryChanges();
+
+    void addListener(MindListener* listener) { listeners.push_back(listener); }
+    void removeListener(MindListener* listener) {
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+    }
+
     /*
      *  AI
      */
@@ -306,8 +341,53 @@ public:
      * @brief Find outline by name - exact match.
      */
     std::unique_ptr<std::vector<Outline*>> findOutlineByNameFts(const std::string& regexp) const;
+    /**
+     * @brief Find outlines whose name contains a match of regular expression.
+     * @return nullptr if regular expression is not valid.
+     */
+    std::unique_ptr<std::vector<Outline*>> findOutlineByNameRegexp(const std::string& regexp, const bool ignoreCase=false) const;
     std::vector<Note*>* findNoteByNameFts(const std::string& regexp) const;
     std::vector<Note*>* findNoteFts(const std::string& regexp, const bool ignoreCase=false, Outline* outlineScope=nullptr);
+    /**
+     * @brief Find page of notes which contain searched string ranked by relevance.
+     *
+     * Notes are ranked by the number of occurrences of searched string (occurrences
+     * in name have higher weight, score saturates). Up to limit best results ranked after the cursor
+     * are kept in a bounded heap and streamed to the listener in rank order, cursor
+     * is moved after the last of them.
+     *
+     * @return number of matching notes ranked after the cursor (before the call) i.e.
+     *         there is a next page if it's greater than limit.
+     */
+    size_t findNoteFts(
+            const std::string& s,
+            const bool ignoreCase,
+            Outline* outlineScope,
+            size_t limit,
+            FtsCursor& cursor,
+            SearchListener* listener);
+    /**
+     * @brief Get FTS score of name and description - 0 if searched string (lower case if
+     *        case is ignored) is not found.
+     *
+     * Occurrences are counted only until score reaches max (score may exceed it).
+     */
+    static int scoreNoteFts(
+            const std::string& s,
+            const bool ignoreCase,
+            const std::string& name,
+            const std::vector<std::string*>& description,
+            const int max=INT_MAX);
+    /**
+     * @brief Find notes with name or description line which contains a match of regular expression.
+     *
+     * Literal required by the expression is used to narrow the search using FTS
+     * index, matching notes are streamed to the listener as they are found.
+     *
+     * @return number of found notes or -1 if regular expression is not valid.
+     */
+    int findNoteRegexp(const std::string& regexp, const bool ignoreCase, Outline* outlineScope, SearchListener* listener);
+    std::vector<Note*>* findNoteRegexp(const std::string& regexp, const bool ignoreCase=false, Outline* outlineScope=nullptr);
     // TODO findFts() - search also outline name and description
     //   >> temporary note of Outline type (never saved), cannot be created by user
     void getOutlineNames(std::vector<std::string>& names) const;
@@ -509,6 +589,13 @@ public:
      */
     Outline* noteRefactor(Note* noteToRefactor, const std::string& targetOutlineKey, Note* targetParent=nullptr);
 
+    /**
+     * @brief Remember created or modified Note.
+     *
+     * Note's Outline is persisted and Note is learned by AI incrementally.
+     */
+    void noteRemember(Note* note);
+
     /*
      * @brief Forget note.
      *
@@ -608,11 +695,29 @@ private:
      */
     void onRemembering();
 
+    /**
+     * @brief Find notes of given outline which contain searched string.
+     *
+     * If FTS index candidates are given, then only candidate descriptor/notes
+     * are checked.
+     */
     void findNoteFts(
             std::vector<Note*>* result,
             const std::string& regexp,
             const bool ignoreCase,
-            Outline* outline);
+            Outline* outline,
+            const FtsIndex::Candidates* candidates=nullptr);
+    /**
+     * @brief Find notes of given outline which contain a match of regular expression.
+     *
+     * Lines which don't contain required literal (if any) are skipped w/o running DFA.
+     */
+    int findNoteRegexp(
+            SearchListener* listener,
+            Regexp& regexp,
+            const std::string& literal,
+            Outline* outline,
+            const FtsIndex::Candidates* candidates=nullptr);
 };
 
 } /* namespace */
@@ -32,6 +32,10 @@ class MindListener
 public:
     virtual void forget(Outline* outline) = 0;
     virtual void forget(Note* note) = 0;
+    /**
+     * @brief Outline was learned or re-learned (replacing forgotten one w/ the same key).
+     */
+    virtual void remember(Outline* outline) = 0;
 };
 
 }
@@ -174,15 +174,17 @@ const Tag* Ontology::findOrCreateTag(const string& key) {
     // by convention tags are in LOWERCASE
     std::string k{};
     stringToLower(key, k);
+    lock_guard<mutex> criticalSection{findOrCreateMutex};
     auto result = tagTaxonomy.get(k);
     if(!result) {
-        result = new Tag(k, &tagTaxonomy, colorPalette.colorForName(key));
+        result = new Tag(k, &tagTaxonomy, colorPalette.colorForName(k));
         tagTaxonomy.add(k, result);
     }
     return result;
 }
 
 const OutlineType* Ontology::findOrCreateOutlineType(const string& key) {
+    lock_guard<mutex> criticalSection{findOrCreateMutex};
     auto result = outlineTypeTaxonomy.get(key);
     if(!result) {
         result = new OutlineType(key, &outlineTypeTaxonomy, Color::DARK_GRAY());
@@ -192,6 +194,7 @@ const OutlineType* Ontology::findOrCreateOutlineType(const string& key) {
 }
 
 const NoteType* Ontology::findOrCreateNoteType(const std::string& key) {
+    lock_guard<mutex> criticalSection{findOrCreateMutex};
     auto result = noteTypeTaxonomy.get(key);
     if(!result) {
         result = new NoteType(key, &noteTypeTaxonomy, Color::DARK_GRAY());
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <map>
+#include <mutex>
 
 #include "thing_class_rel_triple.h"
 #include "taxonomy.h"
@@ -176,6 +177,11 @@ private:
      */
     Palette colorPalette;
 
+    /**
+     * @brief Guards find or create of classes - outlines are parsed (and classified) in parallel.
+     */
+    std::mutex findOrCreateMutex;
+
 public:
     explicit Ontology();
     Ontology(const Ontology&) = delete;
@@ -64,6 +64,9 @@ const string* Stencil::getStencil() const
 
 void Stencil::setContent(string* stencil)
 {
+    if(content && content!=stencil) {
+        delete content;
+    }
     this->content = stencil;
 }
 
@@ -0,0 +1,333 @@
+/*
+ memory_snapshot.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "memory_snapshot.h"
+
+#include <cstring>
+
+#include "snapshot_io.h"
+
+using namespace std;
+
+namespace m8r {
+
+/*
+ * Snapshot file layout (native byte order - snapshot is a local cache):
+ *
+ *   MAGIC (8B) VERSION (u32) ENTRIES COUNT (u32)
+ *   entry*:
+ *     path (string) modified (i64) size (u64) hash (u64)
+ *     payload hash (u64) payload size (u64) payload
+ *
+ * Strings are stored as u32 length followed by bytes. Payload hash
+ * is verified before decoding so that corrupted entry never leaks
+ * half decoded tags or types to the ontology.
+ */
+
+namespace {
+
+constexpr size_t MAGIC_SIZE = 8;
+constexpr uint8_t FLAG_POST_DECLARED_SECTION = 1;
+constexpr uint8_t FLAG_TRAILING_HASHES_SECTION = 1<<1;
+
+void putLines(string& buffer, const vector<string*>& lines)
+{
+    snapshotPut<uint32_t>(buffer, lines.size());
+    for(const string* line:lines) {
+        snapshotPutString(buffer, *line);
+    }
+}
+
+void putTags(string& buffer, const vector<const Tag*>* tags)
+{
+    snapshotPut<uint32_t>(buffer, tags->size());
+    for(const Tag* t:*tags) {
+        snapshotPutString(buffer, t->getName());
+    }
+}
+
+void putLinks(string& buffer, const vector<Link*>& links)
+{
+    snapshotPut<uint32_t>(buffer, links.size());
+    for(Link* l:links) {
+        snapshotPutString(buffer, l->getName());
+        snapshotPutString(buffer, l->getUrl());
+    }
+}
+
+void putOutline(string& buffer, const Outline* o)
+{
+    snapshotPut<uint8_t>(buffer, static_cast<uint8_t>(o->getFormat()));
+    snapshotPut<uint8_t>(buffer,
+        (o->isPostDeclaredSection()?FLAG_POST_DECLARED_SECTION:0)
+        | (o->isTrailingHashesSection()?FLAG_TRAILING_HASHES_SECTION:0));
+    snapshotPutString(buffer, o->getName());
+    snapshotPutString(buffer, o->getType()->getName());
+    snapshotPut<int64_t>(buffer, o->getCreated());
+    snapshotPut<int64_t>(buffer, o->getModified());
+    snapshotPut<int64_t>(buffer, o->getRead());
+    snapshotPut<uint32_t>(buffer, o->getRevision());
+    snapshotPut<uint32_t>(buffer, o->getReads());
+    snapshotPut<int8_t>(buffer, o->getImportance());
+    snapshotPut<int8_t>(buffer, o->getUrgency());
+    snapshotPut<int8_t>(buffer, o->getProgress());
+    const TimeScope& ts = o->getTimeScope();
+    snapshotPut<uint8_t>(buffer, ts.years);
+    snapshotPut<uint8_t>(buffer, ts.months);
+    snapshotPut<uint8_t>(buffer, ts.days);
+    snapshotPut<uint8_t>(buffer, ts.hours);
+    snapshotPut<uint8_t>(buffer, ts.minutes);
+    snapshotPut<uint32_t>(buffer, o->getBytesize());
+    putLines(buffer, o->getPreamble());
+    putLines(buffer, o->getDescription());
+    putTags(buffer, o->getTags());
+    putLinks(buffer, o->getLinks());
+
+    snapshotPut<uint32_t>(buffer, o->getNotes().size());
+    for(const Note* n:o->getNotes()) {
+        snapshotPutString(buffer, n->getType()->getName());
+        snapshotPut<uint8_t>(buffer,
+            (n->isPostDeclaredSection()?FLAG_POST_DECLARED_SECTION:0)
+            | (n->isTrailingHashesSection()?FLAG_TRAILING_HASHES_SECTION:0));
+        snapshotPutString(buffer, n->getName());
+        snapshotPut<uint16_t>(buffer, n->getDepth());
+        snapshotPut<int64_t>(buffer, n->getCreated());
+        snapshotPut<int64_t>(buffer, n->getModified());
+        snapshotPut<int64_t>(buffer, n->getRead());
+        snapshotPut<int64_t>(buffer, n->getDeadline());
+        snapshotPut<uint32_t>(buffer, n->getRevision());
+        snapshotPut<uint32_t>(buffer, n->getReads());
+        snapshotPut<uint8_t>(buffer, n->getProgress());
+        putLines(buffer, n->getDescription());
+        putTags(buffer, n->getTags());
+        putLinks(buffer, n->getLinks());
+    }
+}
+
+} // anonymous namespace
+
+MemorySnapshot::MemorySnapshot(Ontology& ontology)
+    : ontology(ontology),
+      file(nullptr)
+{
+}
+
+MemorySnapshot::~MemorySnapshot()
+{
+    close();
+}
+
+bool MemorySnapshot::fingerprint(const string& filePath, Fingerprint& fingerprint)
+{
+    if(!isFile(filePath.c_str())) {
+        return false;
+    }
+
+    MemoryMappedFile mapped{&filePath};
+    fingerprint.modified = fileModificationTime(&filePath);
+    fingerprint.size = mapped.getSize();
+    fingerprint.hash = snapshotHash(mapped.getData(), mapped.getSize());
+    return true;
+}
+
+void MemorySnapshot::open(const string& snapshotPath)
+{
+    close();
+
+    file = new MemoryMappedFile{&snapshotPath};
+    if(!file->isMapped() || !index(file->getData(), file->getSize())) {
+        MF_DEBUG("Memory snapshot " << snapshotPath << " is missing or invalid > IGNORING it" << endl);
+        close();
+    }
+}
+
+bool MemorySnapshot::index(const char* data, size_t size)
+{
+    SnapshotReader r{data, size};
+    const char* magic = r.skip(MAGIC_SIZE);
+    if(!magic || memcmp(magic, MAGIC, MAGIC_SIZE) || r.get<uint32_t>()!=VERSION) {
+        return false;
+    }
+
+    uint32_t count = r.get<uint32_t>();
+    string path{};
+    for(uint32_t i=0; i<count && r.isValid(); i++) {
+        r.getString(path);
+        Entry entry{};
+        entry.fingerprint.modified = r.get<int64_t>();
+        entry.fingerprint.size = r.get<uint64_t>();
+        entry.fingerprint.hash = r.get<uint64_t>();
+        uint64_t payloadHash = r.get<uint64_t>();
+        entry.size = r.get<uint64_t>();
+        entry.data = r.skip(entry.size);
+        if(r.isValid() && snapshotHash(entry.data, entry.size)==payloadHash) {
+            entries[path] = entry;
+        }
+    }
+
+    if(!r.isValid() || !r.isEnd()) {
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+void MemorySnapshot::close()
+{
+    entries.clear();
+    if(file) {
+        delete file;
+        file = nullptr;
+    }
+}
+
+Outline* MemorySnapshot::outline(const string& filePath, const Fingerprint& fingerprint)
+{
+    auto e = entries.find(filePath);
+    if(e==entries.end() || !(e->second.fingerprint==fingerprint)) {
+        return nullptr;
+    }
+
+    SnapshotReader r{e->second.data, e->second.size};
+    string s{};
+
+    Outline* o = new Outline{ontology.getDefaultOutlineType()};
+    o->setFormat(static_cast<MarkdownDocument::Format>(r.get<uint8_t>()));
+    uint8_t flags = r.get<uint8_t>();
+    if(flags & FLAG_POST_DECLARED_SECTION) o->setPostDeclaredSection();
+    if(flags & FLAG_TRAILING_HASHES_SECTION) o->setTrailingHashesSection();
+    r.getString(s);
+    o->setName(s);
+    r.getString(s);
+    const OutlineType* outlineType = ontology.getOutlineTypes().get(s);
+    o->setType(outlineType?outlineType:ontology.getDefaultOutlineType());
+    o->setCreated(r.get<int64_t>());
+    o->setModified(r.get<int64_t>());
+    o->setRead(r.get<int64_t>());
+    o->setRevision(r.get<uint32_t>());
+    o->setReads(r.get<uint32_t>());
+    o->setImportance(r.get<int8_t>());
+    o->setUrgency(r.get<int8_t>());
+    o->setProgress(r.get<int8_t>());
+    uint8_t years = r.get<uint8_t>();
+    uint8_t months = r.get<uint8_t>();
+    uint8_t days = r.get<uint8_t>();
+    uint8_t hours = r.get<uint8_t>();
+    uint8_t minutes = r.get<uint8_t>();
+    TimeScope timeScope{years, months, days, hours, minutes};
+    if(timeScope.relativeSecs) {
+        o->setTimeScope(timeScope);
+    }
+    o->setBytesize(r.get<uint32_t>());
+    for(uint32_t i=r.getCount(sizeof(uint32_t)); i>0; i--) {
+        o->addPreambleLine(r.newString());
+    }
+    for(uint32_t i=r.getCount(sizeof(uint32_t)); i>0; i--) {
+        o->addDescriptionLine(r.newString());
+    }
+    for(uint32_t i=r.getCount(sizeof(uint32_t)); i>0; i--) {
+        r.getString(s);
+        o->addTag(ontology.findOrCreateTag(s));
+    }
+    for(uint32_t i=r.getCount(2*sizeof(uint32_t)); i>0; i--) {
+        r.getString(s);
+        string url{};
+        r.getString(url);
+        o->addLink(new Link{s, url});
+    }
+
+    for(uint32_t i=r.getCount(sizeof(uint32_t)); i>0 && r.isValid(); i--) {
+        r.getString(s);
+        const NoteType* noteType = ontology.getNoteTypes().get(s);
+        Note* n = new Note{noteType?noteType:ontology.getDefaultNoteType(), o};
+        flags = r.get<uint8_t>();
+        if(flags & FLAG_POST_DECLARED_SECTION) n->setPostDeclaredSection();
+        if(flags & FLAG_TRAILING_HASHES_SECTION) n->setTrailingHashesSection();
+        r.getString(s);
+        n->setName(s);
+        n->setDepth(r.get<uint16_t>());
+        n->setCreated(r.get<int64_t>());
+        n->setModified(r.get<int64_t>());
+        n->setRead(r.get<int64_t>());
+        n->setDeadline(r.get<int64_t>());
+        n->setRevision(r.get<uint32_t>());
+        n->setReads(r.get<uint32_t>());
+        n->setProgress(r.get<uint8_t>());
+        for(uint32_t j=r.getCount(sizeof(uint32_t)); j>0; j--) {
+            n->addDescriptionLine(r.newString());
+        }
+        for(uint32_t j=r.getCount(sizeof(uint32_t)); j>0; j--) {
+            r.getString(s);
+            n->addTag(ontology.findOrCreateTag(s));
+        }
+        for(uint32_t j=r.getCount(2*sizeof(uint32_t)); j>0; j--) {
+            r.getString(s);
+            string url{};
+            r.getString(url);
+            n->addLink(new Link{s, url});
+        }
+        o->addNote(n);
+    }
+
+    if(!r.isValid() || !r.isEnd()) {
+        MF_DEBUG("Memory snapshot entry " << filePath << " is corrupted > SKIPPING it" << endl);
+        delete o;
+        return nullptr;
+    }
+
+    o->setKey(filePath);
+    o->completeProperties(fingerprint.modified);
+    o->setModifiedPretty(datetimeToPrettyHtml(o->getModified()));
+    return o;
+}
+
+bool MemorySnapshot::save(
+        const string& snapshotPath,
+        const vector<Outline*>& outlines,
+        const map<string,Fingerprint>& fingerprints)
+{
+    string buffer{};
+    buffer.append(MAGIC, MAGIC_SIZE);
+    snapshotPut<uint32_t>(buffer, VERSION);
+    size_t countOffset = buffer.size();
+    snapshotPut<uint32_t>(buffer, 0);
+
+    uint32_t count = 0;
+    string payload{};
+    for(const Outline* o:outlines) {
+        auto f = fingerprints.find(o->getKey());
+        if(f != fingerprints.end()) {
+            payload.clear();
+            putOutline(payload, o);
+
+            snapshotPutString(buffer, o->getKey());
+            snapshotPut<int64_t>(buffer, f->second.modified);
+            snapshotPut<uint64_t>(buffer, f->second.size);
+            snapshotPut<uint64_t>(buffer, f->second.hash);
+            snapshotPut<uint64_t>(buffer, snapshotHash(payload.data(), payload.size()));
+            snapshotPut<uint64_t>(buffer, payload.size());
+            buffer.append(payload);
+            count++;
+        }
+    }
+    memcpy(&buffer[countOffset], &count, sizeof(count));
+
+    return snapshotWrite(snapshotPath, buffer);
+}
+
+} // m8r namespace
@@ -0,0 +1,117 @@
+/*
+ memory_snapshot.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_MEMORY_SNAPSHOT_H_
+#define M8R_MEMORY_SNAPSHOT_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <cstdint>
+
+#include "../gear/file_utils.h"
+#include "../model/outline.h"
+#include "../mind/ontology/ontology.h"
+
+namespace m8r {
+
+/**
+ * @brief Binary snapshot of parsed outlines.
+ *
+ * Snapshot allows to skip lexing and parsing of Markdown files which
+ * didn't change since the last time repository was learned. Entries
+ * are keyed by outline file path and valid only if file modification
+ * time, size and content hash match. Snapshot file is memory mapped
+ * and outlines are decoded on demand. Missing, stale or corrupted
+ * entries are reported as misses - caller is expected to parse
+ * such outlines from Markdown.
+ *
+ * Snapshot content is immutable once opened i.e. outline() can be
+ * called from multiple threads.
+ */
+class MemorySnapshot
+{
+public:
+    static constexpr const char* MAGIC = "M8RSNAP";
+    static constexpr uint32_t VERSION = 1;
+
+    struct Fingerprint {
+        int64_t modified;
+        uint64_t size;
+        uint64_t hash;
+
+        bool operator==(const Fingerprint& f) const {
+            return modified==f.modified && size==f.size && hash==f.hash;
+        }
+    };
+
+private:
+    struct Entry {
+        Fingerprint fingerprint;
+        const char* data;
+        size_t size;
+    };
+
+    Ontology& ontology;
+
+    MemoryMappedFile* file;
+    std::map<std::string,Entry> entries;
+
+public:
+    explicit MemorySnapshot(Ontology& ontology);
+    MemorySnapshot(const MemorySnapshot&) = delete;
+    MemorySnapshot(const MemorySnapshot&&) = delete;
+    MemorySnapshot &operator=(const MemorySnapshot&) = delete;
+    MemorySnapshot &operator=(const MemorySnapshot&&) = delete;
+    ~MemorySnapshot();
+
+    /**
+     * @brief Calculate fingerprint of given file.
+     * @return false if file cannot be read.
+     */
+    static bool fingerprint(const std::string& filePath, Fingerprint& fingerprint);
+
+    /**
+     * @brief Open snapshot file - corrupted or incompatible snapshot is silently ignored.
+     */
+    void open(const std::string& snapshotPath);
+    void close();
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Decode outline of given file.
+     * @return nullptr if there is no valid entry for the file.
+     */
+    Outline* outline(const std::string& filePath, const Fingerprint& fingerprint);
+
+    /**
+     * @brief Write snapshot of given outlines - outlines w/o fingerprint are skipped.
+     */
+    static bool save(
+            const std::string& snapshotPath,
+            const std::vector<Outline*>& outlines,
+            const std::map<std::string,Fingerprint>& fingerprints);
+
+private:
+    bool index(const char* data, size_t size);
+};
+
+} // m8r namespace
+
+#endif /* M8R_MEMORY_SNAPSHOT_H_ */
@@ -0,0 +1,155 @@
+/*
+ snapshot_io.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_SNAPSHOT_IO_H_
+#define M8R_SNAPSHOT_IO_H_
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+
+namespace m8r {
+
+/*
+ * Binary snapshots (memory, AI model) are local caches i.e. values are
+ * stored in native byte order and strings as u32 length followed by bytes.
+ */
+
+inline uint64_t snapshotHash(const char* data, size_t size)
+{
+    // FNV-1a over 64b words w/ byte tail
+    uint64_t h = 14695981039346656037ULL;
+    constexpr uint64_t prime = 1099511628211ULL;
+    size_t i = 0;
+    for(; i+sizeof(uint64_t)<=size; i+=sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data+i, sizeof(word));
+        h ^= word;
+        h *= prime;
+        h ^= h>>29;
+    }
+    for(; i<size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= prime;
+    }
+    return h;
+}
+
+template<class T>
+void snapshotPut(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void snapshotPutString(std::string& buffer, const std::string& s)
+{
+    snapshotPut<uint32_t>(buffer, s.size());
+    buffer.append(s);
+}
+
+/**
+ * @brief Write snapshot aside and rename it so that readers never see partially written snapshot.
+ */
+inline bool snapshotWrite(const std::string& snapshotPath, const std::string& buffer)
+{
+    std::string tmpPath{snapshotPath};
+    tmpPath += ".tmp";
+    {
+        std::ofstream out{tmpPath, std::ios::binary|std::ios::trunc};
+        if(!out.write(buffer.data(), buffer.size())) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    return std::rename(tmpPath.c_str(), snapshotPath.c_str()) == 0;
+}
+
+/**
+ * @brief Bounds checked reader - any overflow makes reader invalid.
+ */
+class SnapshotReader
+{
+private:
+    const char* p;
+    const char* end;
+    bool valid;
+
+public:
+    explicit SnapshotReader(const char* data, size_t size)
+        : p(data), end(data+size), valid(true) {}
+
+    bool isValid() const { return valid; }
+    void invalidate() { valid = false; }
+    bool isEnd() const { return p==end; }
+    size_t remaining() const { return end-p; }
+    const char* position() const { return p; }
+
+    template<class T>
+    T get() {
+        T value{};
+        if(valid && remaining()>=sizeof(T)) {
+            memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+        } else {
+            valid = false;
+        }
+        return value;
+    }
+
+    const char* skip(size_t size) {
+        if(valid && remaining()>=size) {
+            const char* result = p;
+            p += size;
+            return result;
+        }
+        valid = false;
+        return nullptr;
+    }
+
+    /**
+     * @brief Read count of items of at least minItemSize bytes each.
+     */
+    uint32_t getCount(size_t minItemSize) {
+        uint32_t count = get<uint32_t>();
+        if(count > remaining()/minItemSize) {
+            valid = false;
+            return 0;
+        }
+        return count;
+    }
+
+    void getString(std::string& s) {
+        uint32_t size = get<uint32_t>();
+        const char* data = skip(size);
+        if(data) {
+            s.assign(data, size);
+        }
+    }
+
+    std::string* newString() {
+        std::string* s = new std::string{};
+        getString(*s);
+        return s;
+    }
+};
+
+} // m8r namespace
+
+#endif /* M8R_SNAPSHOT_IO_H_ */
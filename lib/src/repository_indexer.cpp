@@ -18,12 +18,26 @@
  */
 #include "repository_indexer.h"
 
+#include <algorithm>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <poll.h>
+#endif
+
 using namespace std;
 
 namespace m8r {
 
+#ifdef __linux__
+// file CREATE is ignored - content is complete on CLOSE_WRITE
+constexpr uint32_t WATCH_MASK
+    = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+#endif
+
 RepositoryIndexer::RepositoryIndexer()
-    : repository(nullptr)
+    : repository(nullptr),
+      watchFd(-1)
 {}
 
 RepositoryIndexer::~RepositoryIndexer() {
@@ -32,6 +46,8 @@ RepositoryIndexer::~RepositoryIndexer() {
 
 void RepositoryIndexer::clear()
 {
+    unwatch();
+
     repository = nullptr;
 
     for(const string* f:allFiles) {
@@ -206,6 +222,237 @@ void RepositoryIndexer::updateIndexStencils(const string& directory, set<const s
     }
 }
 
+bool RepositoryIndexer::watch()
+{
+#ifdef __linux__
+    if(!repository || repository->getMode()!=Repository::RepositoryMode::REPOSITORY) {
+        return false;
+    }
+
+    unwatch();
+    if((watchFd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC)) == -1) {
+        return false;
+    }
+
+    watchDirectory(memoryDirectory, true);
+    if(repository->getType() == Repository::RepositoryType::MINDFORGER) {
+        watchDirectory(outlineStencilsDirectory, false);
+        watchDirectory(noteStencilsDirectory, false);
+    }
+    MF_DEBUG(endl << "Watching " << watchedDirectories.size() << " repository directories" << endl);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RepositoryIndexer::unwatch()
+{
+    if(watchFd != -1) {
+        // closing inotify instance removes all its watches
+        close(watchFd);
+        watchFd = -1;
+    }
+    watchedDirectories.clear();
+}
+
+void RepositoryIndexer::watchDirectory(const string& directory, bool recursive)
+{
+#ifdef __linux__
+    int wd = inotify_add_watch(watchFd, directory.c_str(), WATCH_MASK);
+    if(wd == -1) {
+        return;
+    }
+    watchedDirectories[wd] = directory;
+
+    if(recursive) {
+        DIR *dir;
+        if((dir = opendir(directory.c_str()))) {
+            const struct dirent *entry;
+            string path;
+            while((entry = readdir(dir))) {
+                if(entry->d_type == DT_DIR && strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+                    path.assign(directory);
+                    path += FILE_PATH_SEPARATOR;
+                    path += entry->d_name;
+                    watchDirectory(path, true);
+                }
+            }
+            closedir(dir);
+        }
+    }
+#else
+    UNUSED_ARG(directory);
+    UNUSED_ARG(recursive);
+#endif
+}
+
+void RepositoryIndexer::scanMarkdowns(const string& directory, vector<string>& paths)
+{
+    DIR *dir;
+    if((dir = opendir(directory.c_str()))) {
+        const struct dirent *entry;
+        string path;
+        while((entry = readdir(dir))) {
+            if(strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+                path.assign(directory);
+                path += FILE_PATH_SEPARATOR;
+                path += entry->d_name;
+                if(entry->d_type == DT_DIR) {
+                    scanMarkdowns(path, paths);
+                } else {
+                    paths.push_back(path);
+                }
+            }
+        }
+        closedir(dir);
+    }
+}
+
+set<const string*>* RepositoryIndexer::indexOf(const string& path, RepositoryChange::Kind& kind)
+{
+    string directory, file;
+    pathToDirectoryAndFile(path, directory, file);
+    if(outlineStencilsDirectory.size() && directory==outlineStencilsDirectory) {
+        kind = RepositoryChange::Kind::OUTLINE_STENCIL;
+        return &outlineStencils;
+    } else if(noteStencilsDirectory.size() && directory==noteStencilsDirectory) {
+        kind = RepositoryChange::Kind::NOTE_STENCIL;
+        return &noteStencils;
+    } else if(stringStartsWith(path, memoryDirectory+FILE_PATH_SEPARATOR)) {
+        kind = RepositoryChange::Kind::OUTLINE;
+        return &allFiles;
+    }
+    return nullptr;
+}
+
+bool RepositoryIndexer::updateIndex(vector<RepositoryChange>& changes, int timeout)
+{
+    changes.clear();
+
+#ifdef __linux__
+    if(watchFd == -1) {
+        return false;
+    }
+    if(timeout) {
+        struct pollfd pfd{watchFd, POLLIN, 0};
+        if(poll(&pfd, 1, timeout) <= 0) {
+            return false;
+        }
+    }
+
+    // paths in the order of the first touch - events for the same path are coalesced
+    vector<string> touched{};
+    set<string> touchedSet{};
+    auto touch = [&](const string& path) {
+        if(touchedSet.insert(path).second) {
+            touched.push_back(path);
+        }
+    };
+
+    alignas(struct inotify_event) char buffer[16*1024];
+    ssize_t length;
+    while((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+        for(char* p=buffer; p<buffer+length; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event)+event->len;
+
+            if(event->mask & IN_Q_OVERFLOW) {
+                MF_DEBUG(endl << "Watch events queue OVERFLOW > rescanning repository");
+                vector<string> paths{};
+                scanMarkdowns(memoryDirectory, paths);
+                if(outlineStencilsDirectory.size()) {
+                    scanMarkdowns(outlineStencilsDirectory, paths);
+                    scanMarkdowns(noteStencilsDirectory, paths);
+                }
+                for(const string* f:allFiles) touch(*f);
+                for(const string* f:outlineStencils) touch(*f);
+                for(const string* f:noteStencils) touch(*f);
+                for(const string& f:paths) touch(f);
+                continue;
+            }
+            if(event->mask & IN_IGNORED) {
+                watchedDirectories.erase(event->wd);
+                continue;
+            }
+            auto d = watchedDirectories.find(event->wd);
+            if(d == watchedDirectories.end() || !event->len) {
+                continue;
+            }
+
+            string path{d->second};
+            path += FILE_PATH_SEPARATOR;
+            path += event->name;
+            if(event->mask & IN_ISDIR) {
+                if(!stringStartsWith(d->second, memoryDirectory)) {
+                    // stencils directories are not recursive
+                    continue;
+                }
+                if(event->mask & (IN_CREATE|IN_MOVED_TO)) {
+                    watchDirectory(path, true);
+                    vector<string> paths{};
+                    scanMarkdowns(path, paths);
+                    for(const string& f:paths) touch(f);
+                } else if(event->mask & (IN_DELETE|IN_MOVED_FROM)) {
+                    string prefix{path};
+                    prefix += FILE_PATH_SEPARATOR;
+                    for(const string* f:allFiles) {
+                        if(stringStartsWith(*f, prefix)) touch(*f);
+                    }
+                }
+            } else if(event->mask & (IN_CLOSE_WRITE|IN_MOVED_TO|IN_DELETE|IN_MOVED_FROM)) {
+                touch(path);
+            }
+        }
+    }
+
+    // apply changes to the index: resulting change is determined by index and filesystem state
+    bool updated = false;
+    RepositoryChange::Kind kind;
+    for(const string& path:touched) {
+        set<const string*>* index = indexOf(path, kind);
+        if(!index) {
+            continue;
+        }
+        bool markdown = fileHasMarkdownExtension(path);
+        auto indexed = find_if(index->begin(), index->end(), [&path](const string* f) { return *f==path; });
+        bool exists = isFile(path.c_str());
+        if(exists) {
+            if(indexed == index->end()) {
+                if(kind==RepositoryChange::Kind::OUTLINE || markdown) {
+                    string* p = new string{path};
+                    index->insert(p);
+                    if(kind==RepositoryChange::Kind::OUTLINE && markdown) {
+                        markdowns.insert(p);
+                    }
+                    updated = true;
+                }
+                if(markdown) {
+                    changes.push_back(RepositoryChange{kind, RepositoryChange::Type::CREATED, path});
+                }
+            } else if(markdown) {
+                changes.push_back(RepositoryChange{kind, RepositoryChange::Type::MODIFIED, path});
+            }
+        } else if(indexed != index->end()) {
+            const string* p = *indexed;
+            index->erase(indexed);
+            markdowns.erase(p);
+            delete p;
+            updated = true;
+            if(markdown) {
+                changes.push_back(RepositoryChange{kind, RepositoryChange::Type::DELETED, path});
+            }
+        }
+    }
+
+    MF_DEBUG(endl << "Repository watch: " << touched.size() << " file(s) touched, " << changes.size() << " Markdown change(s)" << endl);
+    return updated || changes.size();
+#else
+    UNUSED_ARG(timeout);
+    return false;
+#endif
+}
+
 const set<const string*> RepositoryIndexer::getMarkdownFiles() const {
     return markdowns;
 }
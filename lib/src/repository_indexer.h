@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
 
 #include "debug.h"
 #include "gear/file_utils.h"
@@ -37,6 +38,27 @@
 
 namespace m8r {
 
+/**
+ * @brief Change of a Markdown file in the indexed repository.
+ */
+struct RepositoryChange {
+    enum class Kind {
+        OUTLINE,
+        OUTLINE_STENCIL,
+        NOTE_STENCIL
+    };
+
+    enum class Type {
+        CREATED,
+        MODIFIED,
+        DELETED
+    };
+
+    Kind kind;
+    Type type;
+    std::string path;
+};
+
 /**
  * @brief MindForger/Markdown repository/file indexer.
  */
@@ -84,6 +106,13 @@ private:
     std::set<const std::string*> outlineStencils;
     std::set<const std::string*> noteStencils;
 
+    /**
+     * @brief inotify instance (-1 if repository is not watched).
+     */
+    int watchFd;
+    // watch descriptor -> watched directory
+    std::map<int,std::string> watchedDirectories;
+
 public:
     explicit RepositoryIndexer();
     RepositoryIndexer(const RepositoryIndexer&) = delete;
@@ -102,6 +131,36 @@ public:
      */
     void updateIndex();
 
+    /**
+     * @brief Start watching repository for changes of Markdown files.
+     *
+     * Memory directory is watched recursively, stencils directories are
+     * watched as well. Watching is supported on Linux only (inotify).
+     *
+     * @return false if repository cannot be watched.
+     */
+    bool watch();
+    void unwatch();
+    bool isWatching() const { return watchFd!=-1; }
+    /**
+     * @brief File descriptor which becomes readable on repository change e.g. for QSocketNotifier.
+     */
+    int getWatchFd() const { return watchFd; }
+
+    /**
+     * @brief Incrementally update index using pending watch events.
+     *
+     * Created, modified, deleted and renamed files (rename is reported as
+     * deletion of the old path and creation of the new one) are coalesced so
+     * that every changed file is reported once and in the order in which
+     * it was touched first.
+     *
+     * @param changes       changed Markdown files.
+     * @param timeout       milliseconds to wait for an event (0 doesn't block).
+     * @return true if index changed.
+     */
+    bool updateIndex(std::vector<RepositoryChange>& changes, int timeout=0);
+
     /**
      * @brief Clear all fields.
      */
@@ -118,6 +177,10 @@ public:
 private:
     void updateIndexMemory(const std::string& directory);
     void updateIndexStencils(const std::string& directory, std::set<const std::string*>& stencils);
+
+    void watchDirectory(const std::string& directory, bool recursive);
+    void scanMarkdowns(const std::string& directory, std::vector<std::string>& paths);
+    std::set<const std::string*>* indexOf(const std::string& path, RepositoryChange::Kind& kind);
 };
 
 } /* namespace */
@@ -0,0 +1,67 @@
+/*
+ markdown_arena.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_MARKDOWN_ARENA_H_
+#define M8R_MARKDOWN_ARENA_H_
+
+#include "../../gear/object_pool.h"
+#include "markdown_lexem.h"
+#include "markdown_ast_node.h"
+
+namespace m8r {
+
+/**
+ * @brief Arena which owns all lexems and AST nodes of one document parse.
+ *
+ * Lexer and parser allocate lexems and sections from the arena, they are
+ * NOT deleted individually - everything is freed in one step when arena
+ * is cleared or destroyed. Reusable lexems from MarkdownLexemTable are
+ * never stored in the arena.
+ */
+class MarkdownArena
+{
+private:
+    ObjectPool<MarkdownLexem> lexems;
+    ObjectPool<MarkdownAstNodeSection> sections;
+
+public:
+    MarkdownArena() {}
+    MarkdownArena(const MarkdownArena&) = delete;
+    MarkdownArena(const MarkdownArena&&) = delete;
+    MarkdownArena &operator=(const MarkdownArena&) = delete;
+    MarkdownArena &operator=(const MarkdownArena&&) = delete;
+    ~MarkdownArena() {}
+
+    template<class... Args>
+    MarkdownLexem* lexem(Args&&... args) { return lexems.make(std::forward<Args>(args)...); }
+
+    template<class... Args>
+    MarkdownAstNodeSection* section(Args&&... args) { return sections.make(std::forward<Args>(args)...); }
+
+    size_t size() const { return lexems.size()+sections.size(); }
+    size_t getChunkCount() const { return lexems.getChunkCount()+sections.getChunkCount(); }
+
+    void clear() {
+        sections.clear();
+        lexems.clear();
+    }
+};
+
+} // m8r namespace
+
+#endif /* M8R_MARKDOWN_ARENA_H_ */
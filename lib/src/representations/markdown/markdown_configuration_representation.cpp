@@ -48,6 +48,7 @@ constexpr const auto CONFIG_SETTING_MIND_STATE = "* Mind state: ";
 constexpr const auto CONFIG_SETTING_MIND_TIME_SCOPE_LABEL = "* Time scope: ";
 constexpr const auto CONFIG_SETTING_MIND_TAGS_SCOPE_LABEL = "* Tags scope: ";
 constexpr const auto CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL = "* Async refresh interval (ms): ";
+constexpr const auto CONFIG_SETTING_MIND_AA_ALGORITHM = "* Associations algorithm: ";
 
 // repositories
 constexpr const auto CONFIG_SETTING_ACTIVE_REPOSITORY_LABEL = "* Active repository: ";
@@ -104,12 +105,7 @@ void MarkdownConfigurationRepresentation::configuration(vector<MarkdownAstNodeSe
             }
         }
 
-        // delete AST
-        for(MarkdownAstNodeSection* node:*ast) {
-            if(node!=nullptr) {
-                delete node;
-            }
-        }
+        // delete AST - nodes are owned by Markdown document's arena
         delete ast;
     }
 }
@@ -259,6 +255,15 @@ void MarkdownConfigurationRepresentation::configuration(string* title, vector<st
                         }
                         i %= 10000;
                         c.setDistributorSleepInterval(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AA_ALGORITHM) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AA_ALGORITHM));
+                        if(t.find("min-hash") != std::string::npos) {
+                            c.setAaAlgorithm(Configuration::AssociationAssessmentAlgorithm::MIN_HASH);
+                        } else if(t.find("bow") != std::string::npos) {
+                            c.setAaAlgorithm(Configuration::AssociationAssessmentAlgorithm::BOW);
+                        } else {
+                            c.setAaAlgorithm(Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS);
+                        }
                     }
                 }
             }
@@ -307,7 +312,7 @@ string* MarkdownConfigurationRepresentation::to(Configuration& c)
 string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
 {
     stringstream s{};
-    string timeScopeAsString{}, tagsScopeAsString{}, mindStateAsString{"sleep"};
+    string timeScopeAsString{}, tagsScopeAsString{}, mindStateAsString{"sleep"}, aaAlgorithmAsString{"weighted-fts"};
     if(c) {
         // time
         c->getTimeScope().toString(timeScopeAsString);
@@ -321,6 +326,17 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
         }
         // mind state
         if(c->getDesiredMindState()==Configuration::MindState::THINKING) mindStateAsString= "think";
+        // associations
+        switch(c->getAaAlgorithm()) {
+        case Configuration::AssociationAssessmentAlgorithm::BOW:
+            aaAlgorithmAsString = "bow";
+            break;
+        case Configuration::AssociationAssessmentAlgorithm::MIN_HASH:
+            aaAlgorithmAsString = "min-hash";
+            break;
+        default:
+            break;
+        }
     } else {
         timeScopeAsString.assign(Configuration::DEFAULT_TIME_SCOPE);
     }
@@ -345,6 +361,8 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL << (c?c->getDistributorSleepInterval():Configuration::DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL+1) << endl <<
          "    * Sleep interval (miliseconds) between asynchronous mind-related evaluations (associations, ...)" << endl <<
          "    * Examples: 3000, 5000, 10000" << endl <<
+         CONFIG_SETTING_MIND_AA_ALGORITHM << aaAlgorithmAsString << endl <<
+         "    * Examples: weighted-fts, bow, min-hash (approximate associations for repositories with too many Notes for other algorithms)" << endl <<
          endl <<
 
          "# " << CONFIG_SECTION_APP << endl <<
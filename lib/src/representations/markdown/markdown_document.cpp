@@ -40,6 +40,7 @@ void MarkdownDocument::clear()
         delete ast;
         ast = nullptr;
     }
+    arena.clear();
     this->format = Format::MINDFORGER;
 }
 
@@ -47,7 +48,8 @@ void MarkdownDocument::from()
 {
     clear();
     modified = fileModificationTime(filePath);
-    MarkdownLexerSections lexer{filePath};
+    // zero copy lexing - lexems are views of the file mapped to memory
+    MarkdownLexerSections lexer{filePath, MarkdownLexerSections::Mode::MMAP, &arena};
     lexer.tokenize();
     // IMPROVE the rest of this section could be shared by file & text
     if(lexer.getLexems().size()) {
@@ -66,7 +68,7 @@ void MarkdownDocument::from(const std::string* text)
 {
     clear();
     modified = datetimeNow();
-    MarkdownLexerSections lexer{};
+    MarkdownLexerSections lexer{nullptr, MarkdownLexerSections::Mode::MMAP, &arena};
     lexer.tokenize(text);
     // IMPROVE the rest of this section could be shared by file & text
     if(lexer.getLexems().size()) {
@@ -101,10 +103,8 @@ unsigned MarkdownDocument::getFileSize() const
 
 MarkdownDocument::~MarkdownDocument()
 {
+    // AST nodes are freed by arena
     if(ast) {
-        for(MarkdownAstNodeSection*& node:*ast) {
-            delete node;
-        }
         delete ast;
         ast = nullptr;
     }
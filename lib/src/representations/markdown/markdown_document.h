@@ -28,6 +28,7 @@
 
 #include "../../gear/string_utils.h"
 #include "markdown_ast_node.h"
+#include "markdown_arena.h"
 #include "markdown_lexer_sections.h"
 #include "markdown_parser_sections.h"
 #include "markdown_outline_metadata.h"
@@ -66,6 +67,10 @@ private:
      * @brief Markdown root section name.
      */
     std::string name;
+    /**
+     * @brief Lexems and AST nodes of the parsed document.
+     */
+    MarkdownArena arena;
     std::vector<MarkdownAstNodeSection*>* ast;
 
 public:
@@ -93,6 +98,8 @@ public:
     std::vector<MarkdownAstNodeSection*>* getAst() const { return ast; }
     /**
      * @brief Get AST to disassemble it in order to create an instance efficiently.
+     *
+     * Caller owns the vector, but NOT AST nodes - they live in document's arena.
      */
     std::vector<MarkdownAstNodeSection*>* moveAst() {
         std::vector<MarkdownAstNodeSection*>* result = ast;
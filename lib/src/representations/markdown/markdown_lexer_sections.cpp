@@ -168,12 +168,21 @@ MarkdownSymbolTable::~MarkdownSymbolTable()
  * MarkdownLexerSections
  */
 
-MarkdownLexerSections::MarkdownLexerSections(const string* filePath)
+MarkdownLexerSections::MarkdownLexerSections(const string* filePath, Mode mode, MarkdownArena* arena)
 {
+    if(arena) {
+        this->arena = arena;
+        this->ownArena = false;
+    } else {
+        this->arena = new MarkdownArena{};
+        this->ownArena = true;
+    }
     this->filePath = filePath;
+    this->mode = mode;
     this->fileSize = 0;
     this->inCodeBlock = false;
     this->lastBrTokensOffset = 0;
+    this->mappedFile = nullptr;
 }
 
 MarkdownLexerSections::~MarkdownLexerSections()
@@ -184,78 +193,104 @@ MarkdownLexerSections::~MarkdownLexerSections()
             delete line;
         }
     }
+    if(mappedFile) {
+        delete mappedFile;
+    }
 
-    // lexems
-    for(MarkdownLexem*& lexem:lexems) {
-        if(lexem!=nullptr) {
-            if(!MarkdownSymbolTable::LEXEM.contains(lexem)) {
-                delete lexem;
-                lexem=nullptr;
-            }
-        }
+    // lexems are owned by arena
+    if(ownArena) {
+        delete arena;
     }
 }
 
 void MarkdownLexerSections::tokenize()
 {
     fileSize = 0;
-    if(fileToLines(filePath, lines, fileSize)) {
-        // IMPROVE body of this function can be shared by file & text
-        lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
-
-        unsigned offset = 0;
-        while(nextToken(offset)) {
-            offset++;
+    if(mode==Mode::MMAP) {
+        mappedFile = new MemoryMappedFile{filePath};
+        if(mappedFile->isMapped()) {
+            bufferToLineViews(mappedFile->getData(), mappedFile->getSize());
+            // size as it would be calculated by lines loading (each line w/ EOL)
+            fileSize = mappedFile->getSize();
+            if(mappedFile->getData()[fileSize-1] != '\n') {
+                fileSize++;
+            }
+            tokenizeLines();
         }
-
-        if(lexems.size()==1) {
-            lexems.clear();
-        } else {
-            lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
+    } else if(fileToLines(filePath, lines, fileSize)) {
+        for(string* line:lines) {
+            lineViews.push_back(MarkdownLine{line->data(), line->size()});
         }
+        tokenizeLines();
     }
 }
 
 void MarkdownLexerSections::tokenize(const string* text)
 {
-    if(stringToLines(text, lines)) {
-        // IMPROVE body of this function can be shared by file & text
-        lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
-
-        unsigned offset = 0;
-        while(nextToken(offset)) {
-            offset++;
+    if(mode==Mode::MMAP) {
+        if(text && text->size()) {
+            // text is lexed in place - it MUST outlive the lexer
+            bufferToLineViews(text->data(), text->size());
+            tokenizeLines();
+        }
+    } else if(stringToLines(text, lines)) {
+        for(string* line:lines) {
+            lineViews.push_back(MarkdownLine{line->data(), line->size()});
         }
+        tokenizeLines();
+    }
+}
 
-        if(lexems.size()==1) {
-            lexems.clear();
-        } else {
-            lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
+void MarkdownLexerSections::bufferToLineViews(const char* buffer, size_t size)
+{
+    // lines are split exactly like getline() does it - trailing EOL doesn't start a new line
+    const char* end = buffer+size;
+    const char* eol;
+    while(buffer < end) {
+        eol = static_cast<const char*>(memchr(buffer, '\n', end-buffer));
+        if(eol == nullptr) {
+            eol = end;
         }
+        lineViews.push_back(MarkdownLine{buffer, static_cast<size_t>(eol-buffer)});
+        buffer = eol+1;
+    }
+}
+
+void MarkdownLexerSections::tokenizeLines()
+{
+    lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
+
+    unsigned offset = 0;
+    while(nextToken(offset)) {
+        offset++;
+    }
+
+    if(lexems.size()==1) {
+        lexems.clear();
+    } else {
+        lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
     }
 }
 
 bool MarkdownLexerSections::lexWhitespaces(const unsigned offset, unsigned short int& idx)
 {
     unsigned short int i = idx+1;
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>i && isspace(lines[offset]->at(i))) {
-            i++;
-        }
-        if(i != idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx));
-            idx = i-1;
-            return true;
-        }
+    while(lineSize(offset)>i && isspace(lineAt(offset,i))) {
+        i++;
+    }
+    if(i != idx+1) {
+        lexems.push_back(arena->lexem(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx));
+        idx = i-1;
+        return true;
     }
     return false;
 }
 
 bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=3
+    if(lineSize(offset)>=3
          &&
-       lines[offset]->at(0)=='`' && lines[offset]->at(1)=='`' && lines[offset]->at(2)=='`'
+       lineAt(offset,0)=='`' && lineAt(offset,1)=='`' && lineAt(offset,2)=='`'
     ){
         return true;
     } else {
@@ -265,9 +300,9 @@ bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) con
 
 bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lineSize(offset)>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lineAt(offset,idx)=='-' && lineAt(offset,idx+1)=='-' && lineAt(offset,idx+2)=='>'
     ){
         return true;
     } else {
@@ -278,27 +313,25 @@ bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset
 bool MarkdownLexerSections::lexSectionSymbol(const unsigned offset, unsigned short int& idx)
 {
     unsigned depth = 0; // depth = [0,n)
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>depth && lines[offset]->at(depth)=='#') {
-            ++depth;
-        }
-        if(depth
-             &&
-           (lines[offset]->size()>=depth || isspace(lines[offset]->at(depth))))
-        {
-            idx = depth-1;
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::SECTION,depth-1));
-            return true;
-        }
+    while(lineSize(offset)>depth && lineAt(offset,depth)=='#') {
+        ++depth;
+    }
+    if(depth
+         &&
+       (lineSize(offset)>=depth || isspace(lineAt(offset,depth))))
+    {
+        idx = depth-1;
+        lexems.push_back(arena->lexem(MarkdownLexemType::SECTION,depth-1));
+        return true;
     }
     return false;
 }
 
 bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+4)
+    if(lineSize(offset)>=(size_t)(idx+4)
          &&
-       lines[offset]->at(idx)=='<' && lines[offset]->at(idx+1)=='!' && lines[offset]->at(idx+2)=='-' && lines[offset]->at(idx+3)=='-'
+       lineAt(offset,idx)=='<' && lineAt(offset,idx+1)=='!' && lineAt(offset,idx+2)=='-' && lineAt(offset,idx+3)=='-'
     ){
         idx+=4;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_BEGIN);
@@ -310,9 +343,9 @@ bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, uns
 
 bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lineSize(offset)>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lineAt(offset,idx)=='-' && lineAt(offset,idx+1)=='-' && lineAt(offset,idx+2)=='>'
     ){
         idx+=3;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_END);
@@ -325,17 +358,17 @@ bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsig
 bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned short int& idx)
 {
     // case insensitive 'metadata'
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+9)
+    if(lineSize(offset)>=(size_t)(idx+9)
          &&
-       (lines[offset]->at(idx+1)=='M' || lines[offset]->at(idx+1)=='m') &&
-       (lines[offset]->at(idx+2)=='e' || lines[offset]->at(idx+2)=='E') &&
-       (lines[offset]->at(idx+3)=='t' || lines[offset]->at(idx+3)=='T') &&
-       (lines[offset]->at(idx+4)=='a' || lines[offset]->at(idx+4)=='A') &&
-       (lines[offset]->at(idx+5)=='d' || lines[offset]->at(idx+5)=='D') &&
-       (lines[offset]->at(idx+6)=='a' || lines[offset]->at(idx+6)=='A') &&
-       (lines[offset]->at(idx+7)=='t' || lines[offset]->at(idx+7)=='T') &&
-       (lines[offset]->at(idx+8)=='a' || lines[offset]->at(idx+8)=='A') &&
-       lines[offset]->at(idx+9)==':'
+       (lineAt(offset,idx+1)=='M' || lineAt(offset,idx+1)=='m') &&
+       (lineAt(offset,idx+2)=='e' || lineAt(offset,idx+2)=='E') &&
+       (lineAt(offset,idx+3)=='t' || lineAt(offset,idx+3)=='T') &&
+       (lineAt(offset,idx+4)=='a' || lineAt(offset,idx+4)=='A') &&
+       (lineAt(offset,idx+5)=='d' || lineAt(offset,idx+5)=='D') &&
+       (lineAt(offset,idx+6)=='a' || lineAt(offset,idx+6)=='A') &&
+       (lineAt(offset,idx+7)=='t' || lineAt(offset,idx+7)=='T') &&
+       (lineAt(offset,idx+8)=='a' || lineAt(offset,idx+8)=='A') &&
+       lineAt(offset,idx+9)==':'
     ){
         idx+=9;
         lexems.push_back(symbolTable.LEXEM.META_BEGIN);
@@ -347,21 +380,21 @@ bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned sh
 
 bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
-        switch(lines[offset]->at(idx+1)) {
+    if(lineSize(offset) > (size_t)(idx+1)) {
+        switch(lineAt(offset,idx+1)) {
         case 't':
-            if(lines[offset]->at(idx+2)=='y' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='e' &&
-               (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+            if(lineAt(offset,idx+2)=='y' &&
+               lineAt(offset,idx+3)=='p' &&
+               lineAt(offset,idx+4)=='e' &&
+               (lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                 idx+=4;
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_type);
                 return true;
             } else {
-                if(lines[offset]->at(idx+2)=='a' &&
-                   lines[offset]->at(idx+3)=='g' &&
-                   lines[offset]->at(idx+4)=='s' &&
-                   (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                if(lineAt(offset,idx+2)=='a' &&
+                   lineAt(offset,idx+3)=='g' &&
+                   lineAt(offset,idx+4)=='s' &&
+                   (lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                     idx+=4;
                     lexems.push_back(symbolTable.LEXEM.META_PROPERTY_tags);
                     return true;
@@ -370,13 +403,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 }
             }
         case 'c':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='e' &&
-               lines[offset]->at(idx+4)=='a' &&
-               lines[offset]->at(idx+5)=='t' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='d' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='e' &&
+               lineAt(offset,idx+4)=='a' &&
+               lineAt(offset,idx+5)=='t' &&
+               lineAt(offset,idx+6)=='e' &&
+               lineAt(offset,idx+7)=='d' &&
+               (lineAt(offset,idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_created);
                 idx+=7;
                 return true;
@@ -384,30 +417,30 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'r':
-            if(lines[offset]->at(idx+2)=='e') {
-                if(lines[offset]->at(idx+3)=='a' &&
-                   lines[offset]->at(idx+4)=='d')
+            if(lineAt(offset,idx+2)=='e') {
+                if(lineAt(offset,idx+3)=='a' &&
+                   lineAt(offset,idx+4)=='d')
                 {
-                    if(lines[offset]->at(idx+5)=='s' &&
-                       (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+                    if(lineAt(offset,idx+5)=='s' &&
+                       (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                         idx+=5;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_reads);
                         return true;
                     } else {
-                        if((lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                        if((lineAt(offset,idx+5)==':' || !isspace(idx+5))) {
                             idx+=4;
                             lexems.push_back(symbolTable.LEXEM.META_PROPERTY_read);
                             return true;
                         }
                     }
                 } else {
-                    if(lines[offset]->at(idx+3)=='v' &&
-                       lines[offset]->at(idx+4)=='i' &&
-                       lines[offset]->at(idx+5)=='s' &&
-                       lines[offset]->at(idx+6)=='i' &&
-                       lines[offset]->at(idx+7)=='o' &&
-                       lines[offset]->at(idx+8)=='n' &&
-                       (lines[offset]->at(idx+9)==':' || !isspace(idx+9)))
+                    if(lineAt(offset,idx+3)=='v' &&
+                       lineAt(offset,idx+4)=='i' &&
+                       lineAt(offset,idx+5)=='s' &&
+                       lineAt(offset,idx+6)=='i' &&
+                       lineAt(offset,idx+7)=='o' &&
+                       lineAt(offset,idx+8)=='n' &&
+                       (lineAt(offset,idx+9)==':' || !isspace(idx+9)))
                     {
                         idx+=8;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_revision);
@@ -417,16 +450,16 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
             return false;
         case 'i':
-            if(lines[offset]->at(idx+2)=='m' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='o' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='t' &&
-               lines[offset]->at(idx+7)=='a' &&
-               lines[offset]->at(idx+8)=='n' &&
-               lines[offset]->at(idx+9)=='c' &&
-               lines[offset]->at(idx+10)=='e' &&
-               (lines[offset]->at(idx+11)==':' || !isspace(idx+11))) {
+            if(lineAt(offset,idx+2)=='m' &&
+               lineAt(offset,idx+3)=='p' &&
+               lineAt(offset,idx+4)=='o' &&
+               lineAt(offset,idx+5)=='r' &&
+               lineAt(offset,idx+6)=='t' &&
+               lineAt(offset,idx+7)=='a' &&
+               lineAt(offset,idx+8)=='n' &&
+               lineAt(offset,idx+9)=='c' &&
+               lineAt(offset,idx+10)=='e' &&
+               (lineAt(offset,idx+11)==':' || !isspace(idx+11))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_importance);
                 idx+=10;
                 return true;
@@ -434,13 +467,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'u':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='g' &&
-               lines[offset]->at(idx+4)=='e' &&
-               lines[offset]->at(idx+5)=='n' &&
-               lines[offset]->at(idx+6)=='c' &&
-               lines[offset]->at(idx+7)=='y' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='g' &&
+               lineAt(offset,idx+4)=='e' &&
+               lineAt(offset,idx+5)=='n' &&
+               lineAt(offset,idx+6)=='c' &&
+               lineAt(offset,idx+7)=='y' &&
+               (lineAt(offset,idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_urgency);
                 idx+=7;
                 return true;
@@ -448,14 +481,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'p':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='g' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='s' &&
-               lines[offset]->at(idx+8)=='s' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='r' &&
+               lineAt(offset,idx+3)=='o' &&
+               lineAt(offset,idx+4)=='g' &&
+               lineAt(offset,idx+5)=='r' &&
+               lineAt(offset,idx+6)=='e' &&
+               lineAt(offset,idx+7)=='s' &&
+               lineAt(offset,idx+8)=='s' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_progress);
                 idx+=8;
                 return true;
@@ -463,14 +496,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'm':
-            if(lines[offset]->at(idx+2)=='o' &&
-               lines[offset]->at(idx+3)=='d' &&
-               lines[offset]->at(idx+4)=='i' &&
-               lines[offset]->at(idx+5)=='f' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='e' &&
-               lines[offset]->at(idx+8)=='d' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='o' &&
+               lineAt(offset,idx+3)=='d' &&
+               lineAt(offset,idx+4)=='i' &&
+               lineAt(offset,idx+5)=='f' &&
+               lineAt(offset,idx+6)=='i' &&
+               lineAt(offset,idx+7)=='e' &&
+               lineAt(offset,idx+8)=='d' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_modified);
                 idx+=8;
                 return true;
@@ -479,11 +512,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
         case 'l':
             // key for relationships is 'links' because a) there are clashes for 'r' b) links is shorter than relationships
-            if(lines[offset]->at(idx+2)=='i' &&
-               lines[offset]->at(idx+3)=='n' &&
-               lines[offset]->at(idx+4)=='k' &&
-               lines[offset]->at(idx+5)=='s' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lineAt(offset,idx+2)=='i' &&
+               lineAt(offset,idx+3)=='n' &&
+               lineAt(offset,idx+4)=='k' &&
+               lineAt(offset,idx+5)=='s' &&
+               (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_links);
                 idx+=5;
                 return true;
@@ -491,11 +524,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 's':
-            if(lines[offset]->at(idx+2)=='c' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='p' &&
-               lines[offset]->at(idx+5)=='e' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lineAt(offset,idx+2)=='c' &&
+               lineAt(offset,idx+3)=='o' &&
+               lineAt(offset,idx+4)=='p' &&
+               lineAt(offset,idx+5)=='e' &&
+               (lineAt(offset,idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_scope);
                 idx+=5;
                 return true;
@@ -503,14 +536,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'd':
-            if(lines[offset]->at(idx+2)=='e' &&
-               lines[offset]->at(idx+3)=='a' &&
-               lines[offset]->at(idx+4)=='d' &&
-               lines[offset]->at(idx+5)=='l' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='n' &&
-               lines[offset]->at(idx+8)=='e' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lineAt(offset,idx+2)=='e' &&
+               lineAt(offset,idx+3)=='a' &&
+               lineAt(offset,idx+4)=='d' &&
+               lineAt(offset,idx+5)=='l' &&
+               lineAt(offset,idx+6)=='i' &&
+               lineAt(offset,idx+7)=='n' &&
+               lineAt(offset,idx+8)=='e' &&
+               (lineAt(offset,idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_deadline);
                 idx+=8;
                 return true;
@@ -529,19 +562,19 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
  */
 bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lineSize(offset)>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size();
+            i<lineSize(offset);
             i++) {
-            if(lines[offset]->at(i)=='-') {
+            if(lineAt(offset,i)=='-') {
                 if(startsWithHtmlCommentEndSymbol(offset,i)) {
                     if(i > idx+1) {
-                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+                        lexems.push_back(arena->lexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
                         idx=i;
                     }
                     lexHtmlCommentEndSymbol(offset,i);
-                    if(lines[offset]->size()>=i) {
+                    if(lineSize(offset)>=i) {
                         lexems.push_back(symbolTable.LEXEM.BR);
                     }
                     return true;
@@ -549,7 +582,7 @@ bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigne
             }
         }
         if(i > idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+            lexems.push_back(arena->lexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
             lexems.push_back(symbolTable.LEXEM.BR);
             idx=i;
             return true;
@@ -567,7 +600,7 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
         return false;
     } else {
         // previous line is valid section name && current line is header line for that name
-        if(lines[offset-1]!=nullptr && lines[offset-1]->size()>=2 && !isspace(lines[offset-1]->at(0))
+        if(lineSize(offset-1)>=2 && !isspace(lineAt(offset-1,0))
              &&
            isSameCharsLine(offset, delimiter))
         {
@@ -610,9 +643,9 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
                lexems[lexems.size()-2]->getType()==MarkdownLexemType::LINE)
             {
                 if(delimiter=='=') {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_equals,0));
+                    lexems.insert(lexems.begin()+lexems.size()-2, arena->lexem(MarkdownLexemType::SECTION_equals,0));
                 } else {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_hyphens,1));
+                    lexems.insert(lexems.begin()+lexems.size()-2, arena->lexem(MarkdownLexemType::SECTION_hyphens,1));
                 }
             } else {
                 addLineToLexems(offset);
@@ -629,17 +662,17 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
 
 void MarkdownLexerSections::addLineToLexems(const unsigned int offset)
 {
-    lexems.push_back(new MarkdownLexem{MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE});
+    lexems.push_back(arena->lexem(MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE));
     lexems.push_back(symbolTable.LEXEM.BR);
 }
 
 bool MarkdownLexerSections::nextToken(const unsigned int offset) {
-    if(offset<lines.size()) {
-        if(lines[offset]->size()==0) {
+    if(offset<lineViews.size()) {
+        if(lineSize(offset)==0) {
             lexems.push_back(symbolTable.LEXEM.BR);
             return true;
         } else {
-            switch(lines[offset]->at(0)) {
+            switch(lineAt(offset,0)) {
             case '`':
                 if(startsWithCodeBlockSymbol(offset)) {
                     // sections lexer just needs to detect code block to avoid detection of false sections, but no need to tokenize it
@@ -659,11 +692,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                         char cc;
                         unsigned short int ws=0, text=0, x = idx+1;
                         while(lookahead(offset,idx)) {
-                            cc = lines[offset]->at(++idx);
+                            cc = lineAt(offset,++idx);
                             if(isspace(cc)) {
                                 // a) whitespaces
                                 if(ws==0 && text) {
-                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                    lexems.push_back(arena->lexem(MarkdownLexemType::TEXT,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
                                     text = 0;
                                     x = idx;
                                 }
@@ -700,11 +733,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                         unsigned short int mess = 0;
                                         char ccc;
                                         while(lookahead(offset,idx)) {
-                                            ccc = lines[offset]->at(++idx);
+                                            ccc = lineAt(offset,++idx);
                                             if(ccc=='-' && lexHtmlCommentEndSymbol(offset,idx)) {
                                                 if(mess) {
                                                     // TODO BUG add text BEFORE last lexem
-                                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                                    lexems.push_back(arena->lexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
                                                 }
                                                 // IMPROVE process the rest of line after --> (ignored for now)
 
@@ -718,7 +751,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                             }
                                         }
                                         if(mess) {
-                                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                            lexems.push_back(arena->lexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
                                         }
 
                                         // TODO FIX
@@ -733,7 +766,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                 } else {
                                     // b2) text
                                     if(text==0 && ws) {
-                                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                        lexems.push_back(arena->lexem(MarkdownLexemType::WHITESPACES,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
                                         ws = 0;
                                         x = idx;
                                     }
@@ -742,10 +775,10 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                             }
                         } // while
                         if(ws) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.push_back(arena->lexem(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
                         }
                         if(text) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.push_back(arena->lexem(MarkdownLexemType::TEXT,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
                         }
                         lexems.push_back(symbolTable.LEXEM.BR);
                         return true;
@@ -774,12 +807,12 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
 bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c) const
 {
     // fail fast
-    if(lines[offset]!=nullptr && lines[offset]->size()
+    if(lineSize(offset)
          &&
-       lines[offset]->at(0)==c && lines[offset]->at(lines[offset]->size()-1)==c)
+       lineAt(offset,0)==c && lineAt(offset,lineSize(offset)-1)==c)
     {
-        for(unsigned i=1; i<lines[offset]->size()-1; i++) {
-            if(lines[offset]->at(i)!=c) {
+        for(unsigned i=1; i<lineSize(offset)-1; i++) {
+            if(lineAt(offset,i)!=c) {
                 return false;
             }
         }
@@ -790,7 +823,7 @@ bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c)
 
 bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
+    if(lineSize(offset) > (size_t)(idx+1)) {
         return true;
     } else {
         return false;
@@ -799,7 +832,7 @@ bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned shor
 
 bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==':') {
+    if(lineSize(offset)>(size_t)(idx+1) && lineAt(offset,idx+1)==':') {
         idx++;
         lexems.push_back(symbolTable.LEXEM.META_NAMEVALUE_DELIMITER);
         return true;
@@ -810,14 +843,14 @@ bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned off
 
 bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lineSize(offset)>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size() && lines[offset]->at(i)!=';';
+            i<lineSize(offset) && lineAt(offset,i)!=';';
             i++)
         {}
         if(i>idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1));
+            lexems.push_back(arena->lexem(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1));
             idx=i-1;
             return true;
         }
@@ -827,7 +860,7 @@ bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned
 
 bool MarkdownLexerSections::lexMetaPropertyDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==';') {
+    if(lineSize(offset)>(size_t)(idx+1) && lineAt(offset,idx+1)==';') {
         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_DELIMITER);
         idx++;
         return true;
@@ -838,18 +871,25 @@ bool MarkdownLexerSections::lexMetaPropertyDelimiter(const unsigned offset, unsi
 
 string* MarkdownLexerSections::getText(const MarkdownLexem* lexem)
 {
-    if(lexem!=nullptr && lines.size()) {
-        if(lexem->getOff()<lines.size()) {
-            if(lexem->getLng()==MarkdownLexem::WHOLE_LINE) {
+    if(lexem!=nullptr && lexem->getOff()<lineViews.size()) {
+        const MarkdownLine& line = lineViews[lexem->getOff()];
+        if(lexem->getLng()==MarkdownLexem::WHOLE_LINE) {
+            if(mode==Mode::LINES) {
+                // line ownership is handed over to the caller
                 string *result = lines[lexem->getOff()];
                 lines[lexem->getOff()] = nullptr;
+                lineViews[lexem->getOff()] = MarkdownLine{nullptr, 0};
                 return result;
             } else {
-                if(lexem->getLng()==0) {
-                    return new string{};
-                } else {
-                    return new string{lines[lexem->getOff()]->substr(lexem->getIdx(),lexem->getLng())};
-                }
+                return new string{line.text, line.size};
+            }
+        } else {
+            if(lexem->getLng()==0 || lexem->getIdx()>=line.size) {
+                return new string{};
+            } else {
+                return new string{
+                    line.text+lexem->getIdx(),
+                    std::min(static_cast<size_t>(lexem->getLng()), line.size-lexem->getIdx())};
             }
         }
     }
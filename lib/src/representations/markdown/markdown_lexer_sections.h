@@ -20,13 +20,16 @@
 #define M8R_MARKDOWN_LEXER_SECTIONS_H_
 
 #include <set>
+#include <cstring>
 #include <string>
+#include <algorithm>
 #include <vector>
 #include <unordered_set>
 
 #include "../../gear/lang_utils.h"
 #include "../../gear/file_utils.h"
 #include "markdown_lexem.h"
+#include "markdown_arena.h"
 
 namespace m8r {
 
@@ -99,24 +102,58 @@ public:
     void clearSymbols() { symbols.clear(); }
 };
 
+/**
+ * @brief Line of the lexed document - a view of the text which is owned by lexer.
+ */
+struct MarkdownLine
+{
+    const char* text;
+    size_t size;
+};
+
 /**
  * @brief Markdown lexical analyzer for section-level granularity parser.
  */
 class MarkdownLexerSections
 {
+public:
+    /**
+     * @brief Lexer mode.
+     *
+     * LINES loads document to heap allocated lines, MMAP maps the file to memory
+     * (or uses given text in place) and lines are just views of the buffer.
+     */
+    enum Mode {
+        LINES = 1,
+        MMAP = 2
+    };
+
 private:
     const std::string* filePath;
+    Mode mode;
     unsigned lastBrTokensOffset;
     bool inCodeBlock;
 
     unsigned long int fileSize;
     std::vector<std::string*> lines;
-    // IMPROVE prepare a LexemPool: vector + MarkdownLexem[1000] and allocate from there (performance)
+    MemoryMappedFile* mappedFile;
+    /**
+     * @brief Lines views used by lexer regardless mode.
+     */
+    std::vector<MarkdownLine> lineViews;
+    /**
+     * @brief Arena which owns lexems (and AST nodes created by parser) - own or given one.
+     */
+    MarkdownArena* arena;
+    bool ownArena;
     std::vector<MarkdownLexem*> lexems;
     MarkdownSymbolTable symbolTable;
 
 public:
-    explicit MarkdownLexerSections(const std::string* filePath=nullptr);
+    explicit MarkdownLexerSections(
+            const std::string* filePath=nullptr,
+            Mode mode=Mode::LINES,
+            MarkdownArena* arena=nullptr);
     MarkdownLexerSections(const MarkdownLexerSections &) = delete;
     MarkdownLexerSections(const MarkdownLexerSections &&);
     MarkdownLexerSections &operator=(const MarkdownLexerSections &) = delete;
@@ -132,6 +169,8 @@ public:
     std::string* getText(const MarkdownLexem*);
 
     void setFilePath(const std::string*& filePath) { this->filePath = filePath; }
+    Mode getMode() const { return mode; }
+    MarkdownArena& getArena() { return *arena; }
     unsigned long int getFileSize() const { return fileSize; }
     const std::vector<MarkdownLexem*>& getLexems() const { return lexems; }
     const std::vector<std::string*>& getLines() const { return lines; }
@@ -142,8 +181,18 @@ public:
     size_t size() const { return lexems.size(); }
 
 private:
+    void tokenizeLines();
+    void bufferToLineViews(const char* buffer, size_t size);
     bool nextToken(const unsigned int offset);
 
+    size_t lineSize(const unsigned offset) const { return lineViews[offset].size; }
+    /**
+     * @brief Get char on the line or 0 if index is out of the line.
+     */
+    char lineAt(const unsigned offset, const size_t idx) const {
+        return idx<lineViews[offset].size?lineViews[offset].text[idx]:0;
+    }
+
     inline bool lookahead(const unsigned offset, const unsigned short idx) const;
     void toggleInCodeBlock() { inCodeBlock=!inCodeBlock; }
 
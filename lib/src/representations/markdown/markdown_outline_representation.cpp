@@ -202,12 +202,7 @@ Outline* MarkdownOutlineRepresentation::outline(vector<MarkdownAstNodeSection*>*
             note(ast, off+1, outline);
         }
 
-        // delete AST
-        for(MarkdownAstNodeSection* node:*ast) {
-            if(node!=nullptr) {
-                delete node;
-            }
-        }
+        // delete AST - nodes are owned by Markdown document's arena
         delete ast;
     }
 
@@ -235,9 +230,6 @@ Note* MarkdownOutlineRepresentation::note(const string *text)
             result = note(ast);
         }
 
-        for(MarkdownAstNodeSection*& node:*ast) {
-            delete node;
-        }
         delete ast;
     }
     return result;
@@ -39,10 +39,8 @@ MarkdownParserSections::MarkdownParserSections(MarkdownLexerSections& lexer)
 
 MarkdownParserSections::~MarkdownParserSections()
 {
+    // AST nodes are owned by lexer's arena
     if(ast) {
-        for(MarkdownAstNodeSection*& node:*ast) {
-            delete node;
-        }
         delete ast;
         ast = nullptr;
     }
@@ -137,7 +135,7 @@ void MarkdownParserSections::preambleRule(size_t& offset)
 {
     // IMPROVE test w/o calling method doing the same checks
     if(lookaheadSection(offset+1) == nullptr) {
-        MarkdownAstNodeSection* result = new MarkdownAstNodeSection();
+        MarkdownAstNodeSection* result = lexer.getArena().section();
         result->setPreamble();
         result->setBody(sectionBodyRule(offset));
         ast->push_back(result);
@@ -183,7 +181,7 @@ MarkdownAstNodeSection* MarkdownParserSections::sectionRule(size_t& offset)
             // lexer ensures existence of LINE and BR right after SECTION_*
             depth = lexer[offset+1]->getType()==MarkdownLexemType::SECTION_equals?0:1;
             ++offset; // move to point to SECTION_*
-            result = new MarkdownAstNodeSection(lexer.getText(lexer[++offset])); // move to LINE
+            result = lexer.getArena().section(lexer.getText(lexer[++offset])); // move to LINE
             result->setPostDeclaredSection();
             result->setDepth(depth);
             ++offset; // skip BR
@@ -214,7 +212,7 @@ MarkdownAstNodeSection* MarkdownParserSections::sectionHeaderRule(size_t& offset
           next->getType()!=MarkdownLexemType::SECTION && next->getType()!=MarkdownLexemType::SECTION_equals && next->getType()!=MarkdownLexemType::SECTION_hyphens)
     {
         if((name=sectionNameRule(offset))!=nullptr) {
-            MarkdownAstNodeSection* result = new MarkdownAstNodeSection(name);
+            MarkdownAstNodeSection* result = lexer.getArena().section(name);
             if(sectionMetadataRule(result->getMetadata(), offset)) {
                 // skip section line's BR
                 skipBr(offset);
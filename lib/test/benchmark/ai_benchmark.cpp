@@ -17,12 +17,21 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <sstream>
 #include <string>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "../../src/mind/mind.h"
+#include "../../src/gear/file_utils.h"
+#include "../src/test_gear.h"
 
 using namespace std;
 using namespace m8r;
@@ -30,56 +39,724 @@ using namespace m8r;
 extern char* getMindforgerGitHomePath();
 
 /*
- * Performance improvements ideas:
- *   - IF |notes|>1000 THEN split aaMatrix rows to launch(CPU-1) tasks > start thread for each task > join threads (thread x down ~ 80% down)
- *   - compute above aaMatrix diagonal values only (2x faster ~ 50% down)
- *   - use trie instead of map in lexicon (10% faster ~ 10% down)
- *   - heuristics:
- *     - codereview calculateSimilarityByWords() > WordFrequencyList::evalUnion/Intersection must be MUCH faster
- *     - skip Ns w/ empty description
- *
- * Conclusion:
- *   - can be made 10x faster
- *   - 6' (5k Ns) to 36s ... which is still slow
+ * Generate repository w/ given number of outlines having given number of notes - notes
+ * descriptions are made of words w/ (roughly) Zipf distribution to make BoW realistic. If
+ * topics are given, then every note is about a random topic and half of its words are topic words.
  */
+void createAiBenchmarkRepository(string& repositoryDir, const int outlines, const int notes, const int topics=0)
+{
+    // deterministic LCG to get the same repository on every run
+    unsigned seed = 42;
+    auto random = [&seed](unsigned range) {
+        seed = seed*1103515245+12345;
+        return (seed>>8)%range;
+    };
+    const char* syllables[] = {"ka","to","mi","ra","ne","so","lu","ve","di","po","ze","ha","gu","fi","be","cy"};
+    vector<string> vocabulary{};
+    for(int w=0; w<3000; w++) {
+        string word{};
+        for(unsigned s=0, l=2+w%3; s<l; s++) {
+            word += syllables[random(16)];
+        }
+        vocabulary.push_back(word);
+    }
+    auto zipfWord = [&](){
+        // product of uniform variables prefers low indices
+        return vocabulary[random(vocabulary.size())*random(1000)/1000];
+    };
+    // topic is a small set of words - N about topic has every other word from it
+    vector<vector<string>> topicVocabulary(topics);
+    for(auto& t:topicVocabulary) {
+        for(int w=0; w<40; w++) {
+            t.push_back(vocabulary[random(vocabulary.size())]);
+        }
+    }
+
+    map<string,string> pathToContent{};
+    for(int o=0; o<outlines; o++) {
+        string content{"# "};
+        content += zipfWord() + " " + zipfWord() + " " + std::to_string(o);
+        content += "\n\n";
+        for(int n=0; n<notes; n++) {
+            content += "## " + zipfWord() + " " + zipfWord() + " " + zipfWord();
+            // two different tags
+            unsigned tag = random(20);
+            content += " <!-- Metadata: type: Idea; tags: t" + std::to_string(tag) + ",t" + std::to_string((tag+1+random(19))%20);
+            content += "; created: 2018-01-01 10:00:00; reads: 1; read: 2018-01-01 10:00:00; revision: 1; modified: 2018-01-01 10:00:00; -->\n";
+            const vector<string>* topic = topics?&topicVocabulary[random(topics)]:nullptr;
+            for(unsigned w=0, l=20+random(100); w<l; w++) {
+                content += (topic && w%2)?(*topic)[random(topic->size())]:zipfWord();
+                content += (w%12==11)?".\n":" ";
+            }
+            content += "\n\n";
+        }
+        pathToContent[repositoryDir+"/memory/o"+std::to_string(o)+".md"] = content;
+    }
+    createEmptyRepository(repositoryDir, pathToContent);
+}
+
 /*
  * Measurements
  *
+ * 1 thread ... 1.8s, 5.000 Ns, top-k neighbors ... precomputed N features (title word IDs, tag IDs, type, O), was 2.2s w/ Ns access
  * 2018/03/31 ...  46s (<1') , 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2) ... added stemmer (less words), only 10 relevant words compared
  * 2018/03/31 ... 129s (2')  , 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2) ... 1/2 of matrix, simplified vectors weight computation
  * 2018/03/31 ... 338s (5'30), 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2)
+ *
+ * AA matrix is precalculated by tiles in parallel - benchmark reports speedup
+ * against the number of threads and checks that results are the same. Only
+ * top-k neighbors of every N are kept i.e. AA memory is O(N*k).
  */
 TEST(AiBenchmark, DISABLED_AaMatrix)
 {
-    string repositoryPath{"/lib/test/resources/benchmark-repository"};
-    repositoryPath.insert(0, getMindforgerGitHomePath());
+    // generate repository: 100 Os w/ 50 Ns ~ 5.000 Ns
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50);
+
     m8r::Configuration& config = m8r::Configuration::getInstance();
     config.clear();
     config.setConfigFilePath("/tmp/cfg-aib-am.md");
-    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
     m8r::Mind mind(config);
-    mind.think();
+    mind.remind().setSnapshot(false);
+    mind.learn();
     cout << "Statistics:" << endl
     << "  Outlines: " << mind.remind().getOutlinesCount() << endl
+    << "  Notes   : " << mind.remind().getNotesCount() << endl
     << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize() << endl;
-
     ASSERT_LE(1, mind.remind().getOutlinesCount());
 
     /*
-     * Tokenize repository > make AI to think > find the most similar Notes pair
+     * Tokenize repository > precalculate AA matrix w/ different number of threads
      */
 
+    m8r::AiAaBoW aa{mind.remind(), mind};
     auto beginDream = chrono::high_resolution_clock::now();
-
-    // TODO to be rewritten mind.dream();
-
+    ASSERT_TRUE(aa.dream().get());
     auto endDream = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms" << endl);
+    cout << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms" << endl;
+
+    vector<unsigned> threadCounts{1, 2, 4, 8};
+    if(std::thread::hardware_concurrency() > 8) {
+        threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+    vector<vector<pair<size_t,float>>> expected{};
+    double singleThreadMs = 0;
+    for(unsigned threads:threadCounts) {
+        auto begin = chrono::high_resolution_clock::now();
+        aa.precalculateAa(threads);
+        auto end = chrono::high_resolution_clock::now();
+        double ms = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+        if(threads == 1) {
+            singleThreadMs = ms;
+            expected = aa.getAaNeighbors();
+        } else {
+            // deterministic results regardless of scheduling
+            EXPECT_EQ(expected, aa.getAaNeighbors());
+        }
+        cout << "AA matrix w/ " << threads << " thread(s) in " << ms << "ms ~ speedup "
+             << singleThreadMs/ms << " (" << std::thread::hardware_concurrency() << " CPU(s))" << endl;
+    }
 
-    // get the best associations of N
-    m8r::Note* n=mind.remind().getOutlines()[0]->getNotes()[0];
-    UNUSED_ARG(n);
+    // leaderboard of N
+    m8r::Note* n = mind.remind().getOutlines()[0]->getNotes()[0];
     std::vector<std::pair<m8r::Note*,float>> lb{};
-    // TODO to be rewritten mind.getAssociationsLeaderboard(n, lb);
-    // TODO to be rewritten m8r::Ai::print(n,lb);
+    shared_future<bool> f = aa.getAssociatedNotes(n, lb);
+    ASSERT_TRUE(f.get());
+    lb.clear();
+    aa.getAssociatedNotes(n, lb);
+    EXPECT_FALSE(lb.empty());
+    // leaderboard is neighbors list
+    ASSERT_EQ(expected[n->getAiAaMatrixIndex()].size(), lb.size());
+    for(size_t i=0; i<lb.size(); i++) {
+        EXPECT_EQ(expected[n->getAiAaMatrixIndex()][i].second, lb[i].second);
+    }
+#ifdef DO_MF_DEBUG
+    m8r::Ai::print(n,lb);
+#endif
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Similarity of N descriptions: relevant words lookup in word frequency lists (maps)
+ * compared to merge of sparse vectors sorted by word ID.
+ */
+TEST(AiBenchmark, DISABLED_SimilarityByWords)
+{
+    const size_t DOCUMENTS = 2000;
+    const size_t RELEVANT_WORDS = 10;
+
+    // documents w/ (roughly) Zipf distribution of words
+    unsigned seed = 42;
+    auto random = [&seed](unsigned range) {
+        seed = seed*1103515245+12345;
+        return (seed>>8)%range;
+    };
+    m8r::Lexicon lexicon{};
+    vector<m8r::WordFrequencyList*> documents{};
+    for(size_t d=0; d<DOCUMENTS; d++) {
+        m8r::WordFrequencyList* wfl = new m8r::WordFrequencyList{&lexicon};
+        for(unsigned w=0, l=20+random(100); w<l; w++) {
+            wfl->add(lexicon.add("w"+std::to_string(random(3000)*random(1000)/1000)));
+        }
+        documents.push_back(wfl);
+    }
+    lexicon.recalculateWeights();
+    vector<vector<pair<m8r::Lexicon::WordId,float>>> relevantWords(DOCUMENTS);
+    for(size_t d=0; d<DOCUMENTS; d++) {
+        documents[d]->sort();
+        documents[d]->buildRelevantWords(RELEVANT_WORDS);
+        for(auto& w:documents[d]->getRelevantWords()) {
+            relevantWords[d].push_back(std::make_pair(w.word, w.weight));
+        }
+    }
+    const size_t pairs = DOCUMENTS*(DOCUMENTS-1)/2;
+
+    // BEFORE: relevant words of both documents are looked up in the other document's map
+    auto lookup = [](
+            const vector<pair<m8r::Lexicon::WordId,float>>& r1,
+            m8r::WordFrequencyList& v1,
+            const vector<pair<m8r::Lexicon::WordId,float>>& r2,
+            m8r::WordFrequencyList& v2)
+    {
+        vector<m8r::Lexicon::WordId> intersection{};
+        float iWeight=0, uWeight=0;
+        for(auto& e:r1) {
+            uWeight += e.second;
+            if(v2.contains(e.first)) {
+                iWeight += e.second;
+                intersection.push_back(e.first);
+            }
+        }
+        for(auto& e:r2) {
+            if(std::find(intersection.begin(), intersection.end(), e.first) == intersection.end()) {
+                uWeight += e.second;
+                if(v1.contains(e.first)) {
+                    iWeight += e.second;
+                }
+            }
+        }
+        return (iWeight/(uWeight/100.))/100;
+    };
+    float checksum = 0;
+    auto begin = chrono::high_resolution_clock::now();
+    for(size_t y=0; y<DOCUMENTS; y++) {
+        for(size_t x=y+1; x<DOCUMENTS; x++) {
+            checksum += lookup(relevantWords[x], *documents[x], relevantWords[y], *documents[y]);
+        }
+    }
+    auto end = chrono::high_resolution_clock::now();
+    double lookupMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    cout << "Lookup: " << pairs << " pairs in " << lookupMs << "ms ~ "
+         << (size_t)(pairs/(lookupMs/1000.)) << " pairs/s (checksum " << checksum << ")" << endl;
+
+    // AFTER: merge of sparse vectors
+    checksum = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(size_t y=0; y<DOCUMENTS; y++) {
+        for(size_t x=y+1; x<DOCUMENTS; x++) {
+            checksum += m8r::AiAaBoW::calculateSimilarityByWords(
+                documents[x]->getRelevantWords(), documents[y]->getRelevantWords());
+        }
+    }
+    end = chrono::high_resolution_clock::now();
+    double mergeMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    cout << "Merge : " << pairs << " pairs in " << mergeMs << "ms ~ "
+         << (size_t)(pairs/(mergeMs/1000.)) << " pairs/s (checksum " << checksum << ")" << endl;
+    cout << "Speedup: " << lookupMs/mergeMs << endl;
+
+    // similarity is symmetric and identity is the best match
+    EXPECT_FLOAT_EQ(1., m8r::AiAaBoW::calculateSimilarityByWords(documents[0]->getRelevantWords(), documents[0]->getRelevantWords()));
+    EXPECT_FLOAT_EQ(
+        m8r::AiAaBoW::calculateSimilarityByWords(documents[0]->getRelevantWords(), documents[1]->getRelevantWords()),
+        m8r::AiAaBoW::calculateSimilarityByWords(documents[1]->getRelevantWords(), documents[0]->getRelevantWords()));
+
+    for(m8r::WordFrequencyList* d:documents) {
+        delete d;
+    }
+}
+
+/*
+ * Tokenization of Ns through virtual char provider (N copied to string) compared to
+ * table driven tokenization of N chunks w/ word views.
+ *
+ * 5.000 Ns w/ 250 topics (2.5MB):
+ *   w/o stemming ... chars 35MB/s, chunks 49MB/s ~ speedup 1.4 (lexicon and frequency list inserts remain)
+ *   w/  stemming ... chars 8.8MB/s, chunks 9.7MB/s ~ speedup 1.1 (stemmer dominates)
+ *   w/  stemming ... chars 29MB/s, chunks 38MB/s ~ speedup 1.3 (w/ stem cache)
+ */
+TEST(AiBenchmark, DISABLED_Tokenizer)
+{
+    const int ROUNDS = 5;
+
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-t.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    size_t bytes = 0;
+    for(m8r::Note* n:notes) {
+        bytes += n->getName().size()+1+n->getDescriptionAsString().size();
+    }
+
+    m8r::CommonWordsBlacklist blacklist{};
+    for(int stem=0; stem<2; stem++) {
+        m8r::Lexicon charsLexicon{}, chunksLexicon{};
+        m8r::MarkdownTokenizer charsTokenizer{charsLexicon, blacklist}, chunksTokenizer{chunksLexicon, blacklist};
+
+        auto begin = chrono::high_resolution_clock::now();
+        for(int r=0; r<ROUNDS; r++) {
+            for(m8r::Note* n:notes) {
+                m8r::WordFrequencyList wfl{&charsLexicon};
+                m8r::NoteCharProvider chars{n};
+                charsTokenizer.tokenize(chars, wfl, true, true, stem);
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        const double charsMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+        begin = chrono::high_resolution_clock::now();
+        for(int r=0; r<ROUNDS; r++) {
+            for(m8r::Note* n:notes) {
+                m8r::WordFrequencyList wfl{&chunksLexicon};
+                chunksTokenizer.tokenizeChunks(m8r::NoteChunkProvider{n}, wfl, true, true, stem);
+            }
+        }
+        end = chrono::high_resolution_clock::now();
+        const double chunksMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+        ASSERT_EQ(charsLexicon.size(), chunksLexicon.size());
+        for(m8r::Lexicon::WordId w=0; w<charsLexicon.size(); w++) {
+            ASSERT_EQ(charsLexicon.getWord(w), chunksLexicon.getWord(w));
+            ASSERT_EQ(charsLexicon.getFrequency(w), chunksLexicon.getFrequency(w));
+        }
+        const double mb = ROUNDS*bytes/1000000.;
+        cout << notes.size() << " Ns (" << bytes/1000 << "kB)" << (stem?" w/ stemming":" w/o stemming") << ": chars "
+             << mb/(charsMs/1000.) << "MB/s, chunks " << mb/(chunksMs/1000.) << "MB/s ~ speedup " << charsMs/chunksMs << endl;
+    }
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Stemming of word occurrences of a repository by stemmer compared to stem cache.
+ *
+ * 360.000 words (4.200 surface forms): stemmer 1.9M stems/s, cache 18.7M stems/s
+ * ~ speedup 9.9 w/ hit rate 98.8%
+ */
+TEST(AiBenchmark, DISABLED_StemCache)
+{
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-sc.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+
+    // word occurrences as tokenizer sees them before stemming
+    vector<string> words{};
+    for(m8r::Note* n:notes) {
+        istringstream description{n->getName()+" "+n->getDescriptionAsString()};
+        string w;
+        while(description >> w) {
+            words.push_back(w);
+        }
+    }
+
+    m8r::Stemmer stemmer{};
+    size_t checksum = 0;
+    auto begin = chrono::high_resolution_clock::now();
+    for(const string& w:words) {
+        checksum += stemmer.stem(w).size();
+    }
+    auto end = chrono::high_resolution_clock::now();
+    const double stemmerMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    m8r::StemCache cache{};
+    size_t cachedChecksum = 0;
+    begin = chrono::high_resolution_clock::now();
+    for(const string& w:words) {
+        string s{w};
+        cache.stem(s);
+        cachedChecksum += s.size();
+    }
+    end = chrono::high_resolution_clock::now();
+    const double cacheMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    ASSERT_EQ(checksum, cachedChecksum);
+    cout << words.size() << " words: stemmer " << words.size()/stemmerMs*1000. << " stems/s, cache "
+         << words.size()/cacheMs*1000. << " stems/s ~ speedup " << stemmerMs/cacheMs
+         << ", hit rate " << cache.getHitRate()*100. << "% of " << cache.size() << " surface forms" << endl;
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Language detection of Ns compared to their tokenization.
+ *
+ * 5.000 Ns: detection 16ms (310.000 Ns/s) ~ 22% of tokenization w/ stemming (first 200 trigrams
+ * of N are scored). Synthetic words of benchmark repository resemble Italian for some Ns.
+ */
+TEST(AiBenchmark, DISABLED_LanguageDetector)
+{
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-ld.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+
+    m8r::LanguageDetector detector{};
+    map<string,int> languages{};
+    auto begin = chrono::high_resolution_clock::now();
+    for(m8r::Note* n:notes) {
+        languages[m8r::Stemmer::getLanguageName(detector.detect(m8r::NoteChunkProvider{n}))]++;
+    }
+    auto end = chrono::high_resolution_clock::now();
+    const double detectMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    m8r::CommonWordsBlacklist blacklist{};
+    m8r::Lexicon lexicon{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+    begin = chrono::high_resolution_clock::now();
+    for(m8r::Note* n:notes) {
+        m8r::WordFrequencyList wfl{&lexicon};
+        tokenizer.tokenizeChunks(m8r::NoteChunkProvider{n}, wfl);
+    }
+    end = chrono::high_resolution_clock::now();
+    const double tokenizeMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    // words of benchmark repository are made of syllables i.e. they are not English
+    for(auto& l:languages) {
+        cout << "  " << l.first << ": " << l.second << " Ns" << endl;
+    }
+    cout << notes.size() << " Ns: detection " << detectMs << "ms (" << notes.size()/detectMs*1000. << " Ns/s), tokenization w/ stemming "
+         << tokenizeMs << "ms ~ detection costs " << detectMs/tokenizeMs*100. << "% of tokenization" << endl;
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * AA row (leaderboard) calculation from candidates found in postings compared to comparison
+ * of N w/ all other Ns - for repositories of growing size.
+ */
+TEST(AiBenchmark, DISABLED_AaCandidates)
+{
+    const size_t ROWS = 100;
+
+    for(int outlines:{20, 100, 200}) {
+        string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+        createAiBenchmarkRepository(repositoryDir, outlines, 50);
+
+        m8r::Configuration& config = m8r::Configuration::getInstance();
+        config.clear();
+        config.setConfigFilePath("/tmp/cfg-aib-ac.md");
+        config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+        m8r::Mind mind(config);
+        mind.remind().setSnapshot(false);
+        mind.learn();
+
+        m8r::AiAaBoW exhaustive{mind.remind(), mind};
+        exhaustive.setExhaustiveAa(true);
+        ASSERT_TRUE(exhaustive.dream().get());
+        m8r::AiAaBoW candidates{mind.remind(), mind};
+        ASSERT_TRUE(candidates.dream().get());
+        const size_t notes = candidates.getAaNeighbors().size();
+
+        double exhaustiveMs = 0, candidatesMs = 0;
+        for(size_t r=0; r<ROWS; r++) {
+            size_t y = r*notes/ROWS;
+
+            auto begin = chrono::high_resolution_clock::now();
+            exhaustive.calculateAaRow(y);
+            auto end = chrono::high_resolution_clock::now();
+            exhaustiveMs += chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+            begin = chrono::high_resolution_clock::now();
+            candidates.calculateAaRow(y);
+            end = chrono::high_resolution_clock::now();
+            candidatesMs += chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+            // candidates give the same leaderboard
+            EXPECT_EQ(exhaustive.getAaNeighbors()[y], candidates.getAaNeighbors()[y]);
+        }
+        cout << notes << " Ns: AA row exhaustive " << exhaustiveMs/ROWS << "ms, candidates "
+             << candidatesMs/ROWS << "ms ~ speedup " << exhaustiveMs/candidatesMs << endl;
+
+        m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    }
+}
+
+/*
+ * Incremental learning of modified N compared to learning of the whole repository - AA rows
+ * of Ns which were already calculated are re-assessed w/ the modified N.
+ *
+ * 5.000 Ns w/ 250 topics, 100 AA rows calculated: dream 338ms, remember 0.11ms
+ */
+TEST(AiBenchmark, DISABLED_AaIncremental)
+{
+    const size_t ROWS = 100;
+    const size_t CHANGES = 50;
+
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-ai.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    auto begin = chrono::high_resolution_clock::now();
+    ASSERT_TRUE(aa.dream().get());
+    auto end = chrono::high_resolution_clock::now();
+    const double dreamMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    const size_t notes = aa.getAaNeighbors().size();
+    for(size_t r=0; r<ROWS; r++) {
+        aa.calculateAaRow(r*notes/ROWS);
+    }
+
+    vector<m8r::Note*> allNotes{};
+    mind.remind().getAllNotes(allNotes);
+    double rememberMs = 0;
+    for(size_t c=0; c<CHANGES; c++) {
+        // N gets description of another N
+        m8r::Note* n = allNotes[(c*7919)%allNotes.size()];
+        m8r::Note* source = allNotes[(c*104729+1)%allNotes.size()];
+        vector<string*> description{};
+        for(string* line:source->getDescription()) {
+            description.push_back(new string{*line});
+        }
+        n->setDescription(description);
+
+        begin = chrono::high_resolution_clock::now();
+        aa.remember(n);
+        end = chrono::high_resolution_clock::now();
+        rememberMs += chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    }
+    cout << notes << " Ns (" << ROWS << " AA rows calculated): dream " << dreamMs << "ms, remember "
+         << rememberMs/CHANGES << "ms ~ speedup " << dreamMs/(rememberMs/CHANGES) << endl;
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Restore of saved AI model (lexicon, word vectors, AA rows) compared to learning
+ * of the whole repository - Ns whose stamp changed are learned incrementally.
+ *
+ * 5.000 Ns w/ 250 topics, all AA rows calculated: dream 393ms, restore 25ms, restore w/ 50 changed Ns 73ms
+ */
+TEST(AiBenchmark, DISABLED_AaModel)
+{
+    const size_t CHANGES = 50;
+
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-am.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    remove(config.getAiModelPath().c_str());
+    m8r::Mind mind(config);
+    mind.learn();
+
+    m8r::AiAaBoW dreamed{mind.remind(), mind};
+    auto begin = chrono::high_resolution_clock::now();
+    ASSERT_TRUE(dreamed.dream().get());
+    auto end = chrono::high_resolution_clock::now();
+    const double dreamMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    dreamed.precalculateAa();
+    ASSERT_TRUE(dreamed.saveModel());
+
+    m8r::AiAaBoW restored{mind.remind(), mind};
+    begin = chrono::high_resolution_clock::now();
+    ASSERT_TRUE(restored.dream().get());
+    end = chrono::high_resolution_clock::now();
+    const double restoreMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    EXPECT_EQ(dreamed.getAaNeighbors(), restored.getAaNeighbors());
+
+    // Ns get description of another N
+    vector<m8r::Note*> allNotes{};
+    mind.remind().getAllNotes(allNotes);
+    for(size_t c=0; c<CHANGES; c++) {
+        m8r::Note* n = allNotes[(c*7919)%allNotes.size()];
+        m8r::Note* source = allNotes[(c*104729+1)%allNotes.size()];
+        vector<string*> description{};
+        for(string* line:source->getDescription()) {
+            description.push_back(new string{*line});
+        }
+        n->setDescription(description);
+    }
+    m8r::AiAaBoW changed{mind.remind(), mind};
+    begin = chrono::high_resolution_clock::now();
+    ASSERT_TRUE(changed.dream().get());
+    end = chrono::high_resolution_clock::now();
+    const double changedMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    cout << dreamed.getAaNeighbors().size() << " Ns (all AA rows calculated): dream " << dreamMs << "ms, restore "
+         << restoreMs << "ms, restore w/ " << CHANGES << " changed Ns " << changedMs << "ms" << endl;
+
+    remove(config.getAiModelPath().c_str());
+    remove(config.getMemorySnapshotPath().c_str());
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * MinHash/LSH associations compared to the exact Jaccard index of N word sets - recall
+ * is the fraction of the exact top-k Ns (w/ ties) found in the approximate leaderboard.
+ *
+ * 5.000 Ns w/ 250 topics (the best Ns have Jaccard index ~0.15), exact row 2.6ms:
+ *    8 bands x 1 row  ... row 0.40ms, recall 75%
+ *   16 bands x 1 row  ... row 0.73ms, recall 92%
+ *   32 bands x 1 row  ... row 1.44ms, recall 98%
+ *   64 bands x 2 rows ... row 0.15ms, recall 75%
+ */
+TEST(AiBenchmark, DISABLED_AaMinHash)
+{
+    const size_t ROWS = 100;
+    const size_t K = 10;
+
+    string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+    createAiBenchmarkRepository(repositoryDir, 100, 50, 250);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-mh.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    vector<vector<uint32_t>> words(notes.size());
+    {
+        m8r::AiAaMinHash aa{mind.remind(), mind};
+        for(size_t i=0; i<notes.size(); i++) {
+            aa.collectWords(notes[i], words[i]);
+        }
+    }
+    auto jaccard = [](const vector<uint32_t>& v1, const vector<uint32_t>& v2) {
+        size_t i=0, j=0, intersection=0;
+        while(i<v1.size() && j<v2.size()) {
+            if(v1[i] == v2[j]) {
+                intersection++; i++; j++;
+            } else if(v1[i] < v2[j]) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return static_cast<float>(intersection)/(v1.size()+v2.size()-intersection);
+    };
+
+    // exact similarity of the k-th best N for every sampled N
+    vector<float> kth(ROWS);
+    auto begin = chrono::high_resolution_clock::now();
+    for(size_t r=0; r<ROWS; r++) {
+        size_t y = r*notes.size()/ROWS;
+        vector<float> similarities{};
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x != y) similarities.push_back(jaccard(words[y], words[x]));
+        }
+        std::nth_element(similarities.begin(), similarities.begin()+K-1, similarities.end(), std::greater<float>());
+        kth[r] = similarities[K-1];
+    }
+    auto end = chrono::high_resolution_clock::now();
+    cout << notes.size() << " Ns: exact row " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0/ROWS << "ms" << endl;
+
+    for(auto knobs:vector<pair<unsigned,unsigned>>{{8,1},{16,1},{32,1},{16,2},{32,2},{64,2},{64,3}}) {
+        m8r::AiAaMinHash aa{mind.remind(), mind, knobs.first, knobs.second};
+        begin = chrono::high_resolution_clock::now();
+        ASSERT_TRUE(aa.dream().get());
+        end = chrono::high_resolution_clock::now();
+        double learnMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+        size_t found = 0;
+        double rowsMs = 0;
+        vector<pair<m8r::Note*,float>> leaderboard{};
+        for(size_t r=0; r<ROWS; r++) {
+            size_t y = r*notes.size()/ROWS;
+            begin = chrono::high_resolution_clock::now();
+            aa.getAssociatedNotes(notes[y], leaderboard).get();
+            end = chrono::high_resolution_clock::now();
+            rowsMs += chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+            for(auto& association:leaderboard) {
+                if(jaccard(words[y], words[association.first->getAiAaMatrixIndex()]) >= kth[r]) {
+                    found++;
+                }
+            }
+        }
+        cout << "  " << knobs.first << " bands x " << knobs.second << " rows: learned in " << learnMs
+             << "ms, row " << rowsMs/ROWS << "ms, recall " << 100.*found/(ROWS*K) << "%" << endl;
+    }
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * MinHash/LSH learning time for repositories of growing size.
+ *
+ *  5.000 Ns ... learned in  85ms, row 0.8ms
+ * 20.000 Ns ... learned in 344ms, row 3.2ms
+ * 50.000 Ns ... learned in 868ms, row 7.7ms
+ */
+TEST(AiBenchmark, DISABLED_AaMinHashScale)
+{
+    for(int outlines:{100, 400, 1000}) {
+        string repositoryDir{"/tmp/mf-ai-benchmark-repository"};
+        createAiBenchmarkRepository(repositoryDir, outlines, 50, outlines*5/2);
+
+        m8r::Configuration& config = m8r::Configuration::getInstance();
+        config.clear();
+        config.setConfigFilePath("/tmp/cfg-aib-mhs.md");
+        config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+        m8r::Mind mind(config);
+        mind.remind().setSnapshot(false);
+        mind.learn();
+
+        m8r::AiAaMinHash aa{mind.remind(), mind};
+        auto begin = chrono::high_resolution_clock::now();
+        ASSERT_TRUE(aa.dream().get());
+        auto end = chrono::high_resolution_clock::now();
+        double learnMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+        vector<m8r::Note*> notes{};
+        mind.remind().getAllNotes(notes);
+        vector<pair<m8r::Note*,float>> leaderboard{};
+        begin = chrono::high_resolution_clock::now();
+        for(size_t r=0; r<100; r++) {
+            aa.getAssociatedNotes(notes[r*notes.size()/100], leaderboard).get();
+        }
+        end = chrono::high_resolution_clock::now();
+        cout << aa.getNotesCount() << " Ns: learned in " << learnMs << "ms, row "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0/100 << "ms" << endl;
+
+        m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    }
 }
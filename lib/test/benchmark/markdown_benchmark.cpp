@@ -17,6 +17,7 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -40,50 +41,50 @@ using namespace m8r;
 
 extern char* getMindforgerGitHomePath();
 
-// 2018/03/02 100x = 2.460ms (120MiB)
-TEST(MarkdownParserBenchmark, DISABLED_ParserMeta)
-{    
-    unique_ptr<string> fileName
-            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
-    fileName.get()->insert(0, getMindforgerGitHomePath());
-
+void benchmarkParser(const string& fileName, MarkdownLexerSections::Mode mode, bool hasMetadata)
+{
     // do >1 iterations
     const int ITERATIONS = 100;
+    unsigned long fileSize = 0;
+    // heap allocations of lexer/parser: line strings (LINES mode only) and arena chunks
+    unsigned long allocations = 0;
     auto begin = chrono::high_resolution_clock::now();
     for(int i=0; i<ITERATIONS; i++) {
-        cout << "." << flush;
-        MarkdownLexerSections lexer(fileName.get());
+        MarkdownLexerSections lexer(&fileName, mode);
         lexer.tokenize();
         MarkdownParserSections parser(lexer);
         parser.parse();
 
-        EXPECT_TRUE(parser.hasMetadata());
+        fileSize = lexer.getFileSize();
+        allocations += lexer.getLines().size() + lexer.getArena().getChunkCount();
+        EXPECT_EQ(hasMetadata, parser.hasMetadata());
     }
     auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << (ITERATIONS*1.2) << "MiB (" << ITERATIONS << "x1.1MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
-    MF_DEBUG(" ~ AVG: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+
+    double ms = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+    double mib = ITERATIONS*fileSize/(1024.0*1024.0);
+    cout << endl << (mode==MarkdownLexerSections::Mode::MMAP?"MMAP ":"LINES")
+         << ": " << mib << "MiB (" << ITERATIONS << "x" << fileName << ") parsed in " << ms << "ms"
+         << " ~ " << (mib/(ms/1000.0)) << "MiB/s"
+         << " ~ " << allocations/ITERATIONS << " allocations/parse" << endl;
+}
+
+// 2018/03/02 100x = 2.460ms (120MiB)
+TEST(MarkdownParserBenchmark, DISABLED_ParserMeta)
+{    
+    string fileName{"/lib/test/resources/benchmark-repository/memory/meta.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+
+    benchmarkParser(fileName, MarkdownLexerSections::Mode::LINES, true);
+    benchmarkParser(fileName, MarkdownLexerSections::Mode::MMAP, true);
 }
 
 // 2018/03/02 100x = 1.000ms (770MiB)
 TEST(MarkdownParserBenchmark, DISABLED_ParserNoMeta)
 {
-    unique_ptr<string> fileName
-            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/nometa.md"});
-    fileName.get()->insert(0, getMindforgerGitHomePath());
+    string fileName{"/lib/test/resources/benchmark-repository/memory/nometa.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
 
-    // do >1 iterations
-    const int ITERATIONS = 100;
-    auto begin = chrono::high_resolution_clock::now();
-    for(int i=0; i<ITERATIONS; i++) {
-        cout << "." << flush;
-        MarkdownLexerSections lexer(fileName.get());
-        lexer.tokenize();
-        MarkdownParserSections parser(lexer);
-        parser.parse();
-
-        EXPECT_FALSE(parser.hasMetadata());
-    }
-    auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << (ITERATIONS*0.77) << "MiB (" << ITERATIONS << "x0.77MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
-    MF_DEBUG(" ~ AVG: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+    benchmarkParser(fileName, MarkdownLexerSections::Mode::LINES, false);
+    benchmarkParser(fileName, MarkdownLexerSections::Mode::MMAP, false);
 }
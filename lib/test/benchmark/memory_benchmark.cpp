@@ -0,0 +1,234 @@
+/*
+ memory_benchmark.cpp     MindForger memory benchmark
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <map>
+
+#include <gtest/gtest.h>
+
+#include "../../src/mind/memory.h"
+#include "../../src/mind/mind.h"
+#include "../../src/gear/file_utils.h"
+#include "../src/test_gear.h"
+
+using namespace std;
+using namespace m8r;
+
+extern char* getMindforgerGitHomePath();
+
+/*
+ * Generate repository w/ given number of outlines having given number of notes.
+ */
+void createMemoryBenchmarkRepository(const string& repositoryDir, const int outlines, const int notes)
+{
+    map<string,string> pathToContent{};
+    for(int o=0; o<outlines; o++) {
+        string content{"# Outline "};
+        content += std::to_string(o);
+        content += " <!-- Metadata: type: Outline; tags: benchmark,o";
+        content += std::to_string(o%100);
+        content += "; created: 2018-01-01 10:00:00; reads: 1; read: 2018-01-01 10:00:00; revision: 1; modified: 2018-01-01 10:00:00; -->\n";
+        content += "Outline description.\n\n";
+        for(int n=0; n<notes; n++) {
+            content += "## Note ";
+            content += std::to_string(n);
+            content += " <!-- Metadata: type: Idea; tags: n";
+            content += std::to_string(n);
+            content += "; created: 2018-01-01 10:00:00; reads: 1; read: 2018-01-01 10:00:00; revision: 1; modified: 2018-01-01 10:00:00; -->\n";
+            content += "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.\n";
+            content += "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip.\n\n";
+        }
+        pathToContent[repositoryDir+"/memory/o"+std::to_string(o)+".md"] = content;
+    }
+    string dir{repositoryDir};
+    createEmptyRepository(dir, pathToContent);
+}
+
+/*
+ * Repository load time vs. number of threads used to parse outlines.
+ */
+TEST(MemoryBenchmark, DISABLED_LearnThreads)
+{
+    // generate repository: 2.000 Os w/ 50 Ns
+    const int OUTLINES = 2000;
+    string repositoryDir{"/tmp/mf-memory-benchmark-repository"};
+    createMemoryBenchmarkRepository(repositoryDir, OUTLINES, 50);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mb-lt.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+
+    vector<string> referenceKeys{};
+    unsigned maxThreads = thread::hardware_concurrency()?thread::hardware_concurrency():1;
+    for(unsigned threads=1; threads<=maxThreads; threads*=2) {
+        Memory memory{config};
+        memory.setLearnThreads(threads);
+        memory.setSnapshot(false);
+
+        auto begin = chrono::high_resolution_clock::now();
+        memory.learn();
+        auto end = chrono::high_resolution_clock::now();
+        cout << endl << threads << " thread(s): " << memory.getOutlinesCount() << " Os / " << memory.getNotesCount() << " Ns learned in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+        // asserts - outlines order MUST NOT depend on the number of threads
+        ASSERT_EQ(OUTLINES, memory.getOutlinesCount());
+        if(referenceKeys.empty()) {
+            for(Outline* o:memory.getOutlines()) {
+                referenceKeys.push_back(o->getKey());
+            }
+        } else {
+            for(size_t i=0; i<referenceKeys.size(); i++) {
+                ASSERT_EQ(referenceKeys[i], memory.getOutlines()[i]->getKey());
+            }
+        }
+
+        memory.amnesia();
+    }
+}
+
+/*
+ * Repository load time w/o and w/ memory snapshot.
+ */
+TEST(MemoryBenchmark, DISABLED_LearnSnapshot)
+{
+    const int OUTLINES = 2000;
+    string repositoryDir{"/tmp/mf-memory-benchmark-repository"};
+    createMemoryBenchmarkRepository(repositoryDir, OUTLINES, 50);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mb-ls.md");
+    remove(config.getMemorySnapshotPath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+
+    const char* runs[] = {"parse + save snapshot", "load snapshot"};
+    for(const char* run:runs) {
+        Memory memory{config};
+
+        auto begin = chrono::high_resolution_clock::now();
+        memory.learn();
+        auto end = chrono::high_resolution_clock::now();
+        cout << endl << run << ": " << memory.getOutlinesCount() << " Os / " << memory.getNotesCount() << " Ns learned in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl;
+
+        ASSERT_EQ(OUTLINES, memory.getOutlinesCount());
+    }
+}
+
+/*
+ * Full-text search w/ FTS index vs. linear scan of all notes.
+ */
+TEST(MemoryBenchmark, DISABLED_FtsIndex)
+{
+    // generate repository: 2.000 Os w/ 50 Ns ~ 100.000 Ns
+    const int OUTLINES = 2000;
+    string repositoryDir{"/tmp/mf-memory-benchmark-repository"};
+    createMemoryBenchmarkRepository(repositoryDir, OUTLINES, 50);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mb-fi.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.learn();
+    cout << endl << "FTS index: " << mind.remind().getNotesCount() << " Ns / "
+         << mind.remind().getFtsIndex().getTrigramsCount() << " trigrams" << endl;
+
+    const char* queries[] = {"Outline 1234", "1999", "utline 77", "tempor"};
+    for(const char* query:queries) {
+        auto begin = chrono::high_resolution_clock::now();
+        unique_ptr<vector<Note*>> result{mind.findNoteFts(query, true)};
+        auto end = chrono::high_resolution_clock::now();
+
+        // linear scan of lower case names/descriptions as it was done w/o index
+        string q{};
+        stringToLower(query, q);
+        size_t scanned = 0;
+        auto scanBegin = chrono::high_resolution_clock::now();
+        for(Outline* o:mind.remind().getOutlines()) {
+            vector<Note*> notes{o->getOutlineDescriptorAsNote()};
+            notes.insert(notes.end(), o->getNotes().begin(), o->getNotes().end());
+            for(Note* n:notes) {
+                string t{};
+                stringToLower(n->getName(), t);
+                for(string* d:n->getDescription()) {
+                    stringToLower(*d, t);
+                }
+                if(t.find(q)!=string::npos) {
+                    scanned++;
+                }
+            }
+        }
+        auto scanEnd = chrono::high_resolution_clock::now();
+
+        cout << "'" << query << "': " << result->size() << " N(s) found in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms w/ index vs. "
+             << chrono::duration_cast<chrono::microseconds>(scanEnd-scanBegin).count()/1000.0 << "ms scan ("
+             << scanned << " N(s))" << endl;
+    }
+}
+
+class FtsBenchmarkPage : public SearchListener
+{
+public:
+    size_t size;
+
+    FtsBenchmarkPage() : size(0) {}
+    virtual void found(Note*) override { size++; }
+};
+
+TEST(MemoryBenchmark, DISABLED_FtsTopK)
+{
+    // generate repository: 2.000 Os w/ 50 Ns ~ 100.000 Ns
+    const int OUTLINES = 2000;
+    const size_t PAGE = 50;
+    string repositoryDir{"/tmp/mf-memory-benchmark-repository"};
+    createMemoryBenchmarkRepository(repositoryDir, OUTLINES, 50);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mb-ftk.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.learn();
+
+    // broad queries are not narrowed by index
+    const char* queries[] = {"Outline 1234", "tempor", "ut", "e"};
+    for(const char* query:queries) {
+        auto begin = chrono::high_resolution_clock::now();
+        unique_ptr<vector<Note*>> result{mind.findNoteFts(query, true)};
+        auto end = chrono::high_resolution_clock::now();
+
+        FtsCursor cursor{};
+        FtsBenchmarkPage page{};
+        auto pageBegin = chrono::high_resolution_clock::now();
+        size_t hits = mind.findNoteFts(query, true, nullptr, PAGE, cursor, &page);
+        auto pageEnd = chrono::high_resolution_clock::now();
+        EXPECT_EQ(result->size(), hits);
+        EXPECT_EQ(std::min(PAGE, hits), page.size);
+
+        cout << "'" << query << "': " << result->size() << " N(s) found in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms vs. top-" << PAGE << " page in "
+             << chrono::duration_cast<chrono::microseconds>(pageEnd-pageBegin).count()/1000.0 << "ms" << endl;
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ string_benchmark.cpp     MindForger string gear benchmark
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "../../src/gear/string_utils.h"
+#include "../../src/gear/file_utils.h"
+
+using namespace std;
+using namespace m8r;
+
+extern char* getMindforgerGitHomePath();
+
+/*
+ * Case insensitive match counting: lower case copy + std::string::find() vs. search kernels.
+ */
+TEST(StringGearBenchmark, DISABLED_CountIgnoreCase)
+{
+    // 1.1M file split to lines as FTS searches description lines
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> s{m8r::fileToString(*fileName.get())};
+    vector<string> lines{};
+    size_t begin = 0, end;
+    while((end = s->find('\n', begin)) != string::npos) {
+        lines.push_back(s->substr(begin, end-begin));
+        begin = end+1;
+    }
+    cout << endl << "Searching " << lines.size() << " lines / " << s->size() << " bytes" << endl;
+
+    const int RUNS = 10;
+    const char* needles[] = {"e", "the", "mindforger", "nonexistentneedle"};
+    for(const char* n:needles) {
+        string needle{n};
+
+        size_t referenceCount = 0;
+        auto start = chrono::high_resolution_clock::now();
+        for(int r=0; r<RUNS; r++) {
+            string l{};
+            for(const string& line:lines) {
+                l.clear();
+                stringToLower(line, l);
+                size_t m = l.find(needle, 0);
+                while(m != string::npos) {
+                    referenceCount++;
+                    m = l.find(needle, m+1);
+                }
+            }
+        }
+        auto stop = chrono::high_resolution_clock::now();
+        cout << "'" << needle << "' lower+find: " << referenceCount/RUNS << " matches in "
+             << chrono::duration_cast<chrono::microseconds>(stop-start).count()/1000.0/RUNS << "ms" << endl;
+
+        for(StringSearchKernel kernel:{StringSearchKernel::SCALAR, StringSearchKernel::SSE2, StringSearchKernel::AVX2}) {
+            if(kernel > stringSearchKernel()) {
+                continue;
+            }
+            size_t count = 0;
+            start = chrono::high_resolution_clock::now();
+            for(int r=0; r<RUNS; r++) {
+                for(const string& line:lines) {
+                    count += stringCountIgnoreCase(line, needle, kernel);
+                }
+            }
+            stop = chrono::high_resolution_clock::now();
+            cout << "'" << needle << "' kernel " << static_cast<int>(kernel) << ": " << count/RUNS << " matches in "
+                 << chrono::duration_cast<chrono::microseconds>(stop-start).count()/1000.0/RUNS << "ms" << endl;
+            ASSERT_EQ(referenceCount, count);
+        }
+    }
+}
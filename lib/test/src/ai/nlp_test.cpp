@@ -22,14 +22,21 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <atomic>
+#include <thread>
+#include <memory>
 
 #include "../../../src/config/configuration.h"
 #include "../../../src/mind/mind.h"
 #include "../../../src/mind/ai/ai.h"
 #include "../../../src/mind/ai/nlp/stemmer/stemmer.h"
+#include "../../../src/mind/ai/nlp/stemmer/stem_cache.h"
 #include "../../../src/mind/ai/nlp/string_char_provider.h"
 #include "../../../src/mind/ai/nlp/note_char_provider.h"
+#include "../../../src/mind/ai/nlp/chunk_provider.h"
 #include "../../../src/mind/ai/nlp/markdown_tokenizer.h"
+#include "../../../src/mind/ai/nlp/language_detector.h"
 #include "../../../src/mind/ai/nlp/lexicon.h"
 #include "../../../src/mind/ai/nlp/word_frequency_list.h"
 #include "../../../src/mind/ai/nlp/bag_of_words.h"
@@ -63,41 +70,116 @@ TEST(AiNlpTestCase, Stemmer)
     }
 }
 
+TEST(AiNlpTestCase, StemCache)
+{
+    m8r::Stemmer stemmer{};
+    m8r::StemCache cache{5};
+    vector<string> words{"learning", "learned", "learns", "learning", "machines", "learned", "machine", "learning"};
+
+    for(const string& w:words) {
+        string cached{w};
+        cache.stem(cached);
+        EXPECT_EQ(stemmer.stem(w), cached);
+    }
+    EXPECT_EQ(8, cache.getLookups());
+    EXPECT_EQ(3, cache.getHits());
+    EXPECT_LE(cache.size(), cache.getCapacity());
+
+    // capacity is exceeded - cache is cleared
+    for(const string& w:vector<string>{"information", "informational", "Einstein"}) {
+        string cached{w};
+        cache.stem(cached);
+        EXPECT_EQ(stemmer.stem(w), cached);
+    }
+    EXPECT_EQ(1, cache.getEvictions());
+    EXPECT_LE(cache.size(), cache.getCapacity());
+
+    // cache is shared by threads
+    m8r::StemCache shared{};
+    vector<thread> threads{};
+    atomic<int> mismatches{0};
+    vector<string> expected{};
+    for(const string& w:words) {
+        expected.push_back(stemmer.stem(w));
+    }
+    for(int t=0; t<4; t++) {
+        threads.push_back(thread{[&]() {
+            for(int r=0; r<100; r++) {
+                for(size_t i=0; i<words.size(); i++) {
+                    string cached{words[i]};
+                    shared.stem(cached);
+                    if(cached != expected[i]) mismatches++;
+                }
+            }
+        }});
+    }
+    for(thread& t:threads) {
+        t.join();
+    }
+    EXPECT_EQ(0, mismatches);
+    EXPECT_EQ(4*100*words.size(), shared.getLookups());
+    EXPECT_LT(0.99, shared.getHitRate());
+}
+
 TEST(AiNlpTestCase, Lexicon)
 {
     m8r::Lexicon lexicon{};
 
-    lexicon.add("a5");
+    m8r::Lexicon::WordId a5 = lexicon.add("a5");
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(1, lexicon.get("a5")->frequency);
+    ASSERT_EQ(0, a5);
+    ASSERT_EQ(1, lexicon.getFrequency(a5));
 
-    lexicon.add("a5");
+    ASSERT_EQ(a5, lexicon.add("a5"));
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(2, lexicon.get("a5")->frequency);
+    ASSERT_EQ(2, lexicon.getFrequency(a5));
 
     string s{"a5"};
     lexicon.add(s);
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(3, lexicon.get(s)->frequency);
-    lexicon.add(&s);
-    ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(4, lexicon.get(&s)->frequency);
+    ASSERT_EQ(a5, lexicon.find(s));
+    ASSERT_EQ(3, lexicon.getFrequency(lexicon.find(s)));
+    ASSERT_EQ("a5", lexicon.getWord(a5));
+    ASSERT_EQ(m8r::Lexicon::NO_WORD, lexicon.find("a4"));
 
     // adding more words for better weight calculation 5/3/2
     lexicon.add("a5");
+    lexicon.add("a5");
+    m8r::Lexicon::WordId a3 = lexicon.add("a3");
     lexicon.add("a3");
     lexicon.add("a3");
-    lexicon.add("a3");
-    lexicon.add("a2");
+    m8r::Lexicon::WordId a2 = lexicon.add("a2");
     lexicon.add("a2");
+    // dense IDs
+    ASSERT_EQ(1, a3);
+    ASSERT_EQ(2, a2);
 
     // weights
     lexicon.recalculateWeights();
     lexicon.print();
 
-    ASSERT_FLOAT_EQ(0.01, lexicon.get("a5")->weight);
-    ASSERT_FLOAT_EQ(0.4, lexicon.get("a3")->weight);
-    ASSERT_FLOAT_EQ(0.6, lexicon.get("a2")->weight);
+    ASSERT_FLOAT_EQ(0.01, lexicon.getWeight(a5));
+    ASSERT_FLOAT_EQ(0.4, lexicon.getWeight(a3));
+    ASSERT_FLOAT_EQ(0.6, lexicon.getWeight(a2));
+    ASSERT_EQ(3, lexicon.getWeights().size());
+
+    // prefix queries - the most frequent words first
+    lexicon.add("b1");
+    vector<m8r::Lexicon::WordId> found{};
+    lexicon.findByPrefix("a", 2, found);
+    ASSERT_EQ(2, found.size());
+    ASSERT_EQ(a5, found[0]);
+    ASSERT_EQ(a3, found[1]);
+    found.clear();
+    lexicon.remove(a5, 5);
+    lexicon.findByPrefix("a", 5, found);
+    ASSERT_EQ(2, found.size());
+    ASSERT_EQ(a3, found[0]);
+    ASSERT_EQ(a2, found[1]);
+
+    lexicon.clear();
+    ASSERT_EQ(0, lexicon.size());
+    ASSERT_EQ(m8r::Lexicon::NO_WORD, lexicon.find("a5"));
 
     // TODO weights: increase scale
 
@@ -148,6 +230,10 @@ TEST(AiNlpTestCase, BowOutline)
     // assert wfl
     wfl->print();
     ASSERT_EQ(19, wfl->size());
+    ASSERT_EQ(19, wfl->byWeight().size());
+    for(size_t i=1; i<wfl->byWeight().size(); i++) {
+        ASSERT_GE(lexicon.getWeight(wfl->byWeight()[i-1].first), lexicon.getWeight(wfl->byWeight()[i].first));
+    }
     // assert lexicon
     lexicon.print();
     ASSERT_EQ(19, lexicon.size());
@@ -163,6 +249,211 @@ TEST(AiNlpTestCase, BowOutline)
     ASSERT_EQ(1, bow.size());
 }
 
+TEST(AiNlpTestCase, RelevantWords)
+{
+    m8r::Lexicon lexicon{};
+    // frequent words have low weight
+    for(int i=0; i<4; i++) lexicon.add("common");
+    for(int i=0; i<2; i++) lexicon.add("usual");
+    m8r::Lexicon::WordId common = lexicon.find("common");
+    m8r::Lexicon::WordId usual = lexicon.find("usual");
+    m8r::Lexicon::WordId rare = lexicon.add("rare");
+    m8r::Lexicon::WordId unique = lexicon.add("unique");
+    lexicon.recalculateWeights();
+
+    m8r::WordFrequencyList v1{&lexicon};
+    v1.add(common);
+    v1.add(unique);
+    v1.add(usual);
+    v1.add(rare);
+    v1.add(rare);
+    v1.sort();
+    v1.buildRelevantWords(3);
+    // 3 words w/ the highest weight ordered by ID
+    ASSERT_EQ(3, v1.getRelevantWords().size());
+    EXPECT_EQ(usual, v1.getRelevantWords()[0].word);
+    EXPECT_EQ(rare, v1.getRelevantWords()[1].word);
+    EXPECT_EQ(2, v1.getRelevantWords()[1].frequency);
+    EXPECT_EQ(unique, v1.getRelevantWords()[2].word);
+    EXPECT_FLOAT_EQ(lexicon.getWeight(unique), v1.getRelevantWords()[2].weight);
+
+    m8r::WordFrequencyList v2{&lexicon};
+    v2.add(rare);
+    v2.add(common);
+    v2.sort();
+    v2.buildRelevantWords(3);
+    ASSERT_EQ(2, v2.getRelevantWords().size());
+
+    // weighted Jaccard: rare / (common + usual + rare + unique)
+    float expected = lexicon.getWeight(rare)
+        / (lexicon.getWeight(common)+lexicon.getWeight(usual)+lexicon.getWeight(rare)+lexicon.getWeight(unique));
+    EXPECT_FLOAT_EQ(expected, m8r::AiAaBoW::calculateSimilarityByWords(v1.getRelevantWords(), v2.getRelevantWords()));
+    EXPECT_FLOAT_EQ(expected, m8r::AiAaBoW::calculateSimilarityByWords(v2.getRelevantWords(), v1.getRelevantWords()));
+    EXPECT_FLOAT_EQ(1., m8r::AiAaBoW::calculateSimilarityByWords(v1.getRelevantWords(), v1.getRelevantWords()));
+
+    m8r::WordFrequencyList empty{&lexicon};
+    EXPECT_FLOAT_EQ(0., m8r::AiAaBoW::calculateSimilarityByWords(v1.getRelevantWords(), empty.getRelevantWords()));
+}
+
+TEST(AiNlpTestCase, TokenizerChunks)
+{
+    // words of chunks are the same as words of char stream
+    auto words = [](m8r::Lexicon& lexicon, m8r::WordFrequencyList& wfl) {
+        map<string,int> result{};
+        for(auto& w:wfl.iterable()) {
+            result[lexicon.getWord(w.first)] = w.second;
+        }
+        return result;
+    };
+    m8r::CommonWordsBlacklist blacklist{};
+    blacklist.addWord("the");
+
+    vector<string> texts{
+        "Self-awareness of -- the Universe --dash- and trailing-",
+        "UPPER lower MiXeD 'quoted' [link](http://x.org) a b cc ",
+        "High \xC3\xA9 unicode\tand\rlast",
+        "-",
+        ""};
+    for(const string& text:texts) {
+        for(int variant=0; variant<4; variant++) {
+            const bool lowercase = variant&1;
+            const bool stem = variant&2;
+            m8r::Lexicon charsLexicon{}, chunksLexicon{};
+            m8r::MarkdownTokenizer charsTokenizer{charsLexicon, blacklist}, chunksTokenizer{chunksLexicon, blacklist};
+            m8r::WordFrequencyList charsWfl{&charsLexicon}, chunksWfl{&chunksLexicon};
+            m8r::StringCharProvider chars{text};
+            charsTokenizer.tokenize(chars, charsWfl, true, lowercase, stem);
+            chunksTokenizer.tokenizeChunks(m8r::StringChunkProvider{text}, chunksWfl, true, lowercase, stem);
+            EXPECT_EQ(words(charsLexicon, charsWfl), words(chunksLexicon, chunksWfl)) << text;
+        }
+    }
+    // word at the end of text is not dropped
+    vector<pair<string,string>> lastWords{{"trailing", "trailing"}, {"last word", "word"}, {"hyphen-", "hyphen"}};
+    for(auto& lastWord:lastWords) {
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        m8r::WordFrequencyList charsWfl{&lexicon}, chunksWfl{&lexicon};
+        m8r::StringCharProvider chars{lastWord.first};
+        tokenizer.tokenize(chars, charsWfl, true, true, false);
+        tokenizer.tokenizeChunks(m8r::StringChunkProvider{lastWord.first}, chunksWfl, true, true, false);
+        EXPECT_EQ(1, words(lexicon, charsWfl)[lastWord.second]) << lastWord.first;
+        EXPECT_EQ(1, words(lexicon, chunksWfl)[lastWord.second]) << lastWord.first;
+    }
+
+    // Ns of repository
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-tc.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    m8r::Mind mind(config);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    ASSERT_LE(1, notes.size());
+    m8r::Lexicon charsLexicon{}, chunksLexicon{};
+    m8r::MarkdownTokenizer charsTokenizer{charsLexicon, blacklist}, chunksTokenizer{chunksLexicon, blacklist};
+    for(m8r::Note* n:notes) {
+        m8r::WordFrequencyList charsWfl{&charsLexicon}, chunksWfl{&chunksLexicon};
+        m8r::NoteCharProvider chars{n};
+        charsTokenizer.tokenize(chars, charsWfl);
+        chunksTokenizer.tokenizeChunks(m8r::NoteChunkProvider{n}, chunksWfl);
+        EXPECT_EQ(words(charsLexicon, charsWfl), words(chunksLexicon, chunksWfl)) << n->getName();
+    }
+    ASSERT_EQ(charsLexicon.size(), chunksLexicon.size());
+}
+
+TEST(AiNlpTestCase, TokenizerUtf8)
+{
+    m8r::CommonWordsBlacklist blacklist{};
+    m8r::Lexicon lexicon{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+    auto words = [&](const string& text, bool lowercase, m8r::Stemmer::Language language) {
+        m8r::WordFrequencyList wfl{&lexicon};
+        tokenizer.tokenizeChunks(m8r::StringChunkProvider{text+"\n"}, wfl, false, lowercase, language!=m8r::Stemmer::ENGLISH, language);
+        set<string> result{};
+        for(auto& w:wfl.iterable()) {
+            result.insert(lexicon.getWord(w.first));
+        }
+        return result;
+    };
+
+    // non-ASCII letters are part of words, Unicode punctuation is delimiter
+    EXPECT_EQ(
+        (set<string>{u8"příliš", u8"žluťoučký", u8"kůň", u8"úpěl"}),
+        words(u8"Příliš Žluťoučký kůň—úpěl…", true, m8r::Stemmer::ENGLISH));
+    EXPECT_EQ(
+        (set<string>{u8"grüße", u8"ärger"}),
+        words(u8"»GRÜßE« „Ärger“ é", true, m8r::Stemmer::ENGLISH));
+    EXPECT_EQ(
+        (set<string>{u8"Ärger"}),
+        words(u8"„Ärger“", false, m8r::Stemmer::ENGLISH));
+    EXPECT_EQ(
+        (set<string>{u8"привет", u8"мир"}),
+        words(u8"ПРИВЕТ, Мир! и 😀", true, m8r::Stemmer::ENGLISH));
+    // invalid UTF-8 is delimiter
+    EXPECT_EQ((set<string>{"ab", "cd"}), words("ab\xC3" "cd\x80", true, m8r::Stemmer::ENGLISH));
+
+    // words are stemmed by stemmer of language
+    EXPECT_EQ((set<string>{u8"haus"}), words(u8"Häuser", true, m8r::Stemmer::GERMAN));
+    EXPECT_EQ((set<string>{u8"книг"}), words(u8"книгами", true, m8r::Stemmer::RUSSIAN));
+}
+
+TEST(AiNlpTestCase, LanguageDetector)
+{
+    m8r::LanguageDetector detector{};
+    ASSERT_LT(0, detector.getProfilesSize());
+
+    vector<pair<m8r::Stemmer::Language,string>> texts{
+        {m8r::Stemmer::ENGLISH, u8"The theory of relativity usually encompasses two interrelated theories by Albert Einstein: "
+            "special relativity and general relativity. It introduced concepts including spacetime as a unified entity of space and time."},
+        {m8r::Stemmer::GERMAN, u8"Die Relativitätstheorie befasst sich mit der Struktur von Raum und Zeit sowie mit dem Wesen der "
+            "Gravitation. Sie besteht aus zwei maßgeblich von Albert Einstein geschaffenen physikalischen Theorien."},
+        {m8r::Stemmer::FRENCH, u8"La théorie de la relativité est une théorie physique qui décrit la structure de l'espace et du "
+            "temps. Elle a été développée par Albert Einstein au début du vingtième siècle."},
+        {m8r::Stemmer::SPANISH, u8"La teoría de la relatividad incluye tanto la teoría de la relatividad especial como la de la "
+            "relatividad general, formuladas por Albert Einstein a principios del siglo veinte."},
+        {m8r::Stemmer::ITALIAN, u8"La teoria della relatività è una teoria fisica che descrive la struttura dello spazio e del "
+            "tempo. È stata sviluppata da Albert Einstein all'inizio del ventesimo secolo."},
+        {m8r::Stemmer::PORTUGUESE, u8"A teoria da relatividade é uma teoria física que descreve a estrutura do espaço e do tempo. "
+            "Ela foi desenvolvida por Albert Einstein no início do século vinte."},
+        {m8r::Stemmer::DUTCH, u8"De relativiteitstheorie is een natuurkundige theorie die de structuur van ruimte en tijd "
+            "beschrijft. Zij werd door Albert Einstein aan het begin van de twintigste eeuw ontwikkeld."},
+        {m8r::Stemmer::DANISH, u8"Relativitetsteorien er en fysisk teori, som beskriver rummets og tidens struktur. Den blev "
+            "udviklet af Albert Einstein i begyndelsen af det tyvende århundrede, og den har været meget vigtig."},
+        {m8r::Stemmer::NORWEGIAN, u8"Relativitetsteorien er en fysisk teori som beskriver strukturen til rom og tid. Den ble "
+            "utviklet av Albert Einstein i begynnelsen av det tjuende århundre, og den har vært svært viktig."},
+        {m8r::Stemmer::SWEDISH, u8"Relativitetsteorin är en fysikalisk teori som beskriver rummets och tidens struktur. Den "
+            "utvecklades av Albert Einstein i början av det tjugonde århundradet och har varit mycket viktig."},
+        {m8r::Stemmer::FINNISH, u8"Suhteellisuusteoria on fysiikan teoria, joka kuvaa avaruuden ja ajan rakennetta. Albert "
+            "Einstein kehitti sen vuosisadan alussa, ja se on ollut hyvin tärkeä."},
+        {m8r::Stemmer::RUSSIAN, u8"Теория относительности — физическая теория, которая описывает структуру пространства и "
+            "времени. Она была разработана Альбертом Эйнштейном в начале двадцатого века."},
+        // too short to be detected
+        {m8r::Stemmer::ENGLISH, u8"Einstein"},
+        {m8r::Stemmer::ENGLISH, u8""}};
+    for(auto& t:texts) {
+        EXPECT_STREQ(m8r::Stemmer::getLanguageName(t.first), m8r::Stemmer::getLanguageName(detector.detect(t.second))) << t.second;
+    }
+
+    // Ns of English repository
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-ld.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    for(m8r::Note* n:notes) {
+        EXPECT_EQ(m8r::Stemmer::ENGLISH, detector.detect(m8r::NoteChunkProvider{n})) << n->getName();
+    }
+}
+
 /*
  * AA: BoW
  */
@@ -285,11 +576,343 @@ TEST(AiNlpTestCase, AaUniverseBow)
     ASSERT_EQ(9, leaderboard.size());
     ASSERT_EQ("Same Albert Einstein", leaderboard[0].first->getName());
     ASSERT_EQ("Universe", leaderboard[0].first->getOutline()->getName());
-    ASSERT_FLOAT_EQ(0.9, leaderboard[0].second);
+    // the last word of title counts too
+    ASSERT_FLOAT_EQ(0.93333334, leaderboard[0].second);
     ASSERT_EQ("Same Albert Einstein", leaderboard[1].first->getName());
     ASSERT_EQ("Alternative Universe", leaderboard[1].first->getOutline()->getName());
 }
 
+TEST(AiNlpTestCase, AaCandidates)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-ac.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+
+    m8r::Mind mind(config);
+    // AA rows are calculated (not restored from AI model)
+    mind.remind().setSnapshot(false);
+    bool learned = mind.learn();
+    ASSERT_EQ(true, learned);
+
+    // AA rows calculated from candidates are the same as rows calculated by comparison w/ all Ns
+    m8r::AiAaBoW exhaustive{mind.remind(), mind};
+    exhaustive.setExhaustiveAa(true);
+    ASSERT_TRUE(exhaustive.dream().get());
+    m8r::AiAaBoW candidates{mind.remind(), mind};
+    ASSERT_FALSE(candidates.isExhaustiveAa());
+    ASSERT_TRUE(candidates.dream().get());
+
+    ASSERT_EQ(10, candidates.getAaNeighbors().size());
+    for(size_t i=0; i<candidates.getAaNeighbors().size(); i++) {
+        exhaustive.calculateAaRow(i);
+        candidates.calculateAaRow(i);
+        EXPECT_FALSE(candidates.getAaNeighbors()[i].empty());
+    }
+    EXPECT_EQ(exhaustive.getAaNeighbors(), candidates.getAaNeighbors());
+
+    // precalculation compares all Ns
+    m8r::AiAaBoW precalculated{mind.remind(), mind};
+    ASSERT_TRUE(precalculated.dream().get());
+    precalculated.precalculateAa(2);
+    EXPECT_EQ(exhaustive.getAaNeighbors(), precalculated.getAaNeighbors());
+}
+
+TEST(AiNlpTestCase, AaIncremental)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-ai.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+
+    m8r::Mind mind(config);
+    // AA rows are calculated (not restored from AI model)
+    mind.remind().setSnapshot(false);
+    bool learned = mind.learn();
+    ASSERT_EQ(true, learned);
+
+    // AA rows of incrementally learned Ns are the same for candidates and exhaustive comparison
+    m8r::AiAaBoW exhaustive{mind.remind(), mind};
+    exhaustive.setExhaustiveAa(true);
+    ASSERT_TRUE(exhaustive.dream().get());
+    m8r::AiAaBoW candidates{mind.remind(), mind};
+    ASSERT_TRUE(candidates.dream().get());
+    ASSERT_EQ(10, candidates.getAaNeighbors().size());
+    for(size_t i=0; i<candidates.getAaNeighbors().size(); i++) {
+        exhaustive.calculateAaRow(i);
+        candidates.calculateAaRow(i);
+    }
+    // rows of AI w/o calculated rows are calculated after all changes (not reassessed on remember)
+    m8r::AiAaBoW calculatedLater{mind.remind(), mind};
+    ASSERT_TRUE(calculatedLater.dream().get());
+
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    for(m8r::Outline* candidate:mind.remind().getOutlines()) {
+        if(candidate->getNotesCount() > o->getNotesCount()) {
+            o = candidate;
+        }
+    }
+    ASSERT_LE(3, o->getNotesCount());
+
+    // modified N keeps its ID
+    m8r::Note* modified = o->getNotes()[1];
+    const int modifiedId = modified->getAiAaMatrixIndex();
+    modified->setName("Theory of relativity");
+    modified->setDescription(vector<string*>{new string{"Einstein explained how the universe works w/ theory of relativity."}});
+    exhaustive.remember(modified);
+    candidates.remember(modified);
+    calculatedLater.remember(modified);
+    EXPECT_EQ(modifiedId, modified->getAiAaMatrixIndex());
+
+    // forgotten N (w/ its children) is not a neighbor of any N
+    m8r::Note* forgotten = o->getNotes()[2];
+    vector<m8r::Note*> forgottenNotes{forgotten};
+    o->getNoteChildren(forgotten, &forgottenNotes);
+    for(m8r::Note* n:forgottenNotes) {
+        exhaustive.forget(n);
+        candidates.forget(n);
+        calculatedLater.forget(n);
+    }
+    const size_t forgottenId = forgottenNotes.back()->getAiAaMatrixIndex();
+    mind.noteForget(forgotten);
+    for(auto& neighbors:candidates.getAaNeighbors()) {
+        for(auto& neighbor:neighbors) {
+            EXPECT_NE(forgottenId, neighbor.first);
+        }
+    }
+
+    // new N reuses ID of forgotten N
+    string name{"Albert Einstein and relativity"};
+    m8r::Note* created = mind.noteNew(o->getKey(), 0, &name);
+    ASSERT_NE(nullptr, created);
+    created->setDescription(vector<string*>{new string{"Einstein was physicist who explained the universe."}});
+    exhaustive.remember(created);
+    candidates.remember(created);
+    calculatedLater.remember(created);
+    EXPECT_EQ(forgottenId, static_cast<size_t>(created->getAiAaMatrixIndex()));
+    EXPECT_EQ(10, candidates.getAaNeighbors().size());
+
+    for(size_t i=0; i<candidates.getAaNeighbors().size(); i++) {
+        exhaustive.calculateAaRow(i);
+        candidates.calculateAaRow(i);
+        calculatedLater.calculateAaRow(i);
+    }
+    EXPECT_EQ(exhaustive.getAaNeighbors(), candidates.getAaNeighbors());
+    // word weights of remembered Ns are the same as weights of learned Ns i.e. AA is symmetric
+    // and rows reassessed on remember are the same as rows calculated from scratch
+    EXPECT_EQ(calculatedLater.getAaNeighbors(), candidates.getAaNeighbors());
+    vector<m8r::Note*> learnedNotes{};
+    mind.remind().getAllNotes(learnedNotes);
+    for(m8r::Note* x:learnedNotes) {
+        for(m8r::Note* y:learnedNotes) {
+            EXPECT_EQ(
+                candidates.calculateAa(x->getAiAaMatrixIndex(), y->getAiAaMatrixIndex()),
+                candidates.calculateAa(y->getAiAaMatrixIndex(), x->getAiAaMatrixIndex()));
+        }
+    }
+
+    // leaderboards of modified and created Ns reflect their new content
+    vector<pair<m8r::Note*,float>> leaderboard;
+    ASSERT_TRUE(candidates.getAssociatedNotes(created, leaderboard).get()); // blocked
+    candidates.getAssociatedNotes(created, leaderboard);
+    m8r::Ai::print(created, leaderboard);
+    ASSERT_LE(1, leaderboard.size());
+    bool modifiedAssociated = false;
+    for(auto& association:leaderboard) {
+        EXPECT_NE(created, association.first);
+        EXPECT_NE(forgotten, association.first);
+        modifiedAssociated = modifiedAssociated || association.first == modified;
+    }
+    EXPECT_TRUE(modifiedAssociated);
+}
+
+TEST(AiNlpTestCase, AaModel)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-am.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    remove(config.getAiModelPath().c_str());
+
+    m8r::Mind mind(config);
+    bool learned = mind.learn();
+    ASSERT_EQ(true, learned);
+
+    // learned model is saved, AA rows are saved once calculated
+    m8r::AiAaBoW dreamed{mind.remind(), mind};
+    ASSERT_TRUE(dreamed.dream().get());
+    ASSERT_TRUE(m8r::isFile(config.getAiModelPath().c_str()));
+    dreamed.precalculateAa(2);
+    ASSERT_TRUE(dreamed.saveModel());
+    ASSERT_FALSE(dreamed.saveModel());
+
+    // model is restored w/ AA rows
+    m8r::AiAaBoW restored{mind.remind(), mind};
+    ASSERT_TRUE(restored.dream().get());
+    ASSERT_EQ(10, restored.getAaNeighbors().size());
+    EXPECT_EQ(dreamed.getAaNeighbors(), restored.getAaNeighbors());
+    EXPECT_FALSE(restored.saveModel());
+
+    // modified N is learned again - the same way as if it was remembered
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    for(m8r::Outline* candidate:mind.remind().getOutlines()) {
+        if(candidate->getNotesCount() > o->getNotesCount()) {
+            o = candidate;
+        }
+    }
+    m8r::Note* modified = o->getNotes()[1];
+    modified->setName("Theory of relativity");
+    modified->setDescription(vector<string*>{new string{"Einstein explained how the universe works w/ theory of relativity."}});
+    dreamed.remember(modified);
+    m8r::AiAaBoW incremental{mind.remind(), mind};
+    ASSERT_TRUE(incremental.dream().get());
+    EXPECT_TRUE(incremental.getAaNeighbors()[modified->getAiAaMatrixIndex()].empty());
+    for(size_t i=0; i<incremental.getAaNeighbors().size(); i++) {
+        dreamed.calculateAaRow(i);
+        incremental.calculateAaRow(i);
+    }
+    EXPECT_EQ(dreamed.getAaNeighbors(), incremental.getAaNeighbors());
+
+    // corrupted model is ignored - memory is learned from scratch
+    string model{*unique_ptr<string>(m8r::fileToString(config.getAiModelPath()))};
+    model[model.size()/2] ^= 0x5A;
+    m8r::stringToFile(config.getAiModelPath(), model);
+    m8r::AiAaBoW relearned{mind.remind(), mind};
+    ASSERT_TRUE(relearned.dream().get());
+    ASSERT_EQ(10, relearned.getAaNeighbors().size());
+    for(auto& neighbors:relearned.getAaNeighbors()) {
+        EXPECT_TRUE(neighbors.empty());
+    }
+}
+
+TEST(AiNlpTestCase, AaWorkers)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-aw.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+
+    m8r::Mind mind(config);
+    bool learned = mind.learn();
+    ASSERT_EQ(true, learned);
+
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    ASSERT_TRUE(aa.dream().get());
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    ASSERT_EQ(10, notes.size());
+
+    // user quickly navigates through Ns (and back) - requests of Ns left are cancelled or finished
+    vector<shared_future<bool>> futures{};
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    for(int round=0; round<3; round++) {
+        for(m8r::Note* n:notes) {
+            futures.push_back(aa.getAssociatedNotes(n, leaderboard));
+        }
+    }
+    for(auto& f:futures) {
+        f.wait();
+    }
+    EXPECT_TRUE(futures.back().get());
+    EXPECT_GE(aa.getWorkers().getMaxThreads(), aa.getWorkers().getThreadsCount());
+    // coalesced requests share the task
+    EXPECT_GE(futures.size(), aa.getWorkers().getExecutedCount()+aa.getWorkers().getCancelledCount());
+
+    // leaderboard of the last N is cached
+    leaderboard.clear();
+    shared_future<bool> cached = aa.getAssociatedNotes(notes.back(), leaderboard);
+    ASSERT_EQ(future_status::ready, cached.wait_for(chrono::seconds(0)));
+    EXPECT_TRUE(cached.get());
+    EXPECT_EQ(9, leaderboard.size());
+}
+
+TEST(AiNlpTestCase, AaUniverseMinHash)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-aumh.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::MIN_HASH);
+    ASSERT_EQ(static_cast<unsigned>(m8r::Configuration::DEFAULT_ASYNC_MIND_THRESHOLD_MIN_HASH), config.getAsyncMindThreshold());
+
+    m8r::Mind mind(config);
+    bool learned = mind.learn();
+    ASSERT_EQ(true, learned);
+
+    shared_future<bool> readyToThink = mind.think();
+    ASSERT_EQ(true, readyToThink.get()); // blocked
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+    m8r::Outline* u;
+    if(mind.remind().getOutlines()[0]->getName().find("Alternative") != string::npos) {
+        u = mind.remind().getOutlines()[1];
+    } else {
+        u = mind.remind().getOutlines()[0];
+    }
+
+    // the best associations of 'Albert Einstein' are Ns w/ the same words
+    m8r::Note* n=u->getNotes()[0];
+    vector<pair<m8r::Note*,float>> leaderboard;
+    ASSERT_TRUE(mind.getAssociatedNotes(n, leaderboard).get());
+    m8r::Ai::print(n,leaderboard);
+    ASSERT_LE(2, leaderboard.size());
+    for(auto& association:leaderboard) {
+        EXPECT_NE(n, association.first);
+    }
+    EXPECT_EQ("Same Albert Einstein", leaderboard[0].first->getName());
+    EXPECT_EQ("Same Albert Einstein", leaderboard[1].first->getName());
+    EXPECT_LE(leaderboard[1].second, leaderboard[0].second);
+
+    // words are signed on demand
+    vector<pair<m8r::Note*,float>> words;
+    ASSERT_TRUE(mind.getAssociatedNotes(
+        "Same Note. Albert Einstein was physicists who explained how the universe works with his Theory of relativity.",
+        words,
+        n).get());
+    ASSERT_LE(1, words.size());
+    EXPECT_EQ("Same Albert Einstein", words[0].first->getName());
+
+    // forgotten Ns are not associated
+    m8r::AiAaMinHash aa{mind.remind(), mind, 64, 2};
+    ASSERT_TRUE(aa.dream().get());
+    ASSERT_EQ(10, aa.getNotesCount());
+    const m8r::Outline* forgotten = leaderboard[0].first->getOutline();
+    aa.forget(forgotten);
+    ASSERT_TRUE(aa.getAssociatedNotes(n, leaderboard).get());
+    for(auto& association:leaderboard) {
+        EXPECT_NE(forgotten, association.first->getOutline());
+    }
+
+    // remembered N is re-signed to a new slot
+    m8r::Note* remembered = u->getNotes()[1];
+    ASSERT_NE(n, remembered);
+    remembered->setName(n->getName());
+    vector<string*> description{};
+    for(const string* line:n->getDescription()) {
+        description.push_back(new string{*line});
+    }
+    remembered->setDescription(description);
+    aa.remember(remembered);
+    EXPECT_EQ(11, aa.getNotesCount());
+    EXPECT_EQ(10, remembered->getAiAaMatrixIndex());
+    ASSERT_TRUE(aa.getAssociatedNotes(n, leaderboard).get());
+    bool rememberedAssociated = false;
+    for(auto& association:leaderboard) {
+        rememberedAssociated = rememberedAssociated || (association.first == remembered && association.second == 1.);
+    }
+    EXPECT_TRUE(rememberedAssociated);
+}
+
 /*
  * AA: FTS
  */
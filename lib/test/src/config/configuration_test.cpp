@@ -45,6 +45,36 @@ TEST(ConfigurationTestCase, FromConstructor)
     EXPECT_GE(config.getRepositories().size(), 1);
 }
 
+TEST(ConfigurationTestCase, RepositoryCachePaths)
+{
+    string basicPath{"/lib/test/resources/basic-repository"};
+    basicPath.insert(0, getMindforgerGitHomePath());
+    string aaPath{"/lib/test/resources/aa-repository"};
+    aaPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ctc-rcp.md");
+    m8r::Repository* basic = config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(basicPath));
+    m8r::Repository* aa = config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(aaPath));
+
+    // caches live next to configuration, but every repository has its own
+    config.setActiveRepository(basic);
+    string basicSnapshot{config.getMemorySnapshotPath()};
+    string basicModel{config.getAiModelPath()};
+    EXPECT_EQ(0, basicSnapshot.find("/tmp/cfg-ctc-rcp.md."));
+    EXPECT_EQ(0, basicModel.find("/tmp/cfg-ctc-rcp.md."));
+    EXPECT_NE(basicSnapshot, basicModel);
+
+    config.setActiveRepository(aa);
+    EXPECT_NE(basicSnapshot, config.getMemorySnapshotPath());
+    EXPECT_NE(basicModel, config.getAiModelPath());
+
+    config.setActiveRepository(basic);
+    EXPECT_EQ(basicSnapshot, config.getMemorySnapshotPath());
+    EXPECT_EQ(basicModel, config.getAiModelPath());
+}
+
 TEST(ConfigurationTestCase, FromEnvironment)
 {
     // set MINDFORGER_REPOSITORY environment variable
@@ -99,6 +129,7 @@ TEST(ConfigurationTestCase, SaveDefaultConfig)
     EXPECT_NE(std::string::npos, asString->find("Save reads metadata: yes"));
     EXPECT_NE(std::string::npos, asString->find("Active repository: ~/mindforger-repository"));
     EXPECT_NE(std::string::npos, asString->find("Repository: ~/mindforger-repository"));
+    EXPECT_NE(std::string::npos, asString->find("Associations algorithm: weighted-fts"));
     delete asString;
 }
 
@@ -121,6 +152,7 @@ TEST(ConfigurationTestCase, SaveAndLoad)
     m8r::TimeScope backupTimeScope = c.getTimeScope();
     bool backupReadsMetadata = c.isSaveReadsMetadata();
     bool backupNotebookButton = c.isUiEditorEnableSyntaxHighlighting();
+    m8r::Configuration::AssociationAssessmentAlgorithm backupAaAlgorithm = c.getAaAlgorithm();
     m8r::Repository* backupActiveRepository;
     if(c.isActiveRepository()) {
         backupActiveRepository = new m8r::Repository(*c.getActiveRepository());
@@ -138,6 +170,7 @@ TEST(ConfigurationTestCase, SaveAndLoad)
     c.setTimeScope(ts);
     c.setSaveReadsMetadata(false);
     c.setUiEditorEnableSyntaxHighlighting(false);
+    c.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::MIN_HASH);
     m8r::Repository* r = new m8r::Repository{
         repositoryDir,
         m8r::Repository::RepositoryType::MARKDOWN,
@@ -154,6 +187,7 @@ TEST(ConfigurationTestCase, SaveAndLoad)
     EXPECT_NE(std::string::npos, asString->find("Time scope: 1y2m33d4h55m"));
     EXPECT_NE(std::string::npos, asString->find("Editor syntax highlighting: no"));
     EXPECT_NE(std::string::npos, asString->find("Save reads metadata: no"));
+    EXPECT_NE(std::string::npos, asString->find("Associations algorithm: min-hash"));
     EXPECT_NE(std::string::npos, asString->find("Active repository: /tmp/custom-repository-single-file.md"));
     EXPECT_NE(std::string::npos, asString->find("Repository: /tmp/custom-repository-single-file.md"));
     delete asString;
@@ -164,6 +198,7 @@ TEST(ConfigurationTestCase, SaveAndLoad)
      */
 
     c.setConfigFilePath(file);
+    c.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS);
 
     bool loaded = configRepresentation.load(c);
 
@@ -174,6 +209,8 @@ TEST(ConfigurationTestCase, SaveAndLoad)
     EXPECT_EQ("1y2m33d4h55m", timeScopeAsString);
     EXPECT_FALSE(c.isSaveReadsMetadata());
     EXPECT_FALSE(c.isUiEditorEnableSyntaxHighlighting());
+    EXPECT_EQ(m8r::Configuration::AssociationAssessmentAlgorithm::MIN_HASH, c.getAaAlgorithm());
+    EXPECT_EQ(static_cast<unsigned>(m8r::Configuration::DEFAULT_ASYNC_MIND_THRESHOLD_MIN_HASH), c.getAsyncMindThreshold());
 
     EXPECT_GE(c.getRepositories().size(), 1);
     EXPECT_NE(c.getRepositories().end(), c.getRepositories().find(repositoryPath));
@@ -197,6 +234,7 @@ TEST(ConfigurationTestCase, SaveAndLoad)
     c.setTimeScope(backupTimeScope);
     c.setSaveReadsMetadata(backupReadsMetadata);
     c.setUiEditorEnableSyntaxHighlighting(backupNotebookButton);
+    c.setAaAlgorithm(backupAaAlgorithm);
     if(backupActiveRepository) {
         c.setActiveRepository(c.addRepository(backupActiveRepository));
     } else {
@@ -0,0 +1,147 @@
+/*
+ perfect_hash_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/gear/perfect_hash.h"
+#include "../../../src/mind/ai/nlp/common_words_blacklist.h"
+
+using namespace std;
+using namespace m8r;
+
+namespace {
+
+/*
+ * Table built at runtime and set which uses it.
+ */
+struct Table {
+    vector<uint32_t> seeds;
+    vector<string> slots;
+    vector<const char*> words;
+    vector<uint8_t> lengths;
+
+    bool build(const vector<string>& input) {
+        if(!perfecthash::build(input, seeds, slots)) {
+            return false;
+        }
+        for(const string& s:slots) {
+            words.push_back(s.c_str());
+            lengths.push_back(s.size());
+        }
+        return true;
+    }
+    PerfectHashSet set() const {
+        return PerfectHashSet{words.data(), lengths.data(), seeds.data(), words.size()};
+    }
+};
+
+} // anonymous namespace
+
+TEST(PerfectHashTestCase, Contains)
+{
+    vector<string> planets{"Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto"};
+    Table table{};
+    ASSERT_TRUE(table.build(planets));
+    EXPECT_TRUE(perfecthash::isValid(table.words.data(), table.lengths.data(), table.seeds.data(), planets.size()));
+    PerfectHashSet set = table.set();
+    EXPECT_EQ(9, set.getSize());
+
+    for(const string& w:planets) {
+        EXPECT_TRUE(set.contains(w)) << w;
+    }
+    // prefixes, extensions, case and empty string
+    EXPECT_FALSE(set.contains(""));
+    EXPECT_FALSE(set.contains("Mar"));
+    EXPECT_FALSE(set.contains("Marss"));
+    EXPECT_FALSE(set.contains("earth"));
+    EXPECT_FALSE(set.contains("Moon"));
+    // length is part of comparison
+    EXPECT_FALSE(set.contains("Venus", 4));
+    EXPECT_TRUE(set.contains("Venusian", 5));
+
+    Table single{};
+    ASSERT_TRUE(single.build(vector<string>{"x"}));
+    EXPECT_TRUE(single.set().contains("x"));
+    EXPECT_FALSE(single.set().contains("y"));
+    EXPECT_FALSE(single.set().contains("xx"));
+
+    // words must be unique
+    Table duplicates{};
+    EXPECT_FALSE(duplicates.build(vector<string>{"x", "y", "x"}));
+}
+
+TEST(PerfectHashTestCase, Minimal)
+{
+    vector<string> words{};
+    for(int i=0; i<500; i++) {
+        words.push_back("word"+to_string(i*7));
+    }
+    Table table{};
+    ASSERT_TRUE(table.build(words));
+
+    // every slot of table is used by exactly one word and table doesn't depend on order of words
+    EXPECT_EQ(words.size(), set<string>(table.slots.begin(), table.slots.end()).size());
+    std::reverse(words.begin(), words.end());
+    Table reversed{};
+    ASSERT_TRUE(reversed.build(words));
+    EXPECT_EQ(table.seeds, reversed.seeds);
+    EXPECT_EQ(table.slots, reversed.slots);
+
+    // word in wrong slot or w/ wrong length is detected
+    EXPECT_TRUE(perfecthash::isValid(table.words.data(), table.lengths.data(), table.seeds.data(), words.size()));
+    std::swap(table.words[0], table.words[1]);
+    EXPECT_FALSE(perfecthash::isValid(table.words.data(), table.lengths.data(), table.seeds.data(), words.size()));
+    std::swap(table.words[0], table.words[1]);
+    table.lengths[0]++;
+    EXPECT_FALSE(perfecthash::isValid(table.words.data(), table.lengths.data(), table.seeds.data(), words.size()));
+}
+
+TEST(PerfectHashTestCase, CommonWords)
+{
+    typedef CommonWordsBlacklist::CommonWords CommonWords;
+
+    // checked-in table is the table generated from its words
+    vector<string> words{CommonWords::words, CommonWords::words+CommonWords::SIZE};
+    Table table{};
+    ASSERT_TRUE(table.build(words));
+    vector<uint32_t> seeds{CommonWords::seeds, CommonWords::seeds+CommonWords::SIZE};
+    EXPECT_EQ(table.seeds, seeds);
+    EXPECT_EQ(table.slots, words);
+
+    if(table.seeds != seeds || table.slots != words) {
+        cout << "Generated table of common words:" << endl;
+        for(size_t i=0; i<table.slots.size(); i++) {
+            cout << "\"" << table.slots[i] << "\", ";
+        }
+        cout << endl;
+        for(uint8_t l:table.lengths) {
+            cout << static_cast<int>(l) << ", ";
+        }
+        cout << endl << hex << showbase;
+        for(uint32_t s:table.seeds) {
+            cout << s << ", ";
+        }
+        cout << dec << noshowbase << endl;
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ regexp_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/gear/regexp.h"
+
+using namespace std;
+using namespace m8r;
+
+TEST(RegexpTestCase, Syntax)
+{
+    // pattern, text, match
+    vector<tuple<string,string,bool>> cases{
+        make_tuple("abc", "xxabcxx", true),
+        make_tuple("abc", "xxabxcx", false),
+        make_tuple("", "anything", true),
+        make_tuple("a.c", "abc", true),
+        make_tuple("a.c", "ac", false),
+        make_tuple("^abc", "abcd", true),
+        make_tuple("^abc", "xabc", false),
+        make_tuple("abc$", "xabc", true),
+        make_tuple("abc$", "abcx", false),
+        make_tuple("^$", "", true),
+        make_tuple("^$", "x", false),
+        make_tuple("colou?r", "color", true),
+        make_tuple("colou?r", "colour", true),
+        make_tuple("colou?r", "colouur", false),
+        make_tuple("ab*c", "ac", true),
+        make_tuple("ab+c", "ac", false),
+        make_tuple("ab+c", "abbbc", true),
+        make_tuple("a{3}", "aa", false),
+        make_tuple("a{3}", "xaaax", true),
+        make_tuple("^a{2,3}$", "aaaa", false),
+        make_tuple("^a{2,3}$", "aaa", true),
+        make_tuple("^a{2,}$", "aaaaaaa", true),
+        make_tuple("^(ab|cd)+$", "abcdab", true),
+        make_tuple("^(ab|cd)+$", "abcdac", false),
+        make_tuple("^(?:x|y)z", "yz", true),
+        make_tuple("[a-c]x", "bx", true),
+        make_tuple("[a-c]x", "dx", false),
+        make_tuple("[^a-c]x", "dx", true),
+        make_tuple("^[^a-c]x", "bx", false),
+        make_tuple("[-a]", "-", true),
+        make_tuple("[]a]", "]", true),
+        make_tuple("\\d+\\.\\d+", "version 2.25", true),
+        make_tuple("\\d+\\.\\d+", "version 2x25", false),
+        make_tuple("^\\w+$", "snake_case_42", true),
+        make_tuple("^\\w+$", "kebab-case", false),
+        make_tuple("\\s", "no-space", false),
+        make_tuple("\\S\\s\\S", "a b", true),
+        make_tuple("[\\d.]+", "1.2", true),
+        make_tuple("\\(\\)\\[\\]\\{\\}\\*\\+\\?\\|\\^\\$\\\\", "()[]{}*+?|^$\\", true),
+        make_tuple("a+?b", "aab", true),
+        make_tuple("https?://[^ /]+/", "see https://www.mindforger.com/ for", true),
+        make_tuple("čokoláda", "horká čokoláda", true)
+    };
+    for(auto& c:cases) {
+        Regexp r{get<0>(c)};
+        ASSERT_TRUE(r.isValid()) << get<0>(c) << ": " << r.getError();
+        EXPECT_EQ(get<2>(c), r.search(get<1>(c))) << "'" << get<0>(c) << "' in '" << get<1>(c) << "'";
+        // cached DFA gives the same result
+        EXPECT_EQ(get<2>(c), r.search(get<1>(c))) << "'" << get<0>(c) << "' in '" << get<1>(c) << "'";
+    }
+}
+
+TEST(RegexpTestCase, IgnoreCase)
+{
+    Regexp r{"^Hello [w-z]ORLD\\w$", true};
+    ASSERT_TRUE(r.isValid());
+    EXPECT_TRUE(r.search("hello WORLDs"));
+    EXPECT_TRUE(r.search("HELLO world_"));
+    EXPECT_FALSE(r.search("HELLO Vorld_"));
+
+    Regexp n{"[^a]", true};
+    EXPECT_FALSE(n.search("aAaA"));
+    EXPECT_TRUE(n.search("aAbA"));
+
+    Regexp s{"Hello"};
+    EXPECT_FALSE(s.search("hello"));
+}
+
+TEST(RegexpTestCase, Errors)
+{
+    for(const char* pattern:{"(abc", "abc)", "[abc", "*a", "a{1,2", "a{2,1}", "a{1001}", "\\", "\\q", "a|*"}) {
+        Regexp r{pattern};
+        EXPECT_FALSE(r.isValid()) << pattern;
+        EXPECT_FALSE(r.getError().empty()) << pattern;
+        EXPECT_FALSE(r.search("abc"));
+    }
+
+    string deep(Regexp::MAX_DEPTH+1, '(');
+    deep += string(Regexp::MAX_DEPTH+1, ')');
+    EXPECT_FALSE(Regexp{deep}.isValid());
+    EXPECT_FALSE(Regexp{"(a{1000}){1000}"}.isValid());
+}
+
+TEST(RegexpTestCase, RequiredLiterals)
+{
+    EXPECT_EQ(" engine", Regexp("v\\d+ engine").getLongestRequiredLiteral());
+    EXPECT_EQ("engine", Regexp("ENGINE.*block", true).getLongestRequiredLiteral());
+    EXPECT_EQ("abcd", Regexp("x+abcd(ef|gh)").getLongestRequiredLiteral());
+    EXPECT_EQ("", Regexp("abc|def").getLongestRequiredLiteral());
+    EXPECT_EQ("", Regexp("(abc)?").getLongestRequiredLiteral());
+    EXPECT_EQ("", Regexp("[ab]+").getLongestRequiredLiteral());
+}
+
+TEST(RegexpTestCase, Pathological)
+{
+    // backtracking matchers need exponential time for these expressions
+    string text(100000, 'a');
+    for(const char* pattern:{"(a*)*b", "(a|aa)*c", "^(a+)+$x", "(a|a?)+b", "(.*a){20}b"}) {
+        Regexp r{pattern};
+        ASSERT_TRUE(r.isValid()) << pattern;
+        auto begin = chrono::high_resolution_clock::now();
+        EXPECT_FALSE(r.search(text)) << pattern;
+        auto end = chrono::high_resolution_clock::now();
+        auto ms = chrono::duration_cast<chrono::milliseconds>(end-begin).count();
+        cout << pattern << ": " << ms << "ms " << r.getDfaStatesCount() << " DFA states" << endl;
+        EXPECT_LT(ms, 2000) << pattern;
+    }
+}
+
+TEST(RegexpTestCase, DfaCacheFlush)
+{
+    // the n-th character from the end - exponential number of DFA states
+    Regexp r{"a[ab]{12}$"};
+    ASSERT_TRUE(r.isValid());
+    string text{};
+    unsigned seed = 7;
+    for(int i=0; i<50000; i++) {
+        seed = seed*1103515245+12345;
+        text += (seed>>16)&1?'a':'b';
+    }
+    regex reference{"a[ab]{12}$"};
+    for(size_t i=20; i<text.size(); i+=2999) {
+        string prefix = text.substr(0, i);
+        EXPECT_EQ(regex_search(prefix, reference), r.search(prefix)) << i;
+    }
+    EXPECT_LE(r.getDfaStatesCount(), Regexp::MAX_DFA_STATES);
+}
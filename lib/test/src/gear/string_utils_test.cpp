@@ -17,6 +17,8 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -101,3 +103,83 @@ TEST(StringGearTestCase, Trim)
     EXPECT_EQ(0, strcmp("", r));
     delete[] r;
 }
+
+// reference implementation: lower case copy + std::string::find()
+size_t referenceCountIgnoreCase(const string& s, const string& lowerNeedle)
+{
+    string l{};
+    stringToLower(s, l);
+    size_t count = 0;
+    size_t m = l.find(lowerNeedle, 0);
+    while(m != string::npos) {
+        count++;
+        m = l.find(lowerNeedle, m+1);
+    }
+    return count;
+}
+
+TEST(StringGearTestCase, FindIgnoreCase)
+{
+    cout << "Best search kernel: " << static_cast<int>(stringSearchKernel()) << endl;
+    vector<StringSearchKernel> kernels{StringSearchKernel::SCALAR, StringSearchKernel::SSE2, StringSearchKernel::AVX2};
+
+    // corner cases
+    EXPECT_EQ(0, stringFindIgnoreCase("", ""));
+    EXPECT_EQ(string::npos, stringFindIgnoreCase("", "a"));
+    EXPECT_EQ(string::npos, stringFindIgnoreCase("abc", "a", 4));
+    EXPECT_EQ(3, stringFindIgnoreCase("abc", "", 3));
+    EXPECT_EQ(0, stringFindIgnoreCase("MindForger", "mindforger"));
+    EXPECT_EQ(4, stringFindIgnoreCase("MindForger", "forger"));
+    EXPECT_EQ(string::npos, stringFindIgnoreCase("MindForger", "FORGER"));
+    EXPECT_EQ(string::npos, stringFindIgnoreCase("[@`{", "{`@["));
+    EXPECT_EQ(0, stringFindIgnoreCase("[@`{", "[@`{"));
+    EXPECT_EQ(3, stringCountIgnoreCase("AaAa", "aa"));
+    EXPECT_EQ(5, stringCountIgnoreCase("AaAa", ""));
+    // only ASCII is folded (as by stringToLower())
+    EXPECT_EQ(string::npos, stringFindIgnoreCase("ČEŠTINA", "čeština"));
+    EXPECT_EQ(0, stringFindIgnoreCase("ČEšTINA", "Čeština"));
+
+    // match at every position of SIMD blocks and block boundaries
+    for(StringSearchKernel kernel:kernels) {
+        for(size_t size=1; size<100; size++) {
+            string haystack(size, 'x');
+            for(size_t needleSize=1; needleSize<=size && needleSize<40; needleSize+=3) {
+                string needle(needleSize, 'n');
+                needle[0] = 'f';
+                needle[needleSize-1] = 'l';
+                for(size_t p=0; p+needleSize<=size; p+=5) {
+                    string h{haystack};
+                    for(size_t i=0; i<needleSize; i++) {
+                        h[p+i] = toupper(needle[i]);
+                    }
+                    ASSERT_EQ(p, stringFindIgnoreCase(h.data(), h.size(), needle.data(), needle.size(), kernel))
+                        << "kernel " << static_cast<int>(kernel) << " haystack '" << h << "' needle '" << needle << "'";
+                }
+            }
+        }
+    }
+
+    // random texts w/ small alphabet (lots of partial matches) vs. reference
+    mt19937 random{42};
+    const string alphabet{"aAbB .\xC4\x8D"};
+    for(int t=0; t<2000; t++) {
+        string haystack{}, needle{};
+        size_t size = random()%200;
+        for(size_t i=0; i<size; i++) {
+            haystack += alphabet[random()%alphabet.size()];
+        }
+        size_t needleSize = 1+random()%5;
+        for(size_t i=0; i<needleSize; i++) {
+            needle += alphabet[random()%alphabet.size()];
+        }
+        string lowerNeedle{};
+        stringToLower(needle, lowerNeedle);
+
+        string lowerHaystack{};
+        stringToLower(haystack, lowerHaystack);
+        for(StringSearchKernel kernel:kernels) {
+            ASSERT_EQ(lowerHaystack.find(lowerNeedle), stringFindIgnoreCase(haystack.data(), haystack.size(), lowerNeedle.data(), lowerNeedle.size(), kernel));
+            ASSERT_EQ(referenceCountIgnoreCase(haystack, lowerNeedle), stringCountIgnoreCase(haystack, lowerNeedle, kernel));
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ task_executor_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/gear/task_executor.h"
+
+using namespace std;
+using namespace m8r;
+
+TEST(TaskExecutorTestCase, BoundedThreads)
+{
+    TaskExecutor executor{2};
+    ASSERT_EQ(2, executor.getMaxThreads());
+    ASSERT_EQ(0, executor.getThreadsCount());
+
+    atomic<int> running{0}, maxRunning{0};
+    vector<shared_future<bool>> futures{};
+    for(int i=0; i<20; i++) {
+        futures.push_back(executor.submit(nullptr, [&]() {
+            int r = ++running;
+            int m = maxRunning;
+            while(r>m && !maxRunning.compare_exchange_weak(m, r));
+            this_thread::sleep_for(chrono::milliseconds(2));
+            --running;
+            return true;
+        }));
+    }
+    for(auto& f:futures) {
+        EXPECT_TRUE(f.get());
+    }
+    executor.wait();
+
+    EXPECT_GE(2, maxRunning);
+    EXPECT_GE(2u, executor.getThreadsCount());
+    EXPECT_EQ(20, executor.getExecutedCount());
+    EXPECT_EQ(0, executor.getQueueSize());
+}
+
+TEST(TaskExecutorTestCase, CoalesceAndCancel)
+{
+    TaskExecutor executor{1};
+    int a, b, c;
+
+    // the only thread is blocked by task w/ key A
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    atomic<int> executedA{0};
+    auto taskA = [&]() { opened.wait(); executedA++; return true; };
+    shared_future<bool> runningA = executor.submit(&a, taskA);
+    while(executor.getQueueSize()) {
+        this_thread::yield();
+    }
+
+    // running and queued tasks w/ the same key are coalesced
+    shared_future<bool> coalescedA = executor.submit(&a, taskA);
+    shared_future<bool> queuedB = executor.submit(&b, []() { return true; });
+    shared_future<bool> coalescedB = executor.submit(&b, []() { return true; });
+    shared_future<bool> unkeyed = executor.submit(nullptr, []() { return true; });
+    EXPECT_EQ(2, executor.getQueueSize());
+
+    // new request cancels queued requests w/ other keys, but not tasks w/o key
+    EXPECT_EQ(1, executor.cancel(&c));
+    shared_future<bool> queuedC = executor.submit(&c, []() { return true; });
+    EXPECT_FALSE(queuedB.get());
+    EXPECT_FALSE(coalescedB.get());
+    EXPECT_EQ(2, executor.getQueueSize());
+
+    gate.set_value();
+    EXPECT_TRUE(runningA.get());
+    EXPECT_TRUE(coalescedA.get());
+    EXPECT_TRUE(unkeyed.get());
+    EXPECT_TRUE(queuedC.get());
+    executor.wait();
+
+    EXPECT_EQ(1, executedA);
+    EXPECT_EQ(3, executor.getExecutedCount());
+    EXPECT_EQ(1, executor.getCancelledCount());
+}
+
+TEST(TaskExecutorTestCase, ExceptionAndShutdown)
+{
+    shared_future<bool> queued;
+    {
+        TaskExecutor executor{1};
+
+        shared_future<bool> failed = executor.submit(nullptr, []() -> bool { throw runtime_error{"failed"}; });
+        EXPECT_THROW(failed.get(), runtime_error);
+
+        promise<void> gate{};
+        shared_future<void> opened = gate.get_future().share();
+        shared_future<bool> running = executor.submit(nullptr, [opened]() { opened.wait(); return true; });
+        while(executor.getQueueSize()) {
+            this_thread::yield();
+        }
+        queued = executor.submit(nullptr, []() { return true; });
+        gate.set_value();
+        EXPECT_TRUE(running.get());
+        // executor is destroyed - queued task might have been started
+    }
+    // threads were joined i.e. future of every task is ready
+    EXPECT_EQ(future_status::ready, queued.wait_for(chrono::seconds(0)));
+}
+
+namespace {
+
+struct NotifiedTask {
+    shared_future<bool> f;
+    int& deleted;
+
+    NotifiedTask(shared_future<bool> f, int& deleted) : f(f), deleted(deleted) {}
+    ~NotifiedTask() { deleted++; }
+
+    bool isReady() const { return f.wait_for(chrono::microseconds(0)) == future_status::ready; }
+    bool isSuccessful() const { return f.get(); }
+};
+
+}
+
+TEST(TaskExecutorTestCase, CancelledTasksDeleted)
+{
+    TaskExecutor executor{1};
+    int keys[100];
+    int deleted = 0;
+    vector<NotifiedTask*> tasks{};
+
+    // the only thread is blocked - user navigates quickly and requests are cancelled
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    tasks.push_back(new NotifiedTask{executor.submit(nullptr, [opened]() { opened.wait(); return true; }), deleted});
+    for(int i=0; i<100; i++) {
+        executor.cancel(&keys[i]);
+        tasks.push_back(new NotifiedTask{executor.submit(&keys[i], []() { return true; }), deleted});
+    }
+    tasks.push_back(new NotifiedTask{executor.submit(nullptr, []() -> bool { throw runtime_error{"failed"}; }), deleted});
+
+    // cancelled tasks don't pile up - they're deleted w/o notification
+    int notified = 0;
+    EXPECT_EQ(99, deleteReadyTasks(tasks, [&](NotifiedTask*, bool successful) { if(successful) notified++; }));
+    EXPECT_EQ(99, deleted);
+    EXPECT_EQ(0, notified);
+    EXPECT_EQ(3, tasks.size());
+
+    gate.set_value();
+    executor.wait();
+    EXPECT_EQ(3, deleteReadyTasks(tasks, [&](NotifiedTask*, bool successful) { if(successful) notified++; }));
+    EXPECT_EQ(102, deleted);
+    EXPECT_EQ(2, notified);
+    EXPECT_TRUE(tasks.empty());
+}
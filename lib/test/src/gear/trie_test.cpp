@@ -48,4 +48,136 @@ TEST(TrieTestCase, AddAndSearch)
     ASSERT_EQ(false, trie.empty());
     string s{"yours"};
     ASSERT_TRUE(trie.findWord(s));
+    ASSERT_TRUE(trie.findWord("I"));
+    ASSERT_TRUE(trie.findWord("you"));
+    ASSERT_FALSE(trie.findWord("yo"));
+    ASSERT_FALSE(trie.findWord("your"));
+    ASSERT_FALSE(trie.findWord("yourself"));
+    ASSERT_FALSE(trie.findWord(""));
+
+    trie.deleteWord("you");
+    ASSERT_FALSE(trie.findWord("you"));
+    ASSERT_TRUE(trie.findWord("yours"));
+    trie.deleteWord("yours");
+    trie.deleteWord("he");
+    trie.deleteWord("I");
+    ASSERT_TRUE(trie.empty());
+}
+
+TEST(TrieTestCase, BuildAndCompress)
+{
+    vector<string> words{"romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus"};
+    m8r::Trie trie{};
+    trie.build(words);
+
+    for(string& w:words) {
+        ASSERT_TRUE(trie.findWord(w)) << w;
+    }
+    ASSERT_FALSE(trie.findWord("r"));
+    ASSERT_FALSE(trie.findWord("roman"));
+    ASSERT_FALSE(trie.findWord("rubicons"));
+    ASSERT_FALSE(trie.findWord("x"));
+
+    // r > om > an > e|us, ulus; ub > e > ns|r, ic > on|undus
+    ASSERT_EQ(13, trie.getNodesCount());
+
+    vector<string> all{};
+    trie.getWords(all);
+    ASSERT_EQ(words, all);
+
+    // empty word and long labels
+    string longWord(70000, 'x');
+    vector<string> others{"", "a", longWord, longWord+"y"};
+    trie.build(others);
+    for(string& w:others) {
+        ASSERT_TRUE(trie.findWord(w)) << w.size();
+    }
+    ASSERT_FALSE(trie.findWord(string(69999, 'x')));
+    ASSERT_FALSE(trie.findWord(longWord+"x"));
+}
+
+TEST(TrieTestCase, PrefixTopK)
+{
+    vector<string> words{"mind", "mindforger", "mindmap", "mine", "minute", "moon"};
+    vector<uint32_t> weights{5, 9, 1, 7, 5, 10};
+    m8r::Trie trie{};
+    trie.build(words, &weights);
+
+    vector<pair<string,uint32_t>> found{};
+    trie.findPrefix("min", 3, found);
+    ASSERT_EQ(3, found.size());
+    EXPECT_EQ("mindforger", found[0].first);
+    EXPECT_EQ(9, found[0].second);
+    EXPECT_EQ("mine", found[1].first);
+    // the same weight - lexicographic order
+    EXPECT_EQ("mind", found[2].first);
+
+    // prefix ends inside of label
+    found.clear();
+    trie.findPrefix("mindf", 10, found);
+    ASSERT_EQ(1, found.size());
+    EXPECT_EQ("mindforger", found[0].first);
+
+    found.clear();
+    trie.findPrefix("", 10, found);
+    ASSERT_EQ(6, found.size());
+    EXPECT_EQ("moon", found[0].first);
+    EXPECT_EQ("mindmap", found[5].first);
+
+    found.clear();
+    trie.findPrefix("mo0", 10, found);
+    trie.findPrefix("mindforgers", 10, found);
+    trie.findPrefix("min", 0, found);
+    ASSERT_TRUE(found.empty());
+
+    // weight of existing word is updated
+    trie.addWord("mindmap", 100);
+    trie.findPrefix("mi", 1, found);
+    ASSERT_EQ(1, found.size());
+    EXPECT_EQ("mindmap", found[0].first);
+}
+
+TEST(TrieTestCase, Serialization)
+{
+    vector<string> words{"alpha", "alphabet", "beta", "gamma"};
+    vector<uint32_t> weights{1, 2, 3, 4};
+    m8r::Trie trie{};
+    trie.build(words, &weights);
+
+    string buffer{};
+    trie.serialize(buffer);
+    ASSERT_EQ(16+trie.getMemorySize(), buffer.size());
+
+    m8r::Trie loaded{};
+    ASSERT_TRUE(loaded.load(buffer.data(), buffer.size()));
+    vector<string> loadedWords{};
+    vector<uint32_t> loadedWeights{};
+    loaded.getWords(loadedWords, &loadedWeights);
+    ASSERT_EQ(words, loadedWords);
+    ASSERT_EQ(weights, loadedWeights);
+    ASSERT_TRUE(loaded.findWord("alphabet"));
+    ASSERT_FALSE(loaded.findWord("alph"));
+
+    // loaded trie is copied on change
+    loaded.addWord("delta", 5);
+    buffer.assign(buffer.size(), 0);
+    ASSERT_TRUE(loaded.findWord("delta"));
+    ASSERT_TRUE(loaded.findWord("gamma"));
+
+    // invalid buffers
+    trie.serialize(buffer);
+    ASSERT_FALSE(loaded.load(buffer.data(), buffer.size()-1));
+    ASSERT_TRUE(loaded.empty());
+    ASSERT_FALSE(loaded.load(buffer.data(), 8));
+    string corrupted{buffer};
+    // first child of root out of nodes
+    corrupted[16+4] = 100;
+    ASSERT_FALSE(loaded.load(corrupted.data(), corrupted.size()));
+
+    m8r::Trie empty{};
+    buffer.clear();
+    empty.serialize(buffer);
+    ASSERT_TRUE(loaded.load(buffer.data(), buffer.size()));
+    ASSERT_TRUE(loaded.empty());
+    ASSERT_FALSE(loaded.findWord(""));
 }
@@ -669,3 +669,63 @@ TEST(RepositoryIndexerTestCase, MakePathRelative)
 
     delete repository;
 }
+
+#ifdef __linux__
+TEST(RepositoryIndexerTestCase, WatchUpdateIndex)
+{
+    string repositoryPath{"/tmp/mf-unit-repository-watch"};
+    map<string,string> pathToContent;
+    pathToContent[repositoryPath+"/memory/first.md"] = "# First Outline\nFirst outline text.\n";
+    pathToContent[repositoryPath+"/memory/second.md"] = "# Second Outline\nSecond outline text.\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::RepositoryIndexer repositoryIndexer{};
+    m8r::Repository* repository = m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath);
+    repositoryIndexer.index(repository);
+    ASSERT_EQ(2, repositoryIndexer.getMarkdownFiles().size());
+    ASSERT_TRUE(repositoryIndexer.watch());
+
+    vector<m8r::RepositoryChange> changes{};
+    EXPECT_FALSE(repositoryIndexer.updateIndex(changes));
+    EXPECT_TRUE(changes.empty());
+
+    // create + modify + delete + rename + non-Markdown file
+    m8r::stringToFile(repositoryPath+"/memory/third.md", "# Third Outline\n");
+    m8r::stringToFile(repositoryPath+"/memory/first.md", "# First Outline\nModified.\n");
+    remove(string{repositoryPath+"/memory/second.md"}.c_str());
+    m8r::moveFile(repositoryPath+"/memory/third.md", repositoryPath+"/memory/fourth.md");
+    m8r::stringToFile(repositoryPath+"/memory/image.png", "PNG");
+    m8r::stringToFile(repositoryPath+"/stencils/notebooks/stencil.md", "# Stencil\n");
+
+    ASSERT_TRUE(repositoryIndexer.updateIndex(changes, 1000));
+    map<string,m8r::RepositoryChange::Type> types{};
+    for(m8r::RepositoryChange& c:changes) {
+        types[c.path] = c.type;
+    }
+    EXPECT_EQ(4, changes.size());
+    EXPECT_EQ(m8r::RepositoryChange::Type::MODIFIED, types[repositoryPath+"/memory/first.md"]);
+    EXPECT_EQ(m8r::RepositoryChange::Type::DELETED, types[repositoryPath+"/memory/second.md"]);
+    EXPECT_EQ(m8r::RepositoryChange::Type::CREATED, types[repositoryPath+"/memory/fourth.md"]);
+    EXPECT_EQ(m8r::RepositoryChange::Type::CREATED, types[repositoryPath+"/stencils/notebooks/stencil.md"]);
+    // created and renamed in one batch > never existed
+    EXPECT_EQ(types.end(), types.find(repositoryPath+"/memory/third.md"));
+
+    EXPECT_EQ(2, repositoryIndexer.getMarkdownFiles().size());
+    EXPECT_EQ(3, repositoryIndexer.getAllOutlineFileNames().size());
+    EXPECT_EQ(1, repositoryIndexer.getOutlineStencilsFileNames().size());
+
+    // new subdirectory is watched as well
+    m8r::createDirectory(repositoryPath+"/memory/sub");
+    ASSERT_FALSE(repositoryIndexer.updateIndex(changes, 1000));
+    m8r::stringToFile(repositoryPath+"/memory/sub/fifth.md", "# Fifth Outline\n");
+    ASSERT_TRUE(repositoryIndexer.updateIndex(changes, 1000));
+    ASSERT_EQ(1, changes.size());
+    EXPECT_EQ(repositoryPath+"/memory/sub/fifth.md", changes[0].path);
+    EXPECT_EQ(3, repositoryIndexer.getMarkdownFiles().size());
+
+    repositoryIndexer.unwatch();
+    EXPECT_FALSE(repositoryIndexer.isWatching());
+    repositoryIndexer.clear();
+    delete repository;
+}
+#endif
@@ -79,6 +79,40 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsNoMetadata)
     printLexems(lexer.getLexems());
 }
 
+TEST(MarkdownParserTestCase, MarkdownLexerSectionsMmap)
+{
+    vector<string> fileNames{
+        "/lib/test/resources/basic-repository/memory/outline.md",
+        "/lib/test/resources/basic-repository/memory/no-metadata.md",
+        "/lib/test/resources/apiary-repository/memory/01. Simplest API.md",
+        "/lib/test/resources/benchmark-repository/memory/meta.md"
+    };
+    for(string& fileName:fileNames) {
+        fileName.insert(0, getMindforgerGitHomePath());
+
+        MarkdownLexerSections linesLexer(&fileName, MarkdownLexerSections::Mode::LINES);
+        linesLexer.tokenize();
+        MarkdownLexerSections mmapLexer(&fileName, MarkdownLexerSections::Mode::MMAP);
+        mmapLexer.tokenize();
+
+        // asserts - zero copy lexer MUST produce the same lexems and texts
+        ASSERT_EQ(linesLexer.size(), mmapLexer.size());
+        EXPECT_EQ(linesLexer.getFileSize(), mmapLexer.getFileSize());
+        for(size_t i=0; i<linesLexer.size(); i++) {
+            ASSERT_EQ(linesLexer[i]->getType(), mmapLexer[i]->getType());
+            EXPECT_EQ(linesLexer[i]->getOff(), mmapLexer[i]->getOff());
+            EXPECT_EQ(linesLexer[i]->getIdx(), mmapLexer[i]->getIdx());
+            EXPECT_EQ(linesLexer[i]->getLng(), mmapLexer[i]->getLng());
+            if(linesLexer[i]->getType()==MarkdownLexemType::TEXT || linesLexer[i]->getType()==MarkdownLexemType::LINE) {
+                unique_ptr<string> linesText{linesLexer.getText(linesLexer[i])};
+                unique_ptr<string> mmapText{mmapLexer.getText(mmapLexer[i])};
+                ASSERT_TRUE(linesText.get()!=nullptr && mmapText.get()!=nullptr);
+                EXPECT_EQ(*linesText, *mmapText);
+            }
+        }
+    }
+}
+
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsPreamble)
 {
     unique_ptr<string> fileName
@@ -18,8 +18,14 @@
 */
 
 #include <stddef.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <regex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -27,6 +33,8 @@
 
 #include "../../../src/config/configuration.h"
 #include "../../../src/mind/mind.h"
+#include "../../../src/mind/fts_index.h"
+#include "../test_gear.h"
 
 extern char* getMindforgerGitHomePath();
 
@@ -62,3 +70,352 @@ TEST(FtsTestCase, FTS) {
 
     delete result;
 }
+
+// reference linear scan of outline descriptors and notes
+bool ftsMatches(const string& text, const string& s, bool ignoreCase)
+{
+    if(ignoreCase) {
+        string t{}, q{};
+        m8r::stringToLower(text, t);
+        m8r::stringToLower(s, q);
+        return t.find(q)!=string::npos;
+    } else {
+        return text.find(s)!=string::npos;
+    }
+}
+
+bool ftsMatches(const string& name, const vector<string*>& description, const string& s, bool ignoreCase)
+{
+    if(ftsMatches(name, s, ignoreCase)) {
+        return true;
+    }
+    for(const string* d:description) {
+        if(d && ftsMatches(*d, s, ignoreCase)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ftsScan(m8r::Memory& memory, const string& s, bool ignoreCase, vector<m8r::Note*>& result)
+{
+    for(m8r::Outline* o:memory.getOutlines()) {
+        if(ftsMatches(o->getName(), o->getDescription(), s, ignoreCase)) {
+            result.push_back(o->getOutlineDescriptorAsNote());
+        }
+        for(m8r::Note* n:o->getNotes()) {
+            if(ftsMatches(n->getName(), n->getDescription(), s, ignoreCase)) {
+                result.push_back(n);
+            }
+        }
+    }
+}
+
+TEST(FtsTestCase, Index) {
+    string repositoryDir{"/tmp/mf-unit-repository-fts"};
+    map<string,string> pathToContent{};
+    pathToContent[repositoryDir+"/memory/cars.md"] =
+        "# Cars\nFast cars and slow trucks.\n\n"
+        "## Engine\nV8 engine-block made of aluminium.\nSee https://example.com/v8?engine_id=V8_1 for details.\n\n"
+        "## Wheels\nTyre pressure: 2.2 bar.\nRim size 17\".\n";
+    pathToContent[repositoryDir+"/memory/coffee.md"] =
+        "# Coffee\nBlack coffee w/o sugar.\n\n"
+        "## Espresso\nStrong espresso, double shot.\n\n"
+        "## Čokoláda\nHorká čokoláda s mlékem.\n";
+    pathToContent[repositoryDir+"/memory/empty.md"] =
+        "# Empty Outline\n\n## Note w/o Description\n";
+    m8r::createEmptyRepository(repositoryDir, pathToContent);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftstc-i.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    ASSERT_EQ(3, mind.remind().getOutlinesCount());
+    ASSERT_EQ(5, mind.remind().getNotesCount());
+    EXPECT_EQ(3+5, mind.remind().getFtsIndex().getDocumentsCount());
+
+    // tokenizer
+    vector<string> terms{};
+    m8r::FtsIndex::tokenize("V8 engine-block, 2.2 bar; ČOKOLÁDA", terms);
+    EXPECT_EQ((vector<string>{"v8","engine","block","2","2","bar","ČokolÁda"}), terms);
+    terms.clear();
+    m8r::FtsIndex::tokenize(" .,;-- ", terms);
+    EXPECT_TRUE(terms.empty());
+
+    // index results MUST be the same as the results of linear scan
+    vector<string> queries{
+        "engine", "ngin", "Engine", "ENGINE", "engine-block", "ine-bl", "8 engine-b",
+        "2.2 bar", ".2 b", "pressure: 2", "17\"", "coffee w/o", "fee w", "double shot.",
+        "strong espresso, double", "čokoláda s", "Čokol", "o", "e", "nothing", "w/o sugar",
+        "Note w/o Description", "Fast cars", "cars and slow", "trucks.", // whole word & partial phrases
+        "://example", "com/v8?", "_id=v8_1", "id=V8_", "=V", "?e", "8_", // identifiers and URLs
+        ".", ": ", "\"", " ", ". ", "\".", "://" // raw substrings w/o any term
+    };
+    for(const string& query:queries) {
+        for(bool ignoreCase:{false, true}) {
+            unique_ptr<vector<m8r::Note*>> result{mind.findNoteFts(query, ignoreCase)};
+            vector<m8r::Note*> expected{};
+            ftsScan(mind.remind(), query, ignoreCase, expected);
+            EXPECT_EQ(expected, *result) << "Query: '" << query << "' ignore case: " << ignoreCase;
+        }
+    }
+
+    // outline scope
+    m8r::Outline* cars = mind.remind().getOutline(repositoryDir+"/memory/cars.md");
+    ASSERT_NE(nullptr, cars);
+    unique_ptr<vector<m8r::Note*>> result{mind.findNoteFts("engine", false, cars)};
+    EXPECT_EQ(1, result->size());
+    result.reset(mind.findNoteFts("espresso", false, cars));
+    EXPECT_EQ(0, result->size());
+
+    // remember: index is updated incrementally
+    cars->getNotes()[1]->setName("Winter Tyres");
+    mind.remind().remember(cars->getKey());
+    result.reset(mind.findNoteFts("winter tyre", true));
+    ASSERT_EQ(1, result->size());
+    EXPECT_EQ("Winter Tyres", result->at(0)->getName());
+    result.reset(mind.findNoteFts("Wheels"));
+    EXPECT_EQ(0, result->size());
+    EXPECT_EQ(3+5, mind.remind().getFtsIndex().getDocumentsCount());
+
+    // forget: outline is removed from index
+    mind.outlineForget(cars->getKey());
+    result.reset(mind.findNoteFts("engine"));
+    EXPECT_EQ(0, result->size());
+    EXPECT_EQ(3+5-3, mind.remind().getFtsIndex().getDocumentsCount());
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+class FtsTestPage : public m8r::SearchListener
+{
+public:
+    vector<m8r::Note*> notes;
+
+    virtual void found(m8r::Note* note) override { notes.push_back(note); }
+};
+
+TEST(FtsTestCase, Pages) {
+    string repositoryDir{"/tmp/mf-unit-repository-fts-pages"};
+    map<string,string> pathToContent{};
+    pathToContent[repositoryDir+"/memory/tea.md"] =
+        "# Tea\nGreen tea, black tea and white tea.\n\n"
+        "## Green Tea\nSencha.\n\n"
+        "## Black\nAssam tea.\n\n"
+        "## White\nSilver needle.\n\n"
+        "## Oolong Tea\nTea between green and black tea.\n";
+    pathToContent[repositoryDir+"/memory/teapots.md"] =
+        "# Teapots\nTeapot for tea.\n\n"
+        "## Kyusu\nJapanese teapot.\n\n"
+        "## Gaiwan\nChinese lidded bowl.\n";
+    m8r::createEmptyRepository(repositoryDir, pathToContent);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftstc-p.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    ASSERT_EQ(2, mind.remind().getOutlinesCount());
+
+    // best ranked first: name occurrences have higher weight
+    m8r::FtsCursor cursor{};
+    FtsTestPage page{};
+    EXPECT_EQ(6, mind.findNoteFts("tea", true, nullptr, 1, cursor, &page));
+    ASSERT_EQ(1, page.notes.size());
+    EXPECT_EQ("Tea", page.notes[0]->getName());
+    page.notes.clear();
+    EXPECT_EQ(5, mind.findNoteFts("tea", true, nullptr, 2, cursor, &page));
+    ASSERT_EQ(2, page.notes.size());
+    // tie is ranked by the order of outlines in memory
+    set<string> names{page.notes[0]->getName(), page.notes[1]->getName()};
+    EXPECT_EQ((set<string>{"Oolong Tea", "Teapots"}), names);
+
+    // pages of any size give all results of unranked FTS ranked by score
+    for(bool ignoreCase:{false, true}) {
+        for(size_t limit:{1, 2, 3, 100}) {
+            for(const char* query:{"tea", "Tea", "e", "o", "nothing"}) {
+                unique_ptr<vector<m8r::Note*>> all{mind.findNoteFts(query, ignoreCase)};
+                cursor.reset();
+                page.notes.clear();
+                size_t hits = mind.findNoteFts(query, ignoreCase, nullptr, limit, cursor, &page);
+                EXPECT_EQ(all->size(), hits);
+                while(hits > limit) {
+                    size_t size = page.notes.size();
+                    size_t next = mind.findNoteFts(query, ignoreCase, nullptr, limit, cursor, &page);
+                    EXPECT_EQ(hits-limit, next);
+                    EXPECT_EQ(size+std::min(limit, next), page.notes.size());
+                    hits = next;
+                }
+
+                ASSERT_EQ(all->size(), page.notes.size()) << query;
+                string q{query};
+                if(ignoreCase) {
+                    m8r::stringToLower(query, q);
+                }
+                for(size_t i=1; i<page.notes.size(); i++) {
+                    EXPECT_GE(
+                        m8r::Mind::scoreNoteFts(q, ignoreCase, page.notes[i-1]->getName(), page.notes[i-1]->getDescription()),
+                        m8r::Mind::scoreNoteFts(q, ignoreCase, page.notes[i]->getName(), page.notes[i]->getDescription()));
+                }
+                sort(all->begin(), all->end());
+                sort(page.notes.begin(), page.notes.end());
+                EXPECT_EQ(*all, page.notes) << query;
+            }
+        }
+    }
+
+    // outline scope
+    m8r::Outline* teapots = mind.remind().getOutline(repositoryDir+"/memory/teapots.md");
+    ASSERT_NE(nullptr, teapots);
+    cursor.reset();
+    page.notes.clear();
+    EXPECT_EQ(2, mind.findNoteFts("teapot", true, teapots, 10, cursor, &page));
+    EXPECT_EQ(2, page.notes.size());
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+// reference scan using std::regex on name and description lines
+bool regexpMatches(const string& name, const vector<string*>& description, const regex& r)
+{
+    if(regex_search(name, r)) {
+        return true;
+    }
+    for(const string* d:description) {
+        if(d && regex_search(*d, r)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST(FtsTestCase, Regexp) {
+    string repositoryDir{"/tmp/mf-unit-repository-fts-regexp"};
+    map<string,string> pathToContent{};
+    pathToContent[repositoryDir+"/memory/cars.md"] =
+        "# Cars\nFast cars and slow trucks.\n\n"
+        "## Engine\nV8 engine-block made of aluminium.\nSee https://example.com/v8?engine_id=V8_1 for details.\n\n"
+        "## Wheels\nTyre pressure: 2.2 bar.\nRim size 17\".\n";
+    pathToContent[repositoryDir+"/memory/coffee.md"] =
+        "# Coffee\nBlack coffee w/o sugar.\n\n"
+        "## Espresso\nStrong espresso, double shot.\n\n"
+        "## Version 2.10\nReleased on 2018-03-24.\n";
+    m8r::createEmptyRepository(repositoryDir, pathToContent);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftstc-r.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    ASSERT_EQ(2, mind.remind().getOutlinesCount());
+
+    // index narrowed results MUST be the same as the results of linear scan
+    vector<string> queries{
+        "engine", "^engine", "Engine$", "v\\d+", "V\\d_\\d", "\\d+\\.\\d+ bar", "\\d{4}-\\d{2}-\\d{2}",
+        "https?://[a-z.]+/", "(cars|trucks)\\.$", "^[A-Z][a-z]+$", "espresso.*shot", "w/o (sugar|milk)",
+        "s[io]", "^$", "nothing|nowhere", "2\\.1"
+    };
+    for(const string& query:queries) {
+        for(bool ignoreCase:{false, true}) {
+            regex r{query, ignoreCase?regex::ECMAScript|regex::icase:regex::ECMAScript};
+            vector<m8r::Note*> expected{};
+            for(m8r::Outline* o:mind.remind().getOutlines()) {
+                if(regexpMatches(o->getName(), o->getDescription(), r)) {
+                    expected.push_back(o->getOutlineDescriptorAsNote());
+                }
+                for(m8r::Note* n:o->getNotes()) {
+                    if(regexpMatches(n->getName(), n->getDescription(), r)) {
+                        expected.push_back(n);
+                    }
+                }
+            }
+            unique_ptr<vector<m8r::Note*>> result{mind.findNoteRegexp(query, ignoreCase)};
+            EXPECT_EQ(expected, *result) << "Regexp: '" << query << "' ignore case: " << ignoreCase;
+        }
+    }
+
+    // invalid expression
+    EXPECT_EQ(-1, mind.findNoteRegexp("(engine", false, nullptr, nullptr));
+
+    // outline scope
+    m8r::Outline* cars = mind.remind().getOutline(repositoryDir+"/memory/cars.md");
+    ASSERT_NE(nullptr, cars);
+    unique_ptr<vector<m8r::Note*>> result{mind.findNoteRegexp("engine|espresso", false, cars)};
+    EXPECT_EQ(1, result->size());
+
+    // find outline by name
+    unique_ptr<vector<m8r::Outline*>> outlines = mind.findOutlineByNameRegexp("^c", true);
+    ASSERT_NE(nullptr, outlines.get());
+    EXPECT_EQ(2, outlines->size());
+    outlines = mind.findOutlineByNameRegexp("fee$");
+    ASSERT_EQ(1, outlines->size());
+    EXPECT_EQ("Coffee", outlines->at(0)->getName());
+    EXPECT_EQ(nullptr, mind.findOutlineByNameRegexp("[c").get());
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Substring FTS w/ index vs. linear scan on 100.000 notes w/ identifiers and URLs.
+ */
+TEST(FtsTestCase, DISABLED_IndexVsScan) {
+    const int OUTLINES = 1000;
+    const int NOTES = 100;
+    string repositoryDir{"/tmp/mf-benchmark-repository-fts"};
+    map<string,string> pathToContent{};
+    for(int o=0; o<OUTLINES; o++) {
+        string content{"# Outline "};
+        content += std::to_string(o);
+        content += "\nOutline w/ identifiers and links.\n\n";
+        for(int n=0; n<NOTES; n++) {
+            string id{std::to_string(o*NOTES+n)};
+            content += "## Note ";
+            content += id;
+            content += "\nLorem ipsum dolor sit amet, consectetur adipiscing elit: noteId_";
+            content += id;
+            content += " see https://www.mindforger.com/notes/";
+            content += id;
+            content += "?format=html for details.\n\n";
+        }
+        pathToContent[repositoryDir+"/memory/o"+std::to_string(o)+".md"] = content;
+    }
+    m8r::createEmptyRepository(repositoryDir, pathToContent);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftstc-ivs.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.remind().setSnapshot(false);
+    mind.learn();
+    cout << endl << "FTS index: " << mind.remind().getNotesCount() << " Ns / "
+         << mind.remind().getFtsIndex().getTrigramsCount() << " trigrams" << endl;
+
+    vector<string> queries{"noteId_4242", "notes/99999?", "eId_1234", "NOTEID_7", "format=html", "ipsum"};
+    for(const string& query:queries) {
+        for(bool ignoreCase:{false, true}) {
+            auto begin = chrono::high_resolution_clock::now();
+            unique_ptr<vector<m8r::Note*>> result{mind.findNoteFts(query, ignoreCase)};
+            auto end = chrono::high_resolution_clock::now();
+
+            vector<m8r::Note*> expected{};
+            auto scanBegin = chrono::high_resolution_clock::now();
+            ftsScan(mind.remind(), query, ignoreCase, expected);
+            auto scanEnd = chrono::high_resolution_clock::now();
+
+            cout << "'" << query << "'" << (ignoreCase?" (ignore case)":"") << ": " << result->size() << " N(s) found in "
+                 << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms w/ index vs. "
+                 << chrono::duration_cast<chrono::microseconds>(scanEnd-scanBegin).count()/1000.0 << "ms scan" << endl;
+            ASSERT_EQ(expected, *result);
+        }
+    }
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
@@ -16,10 +16,141 @@
  You should have received a copy of the GNU General Public License
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
-#include "memory.h"
+#include <string>
+#include <map>
+#include <memory>
+
+#include <sys/stat.h>
+#include <utime.h>
 
 #include <gtest/gtest.h>
 
+#include "../../../src/gear/file_utils.h"
+#include "../../../src/mind/memory.h"
+#include "../../../src/persistence/memory_snapshot.h"
+#include "../../../src/install/installer.h"
+
+using namespace std;
+
 namespace m8r {
 
+void memoryToMarkdowns(Memory& memory, map<string,string>& markdowns)
+{
+    MarkdownOutlineRepresentation representation{memory.getOntology()};
+    markdowns.clear();
+    for(Outline* o:memory.getOutlines()) {
+        unique_ptr<string> md{representation.to(o)};
+        markdowns[o->getKey()] = *md + o->getModifiedPretty() + to_string(o->getBytesize());
+    }
+}
+
+TEST(MemoryTestCase, Snapshot) {
+    string repositoryDir{"/tmp/mf-unit-repository-snapshot"};
+    removeDirectoryRecursively(repositoryDir.c_str());
+    Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string metaFile{repositoryDir+"/memory/meta.md"};
+    stringToFile(metaFile,
+        "Preamble line.\n"
+        "\n"
+        "# Meta Outline <!-- Metadata: type: Grow; created: 2017-02-03 10:20:30; reads: 7; read: 2018-01-01 08:00:00; revision: 3; modified: 2017-12-24 18:00:00; importance: 3/5; urgency: 2/5; progress: 40%; tags: important,cool,Physics; links: [MindForger](http://www.mindforger.com); -->\n"
+        "Outline description.\n"
+        "\n"
+        "## Note 1 <!-- Metadata: type: Action; created: 2017-02-03 10:20:30; reads: 2; read: 2017-03-01 11:00:00; revision: 1; modified: 2017-03-01 11:00:00; tags: todo; deadline: 2018-06-30 10:00:00; progress: 20%; -->\n"
+        "Note 1 text.\n"
+        "\n"
+        "### Note 2\n"
+        "Note 2 text.\n");
+    string plainFile{repositoryDir+"/memory/plain.md"};
+    stringToFile(plainFile, "# Plain Outline\n\nText.\n\n## Plain Note\nPlain note text.");
+    // virgin O is skipped
+    stringToFile(repositoryDir+"/memory/virgin.md", "");
+
+    Configuration& config = Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-s.md");
+    config.setActiveRepository(config.addRepository(RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    remove(config.getMemorySnapshotPath().c_str());
+
+    // parse > snapshot is written
+    map<string,string> parsed{};
+    string metaKey{}, plainKey{};
+    unsigned long physicsColor{};
+    {
+        Memory memory{config};
+        memory.learn();
+        ASSERT_EQ(2, memory.getOutlinesCount());
+        ASSERT_EQ(3, memory.getNotesCount());
+        memoryToMarkdowns(memory, parsed);
+        for(Outline* o:memory.getOutlines()) {
+            (o->getName()=="Meta Outline"?metaKey:plainKey) = o->getKey();
+        }
+        physicsColor = memory.getOntology().findOrCreateTag("physics")->getColor().asLong();
+    }
+    ASSERT_TRUE(isFile(config.getMemorySnapshotPath().c_str()));
+
+    // snapshot entries are valid for unchanged files
+    {
+        Ontology ontology{};
+        MemorySnapshot snapshot{ontology};
+        snapshot.open(config.getMemorySnapshotPath());
+        EXPECT_EQ(2, snapshot.size());
+        MemorySnapshot::Fingerprint fingerprint{};
+        ASSERT_TRUE(MemorySnapshot::fingerprint(metaKey, fingerprint));
+        unique_ptr<Outline> o{snapshot.outline(metaKey, fingerprint)};
+        ASSERT_NE(nullptr, o.get());
+        EXPECT_EQ("Meta Outline", o->getName());
+        EXPECT_EQ(2, o->getNotesCount());
+        EXPECT_EQ(3, o->getTags()->size());
+        EXPECT_EQ(1, o->getLinksCount());
+        EXPECT_EQ(2, o->getPreamble().size());
+        fingerprint.hash++;
+        EXPECT_EQ(nullptr, snapshot.outline(metaKey, fingerprint));
+    }
+
+    // load from snapshot > same outlines as parsed and snapshot is not rewritten (virgin O is not a change)
+    struct utimbuf snapshotTime{1000, 1000};
+    ASSERT_EQ(0, utime(config.getMemorySnapshotPath().c_str(), &snapshotTime));
+    map<string,string> loaded{};
+    {
+        Memory memory{config};
+        memory.learn();
+        EXPECT_EQ(2, memory.getOutlinesCount());
+        memoryToMarkdowns(memory, loaded);
+        // tag restored from snapshot has the same color as parsed tag (written in different case)
+        for(const Tag* t:*memory.getOutline(metaKey)->getTags()) {
+            if(t->getName() == "physics") {
+                EXPECT_EQ(physicsColor, t->getColor().asLong());
+            }
+        }
+    }
+    EXPECT_EQ(parsed, loaded);
+    struct stat snapshotStat;
+    ASSERT_EQ(0, stat(config.getMemorySnapshotPath().c_str(), &snapshotStat));
+    EXPECT_EQ(1000, snapshotStat.st_mtime);
+
+    // changed file is parsed again
+    stringToFile(plainFile, "# Changed Outline\n\nText.\n\n## Plain Note\nPlain note text.\n\n## Another Note\nText.\n");
+    {
+        Memory memory{config};
+        memory.learn();
+        ASSERT_EQ(2, memory.getOutlinesCount());
+        EXPECT_EQ(4, memory.getNotesCount());
+        EXPECT_EQ("Changed Outline", memory.getOutline(plainKey)->getName());
+    }
+
+    // corrupted snapshot is ignored
+    string snapshotContent{*unique_ptr<string>(fileToString(config.getMemorySnapshotPath()))};
+    snapshotContent[snapshotContent.size()/2] ^= 0x5A;
+    snapshotContent.resize(snapshotContent.size()-3);
+    stringToFile(config.getMemorySnapshotPath(), snapshotContent);
+    {
+        Memory memory{config};
+        memory.learn();
+        ASSERT_EQ(2, memory.getOutlinesCount());
+        EXPECT_EQ(4, memory.getNotesCount());
+        EXPECT_EQ("Meta Outline", memory.getOutline(metaKey)->getName());
+    }
+}
+
 } /* namespace */
@@ -293,10 +293,100 @@ TEST(MindTestCase, LearnAmnesiaLearn) {
     EXPECT_EQ(16, memory.getOntology().getTags().size()); // tags are kept as it's not a problem - they are used as suggestion on new/edit of Os and Ns
 }
 
+#ifdef __linux__
+class CountingMindListener : public m8r::MindListener
+{
+public:
+    vector<string> forgotten;
+    vector<string> remembered;
+
+    virtual void forget(m8r::Outline* outline) { forgotten.push_back(outline->getName()); }
+    virtual void forget(m8r::Note* note) { UNUSED_ARG(note); }
+    virtual void remember(m8r::Outline* outline) { remembered.push_back(outline->getName()); }
+};
+
+int learnRepositoryChanges(m8r::Mind& mind)
+{
+    // inotify events are delivered asynchronously
+    int learned = 0;
+    for(int i=0; i<100 && !learned; i++) {
+        learned = mind.learnRepositoryChanges();
+        if(!learned) this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    return learned;
+}
+
+TEST(MindTestCase, LearnRepositoryChanges) {
+    string repositoryPath{"/tmp/mf-unit-repository-changes"};
+    m8r::removeDirectoryRecursively(repositoryPath.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryPath);
+    m8r::stringToFile(repositoryPath+"/memory/first.md", "# First Outline\nText.\n\n## Note 1\nText.\n");
+    m8r::stringToFile(repositoryPath+"/memory/second.md", "# Second Outline\nText.\n\n## Note 2\nText.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lrc.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    m8r::Mind mind{config};
+    m8r::Memory& memory = mind.remind();
+    CountingMindListener listener{};
+    mind.addListener(&listener);
+    mind.learn();
+    mind.think().get();
+    ASSERT_TRUE(mind.watch());
+    ASSERT_EQ(2, memory.getOutlinesCount());
+    EXPECT_EQ(0, mind.learnRepositoryChanges());
+
+    // external edits
+    m8r::Outline* first = memory.getOutline(repositoryPath+"/memory/first.md");
+    ASSERT_NE(nullptr, first);
+    m8r::stringToFile(repositoryPath+"/memory/first.md", "# First Modified\nText.\n\n## Note 1\nText.\n\n## Note 11\nText.\n");
+    remove(string{repositoryPath+"/memory/second.md"}.c_str());
+    m8r::stringToFile(repositoryPath+"/memory/third.md", "# Third Outline\nText.\n");
+
+    EXPECT_EQ(3, learnRepositoryChanges(mind));
+    ASSERT_EQ(2, memory.getOutlinesCount());
+    EXPECT_EQ(2, memory.getNotesCount());
+    // modified O swapped in place, forgotten O was deleted once listeners were notified
+    EXPECT_EQ("First Modified", memory.getOutlines()[0]->getName());
+    EXPECT_NE(first, memory.getOutlines()[0]);
+    EXPECT_EQ("First Outline", listener.forgotten[0]);
+    EXPECT_EQ(nullptr, memory.getOutline(repositoryPath+"/memory/second.md"));
+    EXPECT_NE(nullptr, memory.getOutline(repositoryPath+"/memory/third.md"));
+    EXPECT_EQ(2, listener.forgotten.size());
+    EXPECT_EQ(2, listener.remembered.size());
+
+    // own write is not learned again
+    memory.remember(repositoryPath+"/memory/third.md");
+    this_thread::sleep_for(chrono::milliseconds(50));
+    EXPECT_EQ(0, mind.learnRepositoryChanges());
+
+    // watching survives learn
+    mind.learn();
+    EXPECT_TRUE(memory.getRepositoryIndexer().isWatching());
+    mind.removeListener(&listener);
+}
+#endif
+
 TEST(MindTestCase, CommonWordsBlacklist) {
     m8r::CommonWordsBlacklist blacklist{};
 
     ASSERT_TRUE(blacklist.findWord("I"));
     ASSERT_TRUE(blacklist.findWord("you"));
     ASSERT_TRUE(blacklist.findWord("the"));
+    for(const char* w:m8r::CommonWordsBlacklist::CommonWords::words) {
+        ASSERT_TRUE(blacklist.findWord(w)) << w;
+    }
+    ASSERT_FALSE(blacklist.findWord(""));
+    ASSERT_FALSE(blacklist.findWord("i"));
+    ASSERT_FALSE(blacklist.findWord("th"));
+    ASSERT_FALSE(blacklist.findWord("thee"));
+    ASSERT_FALSE(blacklist.findWord("mindforger"));
+
+    // words added at runtime
+    blacklist.addWord("mindforger");
+    ASSERT_TRUE(blacklist.findWord("mindforger"));
+    ASSERT_TRUE(blacklist.findWord("the"));
+    ASSERT_FALSE(blacklist.findWord("mind"));
 }
@@ -51,7 +51,10 @@ QMAKE_CXXFLAGS += -std=c++0x -pedantic -g -pg
 
 SOURCES += \
     ./gear/datetime_test.cpp \
+    ./gear/regexp_test.cpp \
     ./gear/string_utils_test.cpp \
+    ./gear/perfect_hash_test.cpp \
+    ./gear/task_executor_test.cpp \
     ./indexer/repository_indexer_test.cpp \
     ./markdown/markdown_test.cpp \
     ./mind/fts_test.cpp \
@@ -68,6 +71,8 @@ SOURCES += \
     ./ai/nlp_test.cpp \
     ../benchmark/trie_benchmark.cpp \
     ../benchmark/ai_benchmark.cpp \
+    ../benchmark/memory_benchmark.cpp \
+    ../benchmark/string_benchmark.cpp \
     gear/file_utils_test.cpp \
     gear/trie_test.cpp
 